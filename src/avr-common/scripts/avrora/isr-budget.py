@@ -0,0 +1,127 @@
+#!/usr/bin/env python3
+
+#
+# @author Raoul Rubien 2016
+#
+# Evaluates the avrora "calls" monitor log of a simulation (-monitors=calls -show-interrupts=true
+# -report-seconds=false): per ISR min/avg/max cycles from interrupt entry to RETI and the main loop
+# iteration time as cycles between consecutive process() calls of a node.
+#
+# Budgets, derived from half a manchester clock in CPU cycles (timer/counter 1 runs unscaled):
+#  - all reception ISRs plus the TX timer and local time ISR may fall into one half clock: the sum of
+#    their worst cases must not exceed the given ratio of it,
+#  - the decoder runs once per main loop iteration: an iteration must not take longer than filling
+#    the snapshot buffer takes at one edge per half clock.
+#
+# usage: isr-budget.py <-mmcu=...> <half clock cycles> <number of snapshots> <isr budget ratio> < log
+# exits with 1 if a budget is exceeded
+#
+
+import re
+import sys
+
+# ISR name -> vector number per MCU (see uc-core/configuration/interrupts/Vectors.h)
+VECTORS = {
+    "atmega16": {
+        "NORTH_PIN_CHANGE_INTERRUPT_VECT": 18,
+        "EAST_PIN_CHANGE_INTERRUPT_VECT": 2,
+        "SOUTH_PIN_CHANGE_INTERRUPT_VECT": 1,
+        "TX_TIMER_INTERRUPT_VECT": 6,
+        "LOCAL_TIME_INTERRUPT_VECT": 7,
+    },
+    "attiny1634": {
+        "NORTH_PIN_CHANGE_INTERRUPT_VECT": 4,
+        "EAST_PIN_CHANGE_INTERRUPT_VECT": 3,
+        "SOUTH_PIN_CHANGE_INTERRUPT_VECT": 2,
+        "TX_TIMER_INTERRUPT_VECT": 7,
+        "LOCAL_TIME_INTERRUPT_VECT": 8,
+    },
+}
+
+# "<node> <cycles> ..." prefix of each monitor line
+LINE = re.compile(r"^\s*(\d+)\s+(\d+)\s")
+INTERRUPT = re.compile(r"--\(INT #\d+\)->\s*__vector_(\d+)")
+RETI = re.compile(r"\(RETI\)")
+PROCESS_CALL = re.compile(r"--\(CALL\)->\s*process\b")
+
+
+class Statistics:
+    def __init__(self):
+        self.count = 0
+        self.sum = 0
+        self.min = None
+        self.max = 0
+
+    def add(self, value):
+        self.count += 1
+        self.sum += value
+        self.min = value if self.min is None else min(self.min, value)
+        self.max = max(self.max, value)
+
+    def __str__(self):
+        if self.count == 0:
+            return "not observed"
+        return "%8u calls, min %6u, avg %8.1f, max %6u cycles" % (self.count, self.min, self.sum / self.count,
+                                                                   self.max)
+
+
+def main():
+    if len(sys.argv) != 5:
+        sys.stderr.write("usage: %s <-mmcu=...> <half clock cycles> <number of snapshots> <isr budget ratio>\n"
+                         % sys.argv[0])
+        return 2
+    mcu = sys.argv[1].replace("-mmcu=", "")
+    half_clock = int(sys.argv[2])
+    number_snapshots = int(sys.argv[3])
+    isr_ratio = float(sys.argv[4])
+    if mcu not in VECTORS:
+        sys.stderr.write("unsupported mcu %s\n" % mcu)
+        return 2
+
+    names = {vector: name for name, vector in VECTORS[mcu].items()}
+    isrs = {name: Statistics() for name in VECTORS[mcu]}
+    loop = Statistics()
+    open_interrupts = {}
+    last_process = {}
+
+    for line in sys.stdin:
+        prefix = LINE.match(line)
+        if not prefix:
+            continue
+        node, cycles = int(prefix.group(1)), int(prefix.group(2))
+        interrupt = INTERRUPT.search(line)
+        if interrupt:
+            open_interrupts.setdefault(node, []).append((int(interrupt.group(1)), cycles))
+        elif RETI.search(line) and open_interrupts.get(node):
+            vector, entered = open_interrupts[node].pop()
+            if vector in names:
+                isrs[names[vector]].add(cycles - entered)
+        elif PROCESS_CALL.search(line):
+            if node in last_process:
+                loop.add(cycles - last_process[node])
+            last_process[node] = cycles
+
+    isr_budget = int(half_clock * isr_ratio)
+    loop_budget = half_clock * number_snapshots
+    worst_case = sum(statistics.max for statistics in isrs.values())
+
+    for name in sorted(isrs):
+        print("%-34s %s" % (name, isrs[name]))
+    print("%-34s %s" % ("process() iteration", loop))
+    print("ISRs worst case sum %u cycles, budget %u cycles (%.2f x half clock of %u cycles)"
+          % (worst_case, isr_budget, isr_ratio, half_clock))
+    print("process() worst case %u cycles, budget %u cycles (%u snapshots x half clock)"
+          % (loop.max, loop_budget, number_snapshots))
+
+    is_exceeded = False
+    if worst_case > isr_budget:
+        print("FAILED: ISR cycle budget exceeded")
+        is_exceeded = True
+    if loop.max > loop_budget:
+        print("FAILED: process() iteration budget exceeded")
+        is_exceeded = True
+    return 1 if is_exceeded else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
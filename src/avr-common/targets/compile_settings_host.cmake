@@ -0,0 +1,25 @@
+# @author Raoul Rubien 2016
+#
+# Compile settings for building uc-core natively on the build host (see avr-common/utils/host).
+# The host compiler is kept, the AVR headers are replaced by the virtual MCU shim.
+
+SET(CMAKE_VERBOSE_MAKEFILE True)
+
+SET(CSTANDARD "-std=gnu99")
+
+SET(CWARN "-Wall -Werror -Wunused-variable -Wunused-function -Wunused-label -Wunused-value -Wextra -Wshadow -Wstrict-prototypes -Waddress -Wredundant-decls")
+
+# Same struct layout as on the MCU. Host code linked against it must not rely on libc structs with padding.
+SET(CTUNING " -fpack-struct -funsigned-bitfields -funsigned-char ${CTUNING}")
+# uc-core accesses the (volatile) port buffers through package structs and uint16_t pointers.
+SET(CTUNING " -fno-strict-aliasing ${CTUNING}")
+
+# The shim mimics the simulation MCU.
+SET(DEFINED_MACROS "-D__AVR_ATmega16__ ${DEFINED_MACROS}")
+
+SET(COPT "${COPT}")
+SET(CDEBUG "${CDEBUG}")
+
+SET(CFLAGS "${CDEBUG} ${CDEFS} ${CINCS} ${COPT} ${CWARN} ${CSTANDARD} ${CTUNING} ${DEFINED_MACROS}")
+
+SET(CMAKE_C_FLAGS ${CFLAGS})
@@ -0,0 +1,48 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host replacement of <avr/interrupt.h>: interrupt service routines become plain
+ * functions which are invoked by the virtual MCU (see host/mcu/VirtualMcu.h).
+ */
+
+#pragma once
+
+#include "avr/io.h"
+
+#define _VECTOR(N) __vector_ ## N
+
+/**
+ * ATmega16 interrupt vectors
+ */
+#define INT0_vect _VECTOR(1)
+#define INT1_vect _VECTOR(2)
+#define TIMER2_COMP_vect _VECTOR(3)
+#define TIMER2_OVF_vect _VECTOR(4)
+#define TIMER1_CAPT_vect _VECTOR(5)
+#define TIMER1_COMPA_vect _VECTOR(6)
+#define TIMER1_COMPB_vect _VECTOR(7)
+#define TIMER1_OVF_vect _VECTOR(8)
+#define TIMER0_OVF_vect _VECTOR(9)
+#define INT2_vect _VECTOR(18)
+#define TIMER0_COMP_vect _VECTOR(19)
+#define BADISR_vect __vector_default
+
+/**
+ * Interrupt service routines the virtual MCU may dispatch. Declared weak to allow
+ * host programs that do not link the uc-core interrupt implementation.
+ */
+void INT0_vect(void) __attribute__((weak));
+void INT1_vect(void) __attribute__((weak));
+void INT2_vect(void) __attribute__((weak));
+void TIMER1_COMPA_vect(void) __attribute__((weak));
+void TIMER1_COMPB_vect(void) __attribute__((weak));
+void TIMER0_COMP_vect(void) __attribute__((weak));
+
+#define ISR(vector, ...) \
+    void vector(void)
+
+#define EMPTY_INTERRUPT(vector) \
+    void vector(void) {}
+
+#define sei() (SREG |= _BV(SREG_I))
+#define cli() (SREG &= ~_BV(SREG_I))
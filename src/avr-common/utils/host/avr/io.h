@@ -0,0 +1,137 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host replacement of <avr/io.h>: maps the ATmega16 register names, as used by uc-core,
+ * to the register file of the currently selected virtual MCU.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "mcu/VirtualMcuGlobals.h"
+
+#ifndef __AVR_ATmega16__
+#  error the host shim mimics the ATmega16 only: compile with -D__AVR_ATmega16__
+#endif
+
+#define _BV(bit) (1 << (bit))
+
+#define __VIRTUAL_REGISTER(name) (CurrentVirtualMcu->registers.name)
+
+/**
+ * status register
+ */
+#define SREG __VIRTUAL_REGISTER(sreg)
+#define SREG_I 7
+
+/**
+ * external interrupts
+ */
+#define GICR __VIRTUAL_REGISTER(gicr)
+#define INT1 7
+#define INT0 6
+#define INT2 5
+
+#define GIFR __VIRTUAL_REGISTER(gifr)
+#define INTF1 7
+#define INTF0 6
+#define INTF2 5
+
+#define MCUCR __VIRTUAL_REGISTER(mcucr)
+#define SE 6
+#define ISC11 3
+#define ISC10 2
+#define ISC01 1
+#define ISC00 0
+
+#define MCUCSR __VIRTUAL_REGISTER(mcucsr)
+#define ISC2 6
+
+/**
+ * timer/counter 0
+ */
+#define TCCR0 __VIRTUAL_REGISTER(tccr0)
+#define FOC0 7
+#define WGM00 6
+#define COM01 5
+#define COM00 4
+#define WGM01 3
+#define CS02 2
+#define CS01 1
+#define CS00 0
+
+#define TCNT0 __VIRTUAL_REGISTER(tcnt0)
+#define OCR0 __VIRTUAL_REGISTER(ocr0)
+
+/**
+ * timer/counter 1
+ */
+#define TCCR1A __VIRTUAL_REGISTER(tccr1a)
+#define COM1A1 7
+#define COM1A0 6
+#define COM1B1 5
+#define COM1B0 4
+#define FOC1A 3
+#define FOC1B 2
+#define WGM11 1
+#define WGM10 0
+
+#define TCCR1B __VIRTUAL_REGISTER(tccr1b)
+#define ICNC1 7
+#define ICES1 6
+#define WGM13 4
+#define WGM12 3
+#define CS12 2
+#define CS11 1
+#define CS10 0
+
+#define TCNT1 __VIRTUAL_REGISTER(tcnt1)
+#define OCR1A __VIRTUAL_REGISTER(ocr1a)
+#define OCR1B __VIRTUAL_REGISTER(ocr1b)
+
+/**
+ * timer/counter interrupt mask and flag register
+ */
+#define TIMSK __VIRTUAL_REGISTER(timsk)
+#define OCIE2 7
+#define TOIE2 6
+#define TICIE1 5
+#define OCIE1A 4
+#define OCIE1B 3
+#define TOIE1 2
+#define OCIE0 1
+#define TOIE0 0
+
+#define TIFR __VIRTUAL_REGISTER(tifr)
+#define OCF2 7
+#define TOV2 6
+#define ICF1 5
+#define OCF1A 4
+#define OCF1B 3
+#define TOV1 2
+#define OCF0 1
+#define TOV0 0
+
+/**
+ * io ports
+ */
+#define PORTA __VIRTUAL_REGISTER(porta)
+#define PINA __VIRTUAL_REGISTER(pina)
+#define DDRA __VIRTUAL_REGISTER(ddra)
+#define PORTB __VIRTUAL_REGISTER(portb)
+#define PINB __VIRTUAL_REGISTER(pinb)
+#define DDRB __VIRTUAL_REGISTER(ddrb)
+#define PORTC __VIRTUAL_REGISTER(portc)
+#define PINC __VIRTUAL_REGISTER(pinc)
+#define DDRC __VIRTUAL_REGISTER(ddrc)
+#define PORTD __VIRTUAL_REGISTER(portd)
+#define PIND __VIRTUAL_REGISTER(pind)
+#define DDRD __VIRTUAL_REGISTER(ddrd)
+
+/**
+ * uart, eeprom and oscillator registers
+ */
+#define UDR __VIRTUAL_REGISTER(udr)
+#define EEARL __VIRTUAL_REGISTER(eearl)
+#define EEDR __VIRTUAL_REGISTER(eedr)
+#define OSCCAL __VIRTUAL_REGISTER(osccal)
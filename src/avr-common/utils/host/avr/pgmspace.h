@@ -0,0 +1,17 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host replacement of <avr/pgmspace.h>: program memory is ordinary memory.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define PROGMEM
+
+#define PGM_P const char *
+
+#define pgm_read_byte(address) (*(const uint8_t *) (address))
+
+#define pgm_read_word(address) ((uintptr_t) *(const uint16_t *) (address))
@@ -0,0 +1,25 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host replacement of <avr/sleep.h>: sleeping is recorded in the virtual register file
+ * and left to the host program to be resolved.
+ */
+
+#pragma once
+
+#include "avr/io.h"
+
+#define SLEEP_MODE_IDLE 0
+#define SLEEP_MODE_ADC 1
+#define SLEEP_MODE_PWR_DOWN 2
+#define SLEEP_MODE_PWR_SAVE 3
+#define SLEEP_MODE_STANDBY 6
+
+#define set_sleep_mode(mode) ((void) (mode))
+
+#define sleep_enable() (CurrentVirtualMcu->registers.isSleepEnabled = 1)
+
+#define sleep_disable() (CurrentVirtualMcu->registers.isSleepEnabled = 0)
+
+#define sleep_cpu() \
+    (CurrentVirtualMcu->registers.isSleeping = CurrentVirtualMcu->registers.isSleepEnabled)
@@ -0,0 +1,123 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Lattice simulation event queue implementation.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "EventQueueTypes.h"
+
+/**
+ * return value of latticeEventQueuePeekTime() for an empty queue
+ */
+#define LATTICE_EVENT_QUEUE_EMPTY UINT64_MAX
+
+/**
+ * Re-allocates an event array.
+ * @return the re-allocated array
+ */
+static LatticeEvent *__latticeEventsResize(LatticeEvent *const events, const uint32_t capacity) {
+    LatticeEvent *const resized = realloc(events, capacity * sizeof(LatticeEvent));
+    if (resized == NULL) {
+        fprintf(stderr, "lattice events: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    return resized;
+}
+
+/**
+ * @return true if event a is due before event b
+ */
+static inline bool __latticeEventIsBefore(const LatticeEvent *const a, const LatticeEvent *const b) {
+    return (a->time < b->time) || (a->time == b->time && a->sequence < b->sequence);
+}
+
+/**
+ * Inserts an event. The event's sequence number is assigned on insertion.
+ * @param queue the queue to insert to
+ * @param event the event to insert
+ */
+void latticeEventQueuePush(LatticeEventQueue *const queue, LatticeEvent event) {
+    if (queue->size == queue->capacity) {
+        queue->capacity *= 2;
+        queue->events = __latticeEventsResize(queue->events, queue->capacity);
+    }
+    event.sequence = queue->nextSequence++;
+
+    // sift up
+    uint32_t idx = queue->size++;
+    while (idx > 0) {
+        const uint32_t parent = (idx - 1) / 2;
+        if (!__latticeEventIsBefore(&event, &queue->events[parent])) {
+            break;
+        }
+        queue->events[idx] = queue->events[parent];
+        idx = parent;
+    }
+    queue->events[idx] = event;
+}
+
+/**
+ * @return the time of the next due event or LATTICE_EVENT_QUEUE_EMPTY
+ */
+static inline uint64_t latticeEventQueuePeekTime(const LatticeEventQueue *const queue) {
+    return (queue->size == 0) ? LATTICE_EVENT_QUEUE_EMPTY : queue->events[0].time;
+}
+
+/**
+ * Removes the next due event.
+ * @pre the queue is not empty
+ * @param queue the queue to remove from
+ * @param event the removed event is written to
+ */
+void latticeEventQueuePop(LatticeEventQueue *const queue, LatticeEvent *const event) {
+    *event = queue->events[0];
+    const LatticeEvent last = queue->events[--queue->size];
+
+    // sift down
+    uint32_t idx = 0;
+    for (;;) {
+        uint32_t child = 2 * idx + 1;
+        if (child >= queue->size) {
+            break;
+        }
+        if (child + 1 < queue->size && __latticeEventIsBefore(&queue->events[child + 1], &queue->events[child])) {
+            child++;
+        }
+        if (!__latticeEventIsBefore(&queue->events[child], &last)) {
+            break;
+        }
+        queue->events[idx] = queue->events[child];
+        idx = child;
+    }
+    queue->events[idx] = last;
+}
+
+/**
+ * Appends an event.
+ * @param buffer the buffer to append to
+ * @param event the event to append
+ */
+void latticeEventBufferAppend(LatticeEventBuffer *const buffer, const LatticeEvent *const event) {
+    if (buffer->size == buffer->capacity) {
+        buffer->capacity *= 2;
+        buffer->events = __latticeEventsResize(buffer->events, buffer->capacity);
+    }
+    buffer->events[buffer->size++] = *event;
+}
+
+/**
+ * Moves all buffered events to the queue.
+ * @param buffer the buffer to empty
+ * @param queue the queue to insert the events to
+ */
+void latticeEventBufferMoveTo(LatticeEventBuffer *const buffer, LatticeEventQueue *const queue) {
+    for (uint32_t idx = 0; idx < buffer->size; idx++) {
+        latticeEventQueuePush(queue, buffer->events[idx]);
+    }
+    buffer->size = 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Lattice simulation event and event queue types.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Lattice simulation event types.
+ */
+typedef enum LatticeEventType {
+    /**
+     * power on: sets up the io ports and constructs the particle as the main loop does
+     */
+            LATTICE_EVENT_TYPE_POWER_ON = 0,
+    /**
+     * one main loop iteration: calls process()
+     */
+            LATTICE_EVENT_TYPE_PROCESS,
+    /**
+     * a timer/counter compare match interrupt is due
+     */
+            LATTICE_EVENT_TYPE_TIMER,
+    /**
+     * a signal edge arrives at a reception pin
+     */
+            LATTICE_EVENT_TYPE_EDGE
+} LatticeEventType;
+
+/**
+ * A timestamped event addressed to one particle.
+ */
+typedef struct LatticeEvent {
+    /**
+     * global simulation time in CPU cycles
+     */
+    uint64_t time;
+    /**
+     * insertion order: events at equal times are delivered first in first out
+     */
+    uint64_t sequence;
+    uint32_t particleIndex;
+    /**
+     * a LatticeEventType
+     */
+    uint8_t type;
+    /**
+     * the reception port of an edge event (see LatticePortType)
+     */
+    uint8_t port;
+    /**
+     * the reception pin level after an edge event
+     */
+    uint8_t isHigh : 1;
+    uint8_t __pad : 7;
+} LatticeEvent;
+
+/**
+ * Binary min-heap of events ordered by time and sequence.
+ */
+typedef struct LatticeEventQueue {
+    LatticeEvent *events;
+    uint32_t size;
+    uint32_t capacity;
+    uint64_t nextSequence;
+} LatticeEventQueue;
+
+/**
+ * Unordered event sequence, i.e. the events a band of particles hands over to an adjacent band.
+ */
+typedef struct LatticeEventBuffer {
+    LatticeEvent *events;
+    uint32_t size;
+    uint32_t capacity;
+} LatticeEventBuffer;
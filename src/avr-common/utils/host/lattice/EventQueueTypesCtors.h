@@ -0,0 +1,63 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Lattice simulation event queue types constructor implementation.
+ */
+
+#pragma once
+
+#include <stdlib.h>
+#include "EventQueueTypes.h"
+
+/**
+ * initial event queue capacity
+ */
+#define LATTICE_EVENT_QUEUE_INITIAL_CAPACITY ((uint32_t) 1024)
+
+/**
+ * initial event buffer capacity
+ */
+#define LATTICE_EVENT_BUFFER_INITIAL_CAPACITY ((uint32_t) 256)
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructLatticeEventQueue(LatticeEventQueue *const o) {
+    o->capacity = LATTICE_EVENT_QUEUE_INITIAL_CAPACITY;
+    o->events = malloc(o->capacity * sizeof(LatticeEvent));
+    o->size = 0;
+    o->nextSequence = 0;
+}
+
+/**
+ * destructor function
+ * @param o reference to the object to destruct
+ */
+void destructLatticeEventQueue(LatticeEventQueue *const o) {
+    free(o->events);
+    o->events = NULL;
+    o->size = 0;
+    o->capacity = 0;
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructLatticeEventBuffer(LatticeEventBuffer *const o) {
+    o->capacity = LATTICE_EVENT_BUFFER_INITIAL_CAPACITY;
+    o->events = malloc(o->capacity * sizeof(LatticeEvent));
+    o->size = 0;
+}
+
+/**
+ * destructor function
+ * @param o reference to the object to destruct
+ */
+void destructLatticeEventBuffer(LatticeEventBuffer *const o) {
+    free(o->events);
+    o->events = NULL;
+    o->size = 0;
+    o->capacity = 0;
+}
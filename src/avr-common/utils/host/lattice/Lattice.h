@@ -0,0 +1,540 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Discrete event lattice simulation: drives process() and the interrupt service routines of
+ * the uc-core firmware of all particles off event queues ordered by global time.
+ * - The main loop is modelled as a sequence of process() calls. Each call takes
+ *   Lattice.processLoopCycles plus the cycles the firmware requested to busy wait.
+ * - Timer/counter compare matches are scheduled as timer events.
+ * - Transmission pin changes are delivered as edge events to the wired neighbour's reception
+ *   pin after Lattice.wireLatencyCycles.
+ * Each particle runs on its own clock which may deviate from the global time.
+ *
+ * The lattice may be partitioned into row bands simulated by one thread each (see latticePartition()).
+ * Bands interact by edge events over north/south wires only, which arrive not before the wire latency.
+ * Bands are synchronized conservatively: in each time window [t, t + wireLatencyCycles), where t is
+ * the earliest pending event of all bands, the bands deliver their events independently. Edge events
+ * to an adjacent band are handed over after the window.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "uc-core/particle/Particle.h"
+#include "mcu/VirtualMcu.h"
+#include "trace/EdgeTrace.h"
+#include "LatticeTypes.h"
+#include "LatticeTypesCtors.h"
+#include "EventQueue.h"
+
+/**
+ * barrier spins before yielding the CPU to other threads
+ */
+#define __LATTICE_BARRIER_SPINS_BEFORE_YIELD ((uint32_t) 1024)
+
+/**
+ * parts per million
+ */
+#define __LATTICE_PPM ((int64_t) 1000000)
+
+/**
+ * @return the particle's local clock cycles at the given global time
+ */
+static inline uint64_t __latticeLocalCycles(const LatticeParticle *const particle, const uint64_t time) {
+    if (particle->clockDeviationPpm == 0) {
+        return time;
+    }
+    return time * (uint64_t) (__LATTICE_PPM + particle->clockDeviationPpm) / __LATTICE_PPM;
+}
+
+/**
+ * @return the earliest global time the particle's local clock reaches the given cycles
+ */
+static inline uint64_t __latticeGlobalTime(const LatticeParticle *const particle, const uint64_t localCycles) {
+    if (particle->clockDeviationPpm == 0) {
+        return localCycles;
+    }
+    const uint64_t frequency = (uint64_t) (__LATTICE_PPM + particle->clockDeviationPpm);
+    return (localCycles * __LATTICE_PPM + frequency - 1) / frequency;
+}
+
+/**
+ * @return the level the currently selected particle drives to the neighbour's reception pin:
+ * north and south transmission pins drive an inverting MOSFET, the east pin drives the wire directly
+ */
+static bool __latticeWireLevel(const LatticePortType port) {
+    switch (port) {
+        case LATTICE_PORT_TYPE_NORTH:
+            return !NORTH_TX_IS_HI;
+        case LATTICE_PORT_TYPE_EAST:
+            return EAST_TX_IS_HI;
+        default:
+            return !SOUTH_TX_IS_HI;
+    }
+}
+
+/**
+ * @return the external interrupt number of the port's reception pin
+ */
+static uint8_t __latticeReceptionInterruptNumber(const LatticePortType port) {
+    switch (port) {
+        case LATTICE_PORT_TYPE_NORTH:
+            return 2;
+        case LATTICE_PORT_TYPE_EAST:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @return the particle's reception port
+ */
+static RxPort *__latticeRxPort(LatticeParticle *const particle, const LatticePortType port) {
+    switch (port) {
+        case LATTICE_PORT_TYPE_NORTH:
+            return &particle->particle.communication.ports.rx.north;
+        case LATTICE_PORT_TYPE_EAST:
+            return &particle->particle.communication.ports.rx.east;
+        default:
+            return &particle->particle.communication.ports.rx.south;
+    }
+}
+
+/**
+ * Appends the edges captured since the last call to the particle's edge traces.
+ */
+static void __latticeTraceEdges(LatticeParticle *const particle) {
+    for (uint8_t port = 0; port < LATTICE_PORT_TYPE_NUMBER_PORTS; port++) {
+        if (particle->edgeTraces[port] == NULL) {
+            continue;
+        }
+        const RxPort *const rxPort = __latticeRxPort(particle, port);
+        uint8_t idx = particle->tracedSnapshotEndIndices[port];
+        while (idx != rxPort->snapshotsBuffer.endIndex) {
+            const volatile Snapshot *const snapshot =
+                    &rxPort->snapshotsBuffer.snapshots[idx & MANCHESTER_DECODING_RX_SNAPSHOTS_INDEX_MASK];
+            edgeTraceWrite(particle->edgeTraces[port], __getTimerValue(snapshot), snapshot->isRisingEdge,
+                           rxPort->snapshotsBuffer.lastSnapshotsLocalTimeInterruptCompareValue[0]);
+            idx++;
+        }
+        particle->tracedSnapshotEndIndices[port] = idx;
+    }
+}
+
+/**
+ * Schedules the next main loop iteration of the particle.
+ */
+static void __latticeScheduleProcess(Lattice *const lattice, const uint32_t particleIndex, const uint64_t time) {
+    LatticeEvent event;
+    event.time = time;
+    event.particleIndex = particleIndex;
+    event.type = LATTICE_EVENT_TYPE_PROCESS;
+    event.port = 0;
+    event.isHigh = false;
+    lattice->particles[particleIndex].isProcessScheduled = true;
+    latticeEventQueuePush(&lattice->bands[lattice->particles[particleIndex].band].queue, event);
+}
+
+/**
+ * Queues an edge event: directly if the receiving particle belongs to the sending band,
+ * otherwise in the outbox to the adjacent band.
+ */
+static void __latticePushEdge(Lattice *const lattice, const uint16_t band, const LatticeEvent *const event) {
+    const uint16_t receivingBand = lattice->particles[event->particleIndex].band;
+    if (receivingBand == band) {
+        latticeEventQueuePush(&lattice->bands[band].queue, *event);
+    } else if (receivingBand < band) {
+        latticeEventBufferAppend(&lattice->bands[band].outboxes[LATTICE_BAND_NEIGHBOUR_TYPE_NORTH], event);
+    } else {
+        latticeEventBufferAppend(&lattice->bands[band].outboxes[LATTICE_BAND_NEIGHBOUR_TYPE_SOUTH], event);
+    }
+}
+
+/**
+ * Selects the particle's firmware state and MCU in the calling thread and advances its
+ * timer/counters to the given global time.
+ */
+static void __latticeEnterParticle(LatticeParticle *const particle, const uint64_t time) {
+    CurrentParticle = &particle->particle;
+    virtualMcuSelect(&particle->mcu);
+    uint64_t cycles = __latticeLocalCycles(particle, time) - particle->mcu.cyclesPassed;
+    while (cycles > UINT32_MAX) {
+        virtualMcuAdvanceCycles(UINT32_MAX);
+        cycles -= UINT32_MAX;
+    }
+    virtualMcuAdvanceCycles((uint32_t) cycles);
+}
+
+/**
+ * Propagates transmission pin changes of the selected particle to its neighbours,
+ * re-schedules its next timer event and keeps track of actuation command executions.
+ */
+static void __latticeLeaveParticle(Lattice *const lattice, const uint32_t particleIndex, const uint64_t time) {
+    LatticeParticle *const particle = &lattice->particles[particleIndex];
+    virtualMcuSyncOutputPins();
+
+    for (uint8_t port = 0; port < LATTICE_PORT_TYPE_NUMBER_PORTS; port++) {
+        const bool level = __latticeWireLevel(port);
+        if (level == particle->wireLevels[port]) {
+            continue;
+        }
+        particle->wireLevels[port] = level;
+        if (particle->neighbours[port] != LATTICE_NO_NEIGHBOUR) {
+            LatticeEvent event;
+            event.time = time + lattice->wireLatencyCycles;
+            event.particleIndex = particle->neighbours[port];
+            event.type = LATTICE_EVENT_TYPE_EDGE;
+            event.port = particle->neighbourPorts[port];
+            event.isHigh = level;
+            __latticePushEdge(lattice, particle->band, &event);
+        }
+    }
+
+    const uint32_t untilInterrupt = virtualMcuCyclesUntilTimerInterrupt();
+    if (untilInterrupt == VIRTUAL_MCU_NO_INTERRUPT) {
+        particle->timerEventTime = LATTICE_NO_TIMER_EVENT;
+    } else {
+        const uint64_t timerEventTime = __latticeGlobalTime(particle, particle->mcu.cyclesPassed + untilInterrupt);
+        if (timerEventTime != particle->timerEventTime) {
+            LatticeEvent event;
+            event.time = timerEventTime;
+            event.particleIndex = particleIndex;
+            event.type = LATTICE_EVENT_TYPE_TIMER;
+            event.port = 0;
+            event.isHigh = false;
+            particle->timerEventTime = timerEventTime;
+            latticeEventQueuePush(&lattice->bands[particle->band].queue, event);
+        }
+    }
+
+    __latticeTraceEdges(particle);
+
+    // the firmware un-schedules the actuation command when starting it
+    const bool isActuationScheduled = ParticleAttributes.actuationCommand.isScheduled;
+    if (particle->isActuationScheduled && !isActuationScheduled) {
+        particle->numActuations++;
+    }
+    particle->isActuationScheduled = isActuationScheduled;
+
+    // an interrupt woke up the sleeping MCU
+    if (particle->isPoweredOn && !particle->isProcessScheduled && !particle->mcu.registers.isSleeping) {
+        __latticeScheduleProcess(lattice, particleIndex, time);
+    }
+}
+
+/**
+ * Executes one main loop iteration and schedules the next one unless the MCU fell asleep.
+ */
+static void __latticeProcess(Lattice *const lattice, const uint32_t particleIndex) {
+    LatticeParticle *const particle = &lattice->particles[particleIndex];
+    if (particle->mcu.registers.isSleeping) {
+        return;
+    }
+    process();
+    // interrupts flagged while disabled are served as soon as the main loop enables them
+    virtualMcuServePendingInterrupts();
+    if (particle->mcu.registers.isSleeping) {
+        return;
+    }
+    const uint64_t loopCycles = lattice->processLoopCycles + virtualMcuConsumeBusyWaitCycles();
+    __latticeScheduleProcess(lattice, particleIndex,
+                             __latticeGlobalTime(particle, particle->mcu.cyclesPassed + loopCycles));
+}
+
+/**
+ * Delivers the event to its particle.
+ */
+static void __latticeDispatch(Lattice *const lattice, const LatticeEvent *const event) {
+    LatticeParticle *const particle = &lattice->particles[event->particleIndex];
+    switch (event->type) {
+        case LATTICE_EVENT_TYPE_POWER_ON:
+            __latticeEnterParticle(particle, event->time);
+            // as processLoop() does before entering the main loop
+            IO_PORTS_SETUP;
+            constructParticle(&ParticleAttributes);
+            ParticleAttributes.node.state = STATE_TYPE_START;
+            particle->isPoweredOn = true;
+            for (uint8_t port = 0; port < LATTICE_PORT_TYPE_NUMBER_PORTS; port++) {
+                particle->tracedSnapshotEndIndices[port] = __latticeRxPort(particle, port)->snapshotsBuffer.endIndex;
+            }
+            __latticeProcess(lattice, event->particleIndex);
+            break;
+
+        case LATTICE_EVENT_TYPE_PROCESS:
+            particle->isProcessScheduled = false;
+            __latticeEnterParticle(particle, event->time);
+            __latticeProcess(lattice, event->particleIndex);
+            break;
+
+        case LATTICE_EVENT_TYPE_TIMER:
+            if (event->time != particle->timerEventTime) {
+                // outdated: timer re-configured in between
+                return;
+            }
+            particle->timerEventTime = LATTICE_NO_TIMER_EVENT;
+            __latticeEnterParticle(particle, event->time);
+            break;
+
+        case LATTICE_EVENT_TYPE_EDGE:
+            __latticeEnterParticle(particle, event->time);
+            virtualMcuSetExternalInterruptPin(__latticeReceptionInterruptNumber(event->port), event->isHigh);
+            break;
+
+        default:
+            return;
+    }
+    __latticeLeaveParticle(lattice, event->particleIndex, event->time);
+    lattice->bands[particle->band].numEvents++;
+}
+
+/**
+ * @return the index of the particle at the given row and column, counted from 0
+ */
+static inline uint32_t latticeParticleIndex(const Lattice *const lattice, const uint16_t row, const uint16_t column) {
+    return (uint32_t) row * lattice->columns + column;
+}
+
+/**
+ * Selects the particle in the calling thread, i.e. ParticleAttributes and the MCU registers
+ * refer to this particle afterwards.
+ * @param lattice the lattice
+ * @param particleIndex the particle to select
+ */
+void latticeSelectParticle(Lattice *const lattice, const uint32_t particleIndex) {
+    CurrentParticle = &lattice->particles[particleIndex].particle;
+    virtualMcuSelect(&lattice->particles[particleIndex].mcu);
+}
+
+/**
+ * Delivers the band's events due before the given global time.
+ */
+static void __latticeRunBand(Lattice *const lattice, LatticeBand *const band, const uint64_t windowEndTime) {
+    LatticeEvent event;
+    while (latticeEventQueuePeekTime(&band->queue) < windowEndTime) {
+        latticeEventQueuePop(&band->queue, &event);
+        __latticeDispatch(lattice, &event);
+    }
+}
+
+/**
+ * Moves the edge events the adjacent bands handed over to the band's queue.
+ */
+static void __latticeMergeOutboxes(Lattice *const lattice, const uint16_t band) {
+    if (band > 0) {
+        latticeEventBufferMoveTo(&lattice->bands[band - 1].outboxes[LATTICE_BAND_NEIGHBOUR_TYPE_SOUTH],
+                                 &lattice->bands[band].queue);
+    }
+    if (band + 1 < lattice->numBands) {
+        latticeEventBufferMoveTo(&lattice->bands[band + 1].outboxes[LATTICE_BAND_NEIGHBOUR_TYPE_NORTH],
+                                 &lattice->bands[band].queue);
+    }
+}
+
+/**
+ * Blocks until all threads arrived.
+ * @param barrier the barrier to wait at
+ * @param localSense the thread's sense, toggled on each call
+ */
+static void __latticeBarrierWait(LatticeBarrier *const barrier, uint32_t *const localSense) {
+    *localSense = !*localSense;
+    if (__atomic_add_fetch(&barrier->numArrived, 1, __ATOMIC_ACQ_REL) == barrier->numThreads) {
+        __atomic_store_n(&barrier->numArrived, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&barrier->sense, *localSense, __ATOMIC_RELEASE);
+        return;
+    }
+    uint32_t spins = 0;
+    while (__atomic_load_n(&barrier->sense, __ATOMIC_ACQUIRE) != *localSense) {
+        if (++spins == __LATTICE_BARRIER_SPINS_BEFORE_YIELD) {
+            spins = 0;
+            sched_yield();
+        }
+    }
+}
+
+/**
+ * Shared state of the band threads of one latticeRun() call.
+ */
+typedef struct LatticeRun {
+    Lattice *lattice;
+    uint64_t endTime;
+    /**
+     * earliest pending event per band
+     */
+    uint64_t *nextEventTimes;
+    LatticeBarrier *barrier;
+} LatticeRun;
+
+/**
+ * A band thread's arguments.
+ */
+typedef struct LatticeBandThread {
+    LatticeRun *run;
+    uint16_t band;
+} LatticeBandThread;
+
+/**
+ * Simulates one band in time windows synchronized with all other bands.
+ */
+static void *__latticeBandThread(void *const argument) {
+    const LatticeBandThread *const thread = argument;
+    LatticeRun *const run = thread->run;
+    Lattice *const lattice = run->lattice;
+    LatticeBand *const band = &lattice->bands[thread->band];
+    uint32_t localSense = false;
+
+    for (;;) {
+        __latticeMergeOutboxes(lattice, thread->band);
+        __atomic_store_n(&run->nextEventTimes[thread->band], latticeEventQueuePeekTime(&band->queue),
+                         __ATOMIC_RELAXED);
+        __latticeBarrierWait(run->barrier, &localSense);
+
+        uint64_t windowStartTime = LATTICE_EVENT_QUEUE_EMPTY;
+        for (uint16_t idx = 0; idx < lattice->numBands; idx++) {
+            const uint64_t nextEventTime = __atomic_load_n(&run->nextEventTimes[idx], __ATOMIC_RELAXED);
+            if (nextEventTime < windowStartTime) {
+                windowStartTime = nextEventTime;
+            }
+        }
+        if (windowStartTime > run->endTime) {
+            break;
+        }
+        uint64_t windowEndTime = windowStartTime + lattice->wireLatencyCycles;
+        if (windowEndTime > run->endTime + 1) {
+            windowEndTime = run->endTime + 1;
+        }
+        __latticeRunBand(lattice, band, windowEndTime);
+        __latticeBarrierWait(run->barrier, &localSense);
+    }
+    return NULL;
+}
+
+/**
+ * Records the edges the particle receives at the port to the trace.
+ * @param lattice the lattice
+ * @param particleIndex the particle to trace
+ * @param port the reception port to trace
+ * @param trace the trace to append to or NULL to stop tracing
+ */
+void latticeTraceEdges(Lattice *const lattice, const uint32_t particleIndex, const LatticePortType port,
+                       EdgeTraceWriter *const trace) {
+    LatticeParticle *const particle = &lattice->particles[particleIndex];
+    particle->edgeTraces[port] = trace;
+    particle->tracedSnapshotEndIndices[port] = __latticeRxPort(particle, port)->snapshotsBuffer.endIndex;
+}
+
+/**
+ * Schedules the power on of a particle.
+ * @param lattice the lattice
+ * @param particleIndex the particle to power on
+ * @param time the global power on time
+ */
+void latticePowerOn(Lattice *const lattice, const uint32_t particleIndex, const uint64_t time) {
+    LatticeEvent event;
+    event.time = time;
+    event.particleIndex = particleIndex;
+    event.type = LATTICE_EVENT_TYPE_POWER_ON;
+    event.port = 0;
+    event.isHigh = false;
+    latticeEventQueuePush(&lattice->bands[lattice->particles[particleIndex].band].queue, event);
+}
+
+/**
+ * Partitions the lattice into bands of consecutive rows. Pending events are moved to the new bands.
+ * @param lattice the lattice to partition
+ * @param numBands the number of bands, at most one band per row
+ */
+void latticePartition(Lattice *const lattice, uint16_t numBands) {
+    if (numBands > lattice->rows) {
+        numBands = lattice->rows;
+    }
+    if (numBands == 0) {
+        numBands = 1;
+    }
+
+    LatticeBand *const bands = malloc(numBands * sizeof(LatticeBand));
+    if (bands == NULL) {
+        fprintf(stderr, "lattice: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    for (uint16_t band = 0; band < numBands; band++) {
+        const uint32_t firstRow = (uint32_t) lattice->rows * band / numBands;
+        const uint32_t endRow = (uint32_t) lattice->rows * (band + 1) / numBands;
+        constructLatticeBand(&bands[band], firstRow * lattice->columns, endRow * lattice->columns);
+        for (uint32_t idx = bands[band].firstParticle; idx < bands[band].endParticle; idx++) {
+            lattice->particles[idx].band = band;
+        }
+    }
+
+    LatticeEvent event;
+    for (uint16_t band = 0; band < lattice->numBands; band++) {
+        LatticeBand *const oldBand = &lattice->bands[band];
+        for (uint8_t neighbour = 0; neighbour < LATTICE_BAND_NEIGHBOUR_TYPE_NUMBER_NEIGHBOURS; neighbour++) {
+            latticeEventBufferMoveTo(&oldBand->outboxes[neighbour], &oldBand->queue);
+        }
+        while (latticeEventQueuePeekTime(&oldBand->queue) != LATTICE_EVENT_QUEUE_EMPTY) {
+            latticeEventQueuePop(&oldBand->queue, &event);
+            latticeEventQueuePush(&bands[lattice->particles[event.particleIndex].band].queue, event);
+        }
+        bands[0].numEvents += oldBand->numEvents;
+        destructLatticeBand(oldBand);
+    }
+    free(lattice->bands);
+    lattice->bands = bands;
+    lattice->numBands = numBands;
+}
+
+/**
+ * Delivers all events due until the given global time. A partitioned lattice is simulated by one
+ * thread per band.
+ * @param lattice the lattice to simulate
+ * @param endTime the global time to simulate to
+ */
+void latticeRun(Lattice *const lattice, const uint64_t endTime) {
+    if (lattice->numBands == 1) {
+        __latticeRunBand(lattice, &lattice->bands[0], endTime + 1);
+    } else {
+        LatticeRun run;
+        run.lattice = lattice;
+        run.endTime = endTime;
+        run.nextEventTimes = calloc(lattice->numBands, sizeof(uint64_t));
+        run.barrier = malloc(sizeof(LatticeBarrier));
+        LatticeBandThread *const threads = malloc(lattice->numBands * sizeof(LatticeBandThread));
+        pthread_t *const threadIds = malloc(lattice->numBands * sizeof(pthread_t));
+        if (run.nextEventTimes == NULL || run.barrier == NULL || threads == NULL || threadIds == NULL) {
+            fprintf(stderr, "lattice: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+        constructLatticeBarrier(run.barrier, lattice->numBands);
+
+        for (uint16_t band = 0; band < lattice->numBands; band++) {
+            threads[band].run = &run;
+            threads[band].band = band;
+        }
+        for (uint16_t band = 1; band < lattice->numBands; band++) {
+            if (pthread_create(&threadIds[band], NULL, __latticeBandThread, &threads[band]) != 0) {
+                fprintf(stderr, "lattice: failed to create band thread\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        __latticeBandThread(&threads[0]);
+        for (uint16_t band = 1; band < lattice->numBands; band++) {
+            pthread_join(threadIds[band], NULL);
+        }
+
+        free(threadIds);
+        free(threads);
+        free(run.barrier);
+        free(run.nextEventTimes);
+    }
+
+    lattice->numEvents = 0;
+    for (uint16_t band = 0; band < lattice->numBands; band++) {
+        lattice->numEvents += lattice->bands[band].numEvents;
+    }
+    lattice->time = endTime;
+}
@@ -0,0 +1,154 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Lattice simulation types: particles running the uc-core firmware on virtual MCUs,
+ * wired to a network as the firmware expects it.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "uc-core/particle/types/ParticleTypes.h"
+#include "mcu/VirtualMcuTypes.h"
+#include "trace/EdgeTraceTypes.h"
+#include "EventQueueTypes.h"
+
+/**
+ * marks an unconnected port
+ */
+#define LATTICE_NO_NEIGHBOUR UINT32_MAX
+
+/**
+ * marks a particle without scheduled timer event
+ */
+#define LATTICE_NO_TIMER_EVENT UINT64_MAX
+
+/**
+ * The particle ports.
+ */
+typedef enum LatticePortType {
+    LATTICE_PORT_TYPE_NORTH = 0,
+    LATTICE_PORT_TYPE_EAST,
+    LATTICE_PORT_TYPE_SOUTH,
+    LATTICE_PORT_TYPE_NUMBER_PORTS
+} LatticePortType;
+
+/**
+ * One simulated particle: the firmware's state, the MCU it runs on and its wiring.
+ */
+typedef struct LatticeParticle {
+    Particle particle;
+    VirtualMcu mcu;
+    /**
+     * neighbour particle index per port or LATTICE_NO_NEIGHBOUR
+     */
+    uint32_t neighbours[LATTICE_PORT_TYPE_NUMBER_PORTS];
+    /**
+     * the band simulating this particle
+     */
+    uint16_t band;
+    /**
+     * the neighbour's port the local port is wired to
+     */
+    uint8_t neighbourPorts[LATTICE_PORT_TYPE_NUMBER_PORTS];
+    /**
+     * last signal level driven to the neighbour's reception pin per port
+     */
+    uint8_t wireLevels[LATTICE_PORT_TYPE_NUMBER_PORTS];
+    /**
+     * trace of the edges received per port or NULL
+     */
+    EdgeTraceWriter *edgeTraces[LATTICE_PORT_TYPE_NUMBER_PORTS];
+    /**
+     * snapshot buffer index up to which the received edges are traced per port
+     */
+    uint8_t tracedSnapshotEndIndices[LATTICE_PORT_TYPE_NUMBER_PORTS];
+    /**
+     * clock deviation in parts per million: positive values run faster than the global time
+     */
+    int32_t clockDeviationPpm;
+    /**
+     * global time of the scheduled timer event or LATTICE_NO_TIMER_EVENT
+     */
+    uint64_t timerEventTime;
+    /**
+     * number of actuation commands the particle started executing
+     */
+    uint16_t numActuations;
+    uint8_t isPoweredOn : 1;
+    uint8_t isProcessScheduled : 1;
+    uint8_t isActuationScheduled : 1;
+    uint8_t __pad : 5;
+} LatticeParticle;
+
+/**
+ * The adjacent bands of a band.
+ */
+typedef enum LatticeBandNeighbourType {
+    LATTICE_BAND_NEIGHBOUR_TYPE_NORTH = 0,
+    LATTICE_BAND_NEIGHBOUR_TYPE_SOUTH,
+    LATTICE_BAND_NEIGHBOUR_TYPE_NUMBER_NEIGHBOURS
+} LatticeBandNeighbourType;
+
+/**
+ * Consecutive rows of particles simulated by one thread. Signal edges crossing the band boundary
+ * are the only interaction with other bands: they are handed over via the outboxes.
+ */
+typedef struct LatticeBand {
+    /**
+     * index of the band's first particle
+     */
+    uint32_t firstParticle;
+    /**
+     * index after the band's last particle
+     */
+    uint32_t endParticle;
+    LatticeEventQueue queue;
+    /**
+     * edge events to the north/south adjacent band, written during a time window, merged by
+     * the adjacent band after the window
+     */
+    LatticeEventBuffer outboxes[LATTICE_BAND_NEIGHBOUR_TYPE_NUMBER_NEIGHBOURS];
+    /**
+     * number of delivered events
+     */
+    uint64_t numEvents;
+} LatticeBand;
+
+/**
+ * Spinning sense reversing barrier of the band threads.
+ * @pre The object is naturally aligned (heap allocated) since its members are accessed atomically.
+ */
+typedef struct LatticeBarrier {
+    uint32_t numThreads;
+    uint32_t numArrived;
+    uint32_t sense;
+} LatticeBarrier;
+
+/**
+ * A rows x columns network of particles partitioned into row bands. Time is measured in CPU cycles.
+ */
+typedef struct Lattice {
+    uint16_t rows;
+    uint16_t columns;
+    LatticeParticle *particles;
+    LatticeBand *bands;
+    uint16_t numBands;
+    /**
+     * current global time
+     */
+    uint64_t time;
+    /**
+     * number of delivered events
+     */
+    uint64_t numEvents;
+    /**
+     * signal propagation delay from a transmission pin to the neighbour's reception pin,
+     * also the lookahead of bands simulated in parallel
+     */
+    uint32_t wireLatencyCycles;
+    /**
+     * CPU cycles of one main loop iteration, i.e. one call to process()
+     */
+    uint32_t processLoopCycles;
+} Lattice;
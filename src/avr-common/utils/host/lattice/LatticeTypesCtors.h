@@ -0,0 +1,159 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Lattice simulation types constructor implementation.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "uc-core/configuration/communication/Communication.h"
+#include "LatticeTypes.h"
+#include "EventQueueTypesCtors.h"
+#include "mcu/VirtualMcuTypesCtors.h"
+
+/**
+ * default signal propagation delay in CPU cycles: half a manchester clock at default transmission speed,
+ * which is the lookahead of bands simulated in parallel
+ */
+#define LATTICE_DEFAULT_WIRE_LATENCY_CYCLES ((uint32_t) COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY / 2)
+
+/**
+ * default main loop iteration duration in CPU cycles
+ */
+#define LATTICE_DEFAULT_PROCESS_LOOP_CYCLES ((uint32_t) 256)
+
+/**
+ * Wires the local port to the neighbour's port.
+ */
+static void __latticeConnect(Lattice *const o, const uint32_t particle, const LatticePortType port,
+                             const uint32_t neighbour, const LatticePortType neighbourPort) {
+    o->particles[particle].neighbours[port] = neighbour;
+    o->particles[particle].neighbourPorts[port] = neighbourPort;
+    o->particles[neighbour].neighbours[neighbourPort] = particle;
+    o->particles[neighbour].neighbourPorts[neighbourPort] = port;
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructLatticeParticle(LatticeParticle *const o) {
+    constructVirtualMcu(&o->mcu);
+    // wires are idle high before power on: north (PB2), east (PD3) and south (PD2) reception pins
+    o->mcu.registers.pinb |= 1 << 2;
+    o->mcu.registers.pind |= (1 << 3) | (1 << 2);
+    for (uint8_t port = 0; port < LATTICE_PORT_TYPE_NUMBER_PORTS; port++) {
+        o->neighbours[port] = LATTICE_NO_NEIGHBOUR;
+        o->neighbourPorts[port] = port;
+        o->wireLevels[port] = true;
+        o->edgeTraces[port] = NULL;
+        o->tracedSnapshotEndIndices[port] = 0;
+    }
+    o->band = 0;
+    o->clockDeviationPpm = 0;
+    o->timerEventTime = LATTICE_NO_TIMER_EVENT;
+    o->numActuations = 0;
+    o->isPoweredOn = false;
+    o->isProcessScheduled = false;
+    o->isActuationScheduled = false;
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ * @param firstParticle index of the band's first particle
+ * @param endParticle index after the band's last particle
+ */
+void constructLatticeBand(LatticeBand *const o, const uint32_t firstParticle, const uint32_t endParticle) {
+    o->firstParticle = firstParticle;
+    o->endParticle = endParticle;
+    constructLatticeEventQueue(&o->queue);
+    for (uint8_t neighbour = 0; neighbour < LATTICE_BAND_NEIGHBOUR_TYPE_NUMBER_NEIGHBOURS; neighbour++) {
+        constructLatticeEventBuffer(&o->outboxes[neighbour]);
+    }
+    o->numEvents = 0;
+}
+
+/**
+ * destructor function
+ * @param o reference to the object to destruct
+ */
+void destructLatticeBand(LatticeBand *const o) {
+    destructLatticeEventQueue(&o->queue);
+    for (uint8_t neighbour = 0; neighbour < LATTICE_BAND_NEIGHBOUR_TYPE_NUMBER_NEIGHBOURS; neighbour++) {
+        destructLatticeEventBuffer(&o->outboxes[neighbour]);
+    }
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ * @param numThreads the number of threads to synchronize
+ */
+void constructLatticeBarrier(LatticeBarrier *const o, const uint32_t numThreads) {
+    o->numThreads = numThreads;
+    o->numArrived = 0;
+    o->sense = false;
+}
+
+/**
+ * Constructs a rows x columns lattice wired as the firmware's enumeration expects it:
+ * the origin is the top left particle, the east port of a top row particle is wired to
+ * the north port of its right neighbour and each south port is wired to the north port
+ * of the particle below. The east ports of all other particles are not connected.
+ * The lattice is simulated as one band, see latticePartition().
+ * @param o reference to the object to construct
+ * @param rows number of rows
+ * @param columns number of columns
+ */
+void constructLattice(Lattice *const o, const uint16_t rows, const uint16_t columns) {
+    o->rows = rows;
+    o->columns = columns;
+    o->particles = calloc((size_t) rows * columns, sizeof(LatticeParticle));
+    if (o->particles == NULL) {
+        fprintf(stderr, "lattice: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    o->bands = malloc(sizeof(LatticeBand));
+    if (o->bands == NULL) {
+        fprintf(stderr, "lattice: out of memory\n");
+        exit(EXIT_FAILURE);
+    }
+    o->numBands = 1;
+    constructLatticeBand(&o->bands[0], 0, (uint32_t) rows * columns);
+    o->time = 0;
+    o->numEvents = 0;
+    o->wireLatencyCycles = LATTICE_DEFAULT_WIRE_LATENCY_CYCLES;
+    o->processLoopCycles = LATTICE_DEFAULT_PROCESS_LOOP_CYCLES;
+
+    for (uint32_t idx = 0; idx < (uint32_t) rows * columns; idx++) {
+        constructLatticeParticle(&o->particles[idx]);
+    }
+    for (uint16_t row = 0; row < rows; row++) {
+        for (uint16_t column = 0; column < columns; column++) {
+            const uint32_t idx = (uint32_t) row * columns + column;
+            if (row == 0 && column + 1 < columns) {
+                __latticeConnect(o, idx, LATTICE_PORT_TYPE_EAST, idx + 1, LATTICE_PORT_TYPE_NORTH);
+            }
+            if (row + 1 < rows) {
+                __latticeConnect(o, idx, LATTICE_PORT_TYPE_SOUTH, idx + columns, LATTICE_PORT_TYPE_NORTH);
+            }
+        }
+    }
+}
+
+/**
+ * destructor function
+ * @param o reference to the object to destruct
+ */
+void destructLattice(Lattice *const o) {
+    for (uint16_t band = 0; band < o->numBands; band++) {
+        destructLatticeBand(&o->bands[band]);
+    }
+    free(o->bands);
+    o->bands = NULL;
+    free(o->particles);
+    o->particles = NULL;
+}
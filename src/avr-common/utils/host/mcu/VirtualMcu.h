@@ -0,0 +1,353 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Virtual MCU implementation: virtual timer/counters and external interrupt pins
+ * dispatching the interrupt service routines of uc-core on the build host.
+ * Only the modes uc-core uses are modelled:
+ * - timer/counter 1 in normal (wrap at 0xffff) and CTC (wrap at OCR1A) mode with compare match A and B,
+ * - timer/counter 0 in phase correct PWM mode with compare match.
+ * The AVR clears interrupt flags by writing a logical one to them, which cannot be mimicked
+ * by plain register fields. Therefore flags are raised for enabled interrupts only. uc-core
+ * clears pending flags before enabling an interrupt anyway. Flags raised while the global
+ * interrupt flag (I-flag in SREG) is cleared remain pending.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <avr/interrupt.h>
+#include "VirtualMcuTypes.h"
+#include "VirtualMcuGlobals.h"
+
+/**
+ * timer/counter 0 phase correct PWM period in timer ticks
+ */
+#define __VIRTUAL_MCU_TIMER0_PWM_PERIOD ((uint16_t) 510)
+
+/**
+ * return value for no upcoming interrupt
+ */
+#define VIRTUAL_MCU_NO_INTERRUPT UINT32_MAX
+
+/**
+ * Selects the virtual MCU the register macros refer to in the calling thread.
+ * @param mcu the MCU to select
+ */
+void virtualMcuSelect(VirtualMcu *const mcu) {
+    CurrentVirtualMcu = mcu;
+}
+
+/**
+ * Mirrors the output pin levels to the PINx registers as the hardware does.
+ */
+void virtualMcuSyncOutputPins(void) {
+    VirtualRegisterFile *const r = &CurrentVirtualMcu->registers;
+    r->pina = (r->pina & ~r->ddra) | (r->porta & r->ddra);
+    r->pinb = (r->pinb & ~r->ddrb) | (r->portb & r->ddrb);
+    r->pinc = (r->pinc & ~r->ddrc) | (r->portc & r->ddrc);
+    r->pind = (r->pind & ~r->ddrd) | (r->portd & r->ddrd);
+}
+
+/**
+ * Invokes the interrupt service routine as the hardware does: global interrupts are
+ * disabled while the routine executes and re-enabled on return. A sleeping MCU wakes up.
+ * @param isr the routine to invoke
+ */
+static void __virtualMcuServeInterrupt(void (*const isr)(void)) {
+    if (isr == NULL) {
+        return;
+    }
+    CurrentVirtualMcu->registers.isSleeping = false;
+    SREG &= ~_BV(SREG_I);
+    isr();
+    SREG |= _BV(SREG_I);
+    CurrentVirtualMcu->numInterruptsServed++;
+    virtualMcuSyncOutputPins();
+}
+
+/**
+ * Serves all pending and enabled interrupts if global interrupts are enabled.
+ * Interrupts are served in the order of the vector table.
+ */
+void virtualMcuServePendingInterrupts(void) {
+    if (!(SREG & _BV(SREG_I))) {
+        return;
+    }
+    if ((GIFR & _BV(INTF0)) && (GICR & _BV(INT0))) {
+        GIFR &= ~_BV(INTF0);
+        __virtualMcuServeInterrupt(INT0_vect);
+    }
+    if ((GIFR & _BV(INTF1)) && (GICR & _BV(INT1))) {
+        GIFR &= ~_BV(INTF1);
+        __virtualMcuServeInterrupt(INT1_vect);
+    }
+    if ((TIFR & _BV(OCF1A)) && (TIMSK & _BV(OCIE1A))) {
+        TIFR &= ~_BV(OCF1A);
+        __virtualMcuServeInterrupt(TIMER1_COMPA_vect);
+    }
+    if ((TIFR & _BV(OCF1B)) && (TIMSK & _BV(OCIE1B))) {
+        TIFR &= ~_BV(OCF1B);
+        __virtualMcuServeInterrupt(TIMER1_COMPB_vect);
+    }
+    if ((GIFR & _BV(INTF2)) && (GICR & _BV(INT2))) {
+        GIFR &= ~_BV(INTF2);
+        __virtualMcuServeInterrupt(INT2_vect);
+    }
+    if ((TIFR & _BV(OCF0)) && (TIMSK & _BV(OCIE0))) {
+        TIFR &= ~_BV(OCF0);
+        __virtualMcuServeInterrupt(TIMER0_COMP_vect);
+    }
+}
+
+/**
+ * @param clockSelect the timer/counter clock select bits (CSx2:0)
+ * @return the prescaler division factor or 0 if the clock source is disconnected or external
+ */
+static uint16_t __virtualMcuPrescaler(const uint8_t clockSelect) {
+    switch (clockSelect & 0x7) {
+        case 1:
+            return 1;
+        case 2:
+            return 8;
+        case 3:
+            return 64;
+        case 4:
+            return 256;
+        case 5:
+            return 1024;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @return the value timer/counter 1 wraps around at
+ */
+static uint16_t __virtualMcuTimer1Top(void) {
+    return (TCCR1B & _BV(WGM12)) ? OCR1A : 0xffff;
+}
+
+/**
+ * @return the number of ticks until timer/counter 1 reaches the compare value or 0 if never
+ */
+static uint32_t __virtualMcuTimer1TicksUntil(const uint16_t compareValue) {
+    const uint16_t top = __virtualMcuTimer1Top();
+    if (TCNT1 > top) {
+        // counter was set beyond top: counts up to 0xffff first
+        if (compareValue > TCNT1) {
+            return compareValue - TCNT1;
+        }
+        return (compareValue <= top) ? (0x10000 - TCNT1) + compareValue : 0;
+    }
+    if (compareValue > top) {
+        return 0;
+    }
+    const uint32_t period = (uint32_t) top + 1;
+    const uint32_t distance = (compareValue + period - TCNT1) % period;
+    return (distance == 0) ? period : distance;
+}
+
+/**
+ * Advances timer/counter 1 by the given number of ticks without raising flags.
+ */
+static void __virtualMcuTimer1Step(uint32_t ticks) {
+    const uint16_t top = __virtualMcuTimer1Top();
+    if (TCNT1 > top) {
+        const uint32_t untilOverflow = 0x10000 - TCNT1;
+        if (ticks < untilOverflow) {
+            TCNT1 += ticks;
+            return;
+        }
+        ticks -= untilOverflow;
+        TCNT1 = 0;
+    }
+    TCNT1 = (TCNT1 + ticks) % ((uint32_t) top + 1);
+}
+
+/**
+ * @return the CPU cycles until the next enabled timer/counter 1 compare match or VIRTUAL_MCU_NO_INTERRUPT
+ */
+static uint32_t __virtualMcuTimer1CyclesUntilInterrupt(void) {
+    const uint16_t prescaler = __virtualMcuPrescaler(TCCR1B);
+    if (prescaler == 0) {
+        return VIRTUAL_MCU_NO_INTERRUPT;
+    }
+    uint32_t ticks = 0;
+    if (TIMSK & _BV(OCIE1A)) {
+        ticks = __virtualMcuTimer1TicksUntil(OCR1A);
+    }
+    if (TIMSK & _BV(OCIE1B)) {
+        const uint32_t ticksB = __virtualMcuTimer1TicksUntil(OCR1B);
+        if (ticks == 0 || (ticksB != 0 && ticksB < ticks)) {
+            ticks = ticksB;
+        }
+    }
+    if (ticks == 0) {
+        return VIRTUAL_MCU_NO_INTERRUPT;
+    }
+    return ticks * prescaler - CurrentVirtualMcu->timer1PrescalerCycles % prescaler;
+}
+
+/**
+ * @return the timer/counter 0 value at the given phase correct PWM position
+ */
+static uint8_t __virtualMcuTimer0Value(const uint16_t phase) {
+    return (phase <= UINT8_MAX) ? phase : __VIRTUAL_MCU_TIMER0_PWM_PERIOD - phase;
+}
+
+/**
+ * Re-synchronizes the hidden phase with TCNT0 in case the firmware wrote the counter.
+ */
+static void __virtualMcuTimer0SyncPhase(void) {
+    if (__virtualMcuTimer0Value(CurrentVirtualMcu->timer0Phase) != TCNT0) {
+        CurrentVirtualMcu->timer0Phase = TCNT0;
+    }
+}
+
+/**
+ * @return the CPU cycles until the next enabled timer/counter 0 compare match or VIRTUAL_MCU_NO_INTERRUPT
+ */
+static uint32_t __virtualMcuTimer0CyclesUntilInterrupt(void) {
+    const uint16_t prescaler = __virtualMcuPrescaler(TCCR0);
+    if (prescaler == 0 || !(TIMSK & _BV(OCIE0))) {
+        return VIRTUAL_MCU_NO_INTERRUPT;
+    }
+    __virtualMcuTimer0SyncPhase();
+    const uint16_t phase = CurrentVirtualMcu->timer0Phase;
+    // matches once while counting up and once while counting down
+    uint16_t upDistance = (OCR0 + __VIRTUAL_MCU_TIMER0_PWM_PERIOD - phase) % __VIRTUAL_MCU_TIMER0_PWM_PERIOD;
+    uint16_t downDistance = (2 * __VIRTUAL_MCU_TIMER0_PWM_PERIOD - OCR0 - phase) % __VIRTUAL_MCU_TIMER0_PWM_PERIOD;
+    if (upDistance == 0) {
+        upDistance = __VIRTUAL_MCU_TIMER0_PWM_PERIOD;
+    }
+    if (downDistance == 0) {
+        downDistance = __VIRTUAL_MCU_TIMER0_PWM_PERIOD;
+    }
+    const uint32_t ticks = (upDistance < downDistance) ? upDistance : downDistance;
+    return ticks * prescaler - CurrentVirtualMcu->timer0PrescalerCycles % prescaler;
+}
+
+/**
+ * @return the CPU cycles until the next enabled timer/counter compare match or VIRTUAL_MCU_NO_INTERRUPT
+ */
+uint32_t virtualMcuCyclesUntilTimerInterrupt(void) {
+    const uint32_t untilTimer1 = __virtualMcuTimer1CyclesUntilInterrupt();
+    const uint32_t untilTimer0 = __virtualMcuTimer0CyclesUntilInterrupt();
+    return (untilTimer1 < untilTimer0) ? untilTimer1 : untilTimer0;
+}
+
+/**
+ * Advances both timer/counters by the given CPU cycles without raising flags.
+ */
+static void __virtualMcuStepTimers(const uint32_t cycles) {
+    VirtualMcu *const mcu = CurrentVirtualMcu;
+    mcu->cyclesPassed += cycles;
+
+    const uint16_t prescaler1 = __virtualMcuPrescaler(TCCR1B);
+    if (prescaler1 != 0) {
+        const uint32_t cycles1 = mcu->timer1PrescalerCycles % prescaler1 + cycles;
+        __virtualMcuTimer1Step(cycles1 / prescaler1);
+        mcu->timer1PrescalerCycles = cycles1 % prescaler1;
+    }
+
+    const uint16_t prescaler0 = __virtualMcuPrescaler(TCCR0);
+    if (prescaler0 != 0) {
+        __virtualMcuTimer0SyncPhase();
+        const uint32_t cycles0 = mcu->timer0PrescalerCycles % prescaler0 + cycles;
+        mcu->timer0Phase = (mcu->timer0Phase + cycles0 / prescaler0) % __VIRTUAL_MCU_TIMER0_PWM_PERIOD;
+        mcu->timer0PrescalerCycles = cycles0 % prescaler0;
+        TCNT0 = __virtualMcuTimer0Value(mcu->timer0Phase);
+    }
+}
+
+/**
+ * Advances the virtual timer/counters and serves the compare match interrupts in chronological
+ * order. Interrupt routines may re-configure the timers while advancing.
+ * @param cycles the number of CPU cycles to advance
+ */
+void virtualMcuAdvanceCycles(uint32_t cycles) {
+    while (cycles > 0) {
+        const uint32_t untilTimer1 = __virtualMcuTimer1CyclesUntilInterrupt();
+        const uint32_t untilTimer0 = __virtualMcuTimer0CyclesUntilInterrupt();
+        const uint32_t untilInterrupt = (untilTimer1 < untilTimer0) ? untilTimer1 : untilTimer0;
+
+        if (untilInterrupt > cycles) {
+            __virtualMcuStepTimers(cycles);
+            return;
+        }
+
+        __virtualMcuStepTimers(untilInterrupt);
+        cycles -= untilInterrupt;
+        if (untilTimer1 == untilInterrupt) {
+            if ((TIMSK & _BV(OCIE1A)) && TCNT1 == OCR1A) {
+                TIFR |= _BV(OCF1A);
+            }
+            if ((TIMSK & _BV(OCIE1B)) && TCNT1 == OCR1B) {
+                TIFR |= _BV(OCF1B);
+            }
+        }
+        if (untilTimer0 == untilInterrupt) {
+            TIFR |= _BV(OCF0);
+        }
+        virtualMcuServePendingInterrupts();
+    }
+}
+
+/**
+ * Consumes the CPU cycles the firmware requested to busy wait since the last call.
+ * @return the consumed cycles
+ */
+uint32_t virtualMcuConsumeBusyWaitCycles(void) {
+    const uint32_t cycles = CurrentVirtualMcu->busyWaitCycles;
+    CurrentVirtualMcu->busyWaitCycles = 0;
+    return cycles;
+}
+
+/**
+ * Sets the level of an external interrupt pin and flags the interrupt on a logical change.
+ * All three inputs trigger on any logical change, as the production MCU's pin change
+ * interrupts do. Pending interrupts are served immediately if enabled.
+ * @param interruptNumber the external interrupt number: 0 (PD2), 1 (PD3) or 2 (PB2)
+ * @param isHigh the new pin level
+ */
+void virtualMcuSetExternalInterruptPin(const uint8_t interruptNumber, const bool isHigh) {
+    uint8_t *pin;
+    uint8_t pinMask;
+    uint8_t flag;
+    uint8_t enableBit;
+
+    switch (interruptNumber) {
+        case 0:
+            pin = &PIND;
+            pinMask = _BV(2);
+            flag = _BV(INTF0);
+            enableBit = _BV(INT0);
+            break;
+        case 1:
+            pin = &PIND;
+            pinMask = _BV(3);
+            flag = _BV(INTF1);
+            enableBit = _BV(INT1);
+            break;
+        default:
+            pin = &PINB;
+            pinMask = _BV(2);
+            flag = _BV(INTF2);
+            enableBit = _BV(INT2);
+            break;
+    }
+
+    const bool wasHigh = (*pin & pinMask) != 0;
+    if (wasHigh == isHigh) {
+        return;
+    }
+    if (isHigh) {
+        *pin |= pinMask;
+    } else {
+        *pin &= ~pinMask;
+    }
+    if (GICR & enableBit) {
+        GIFR |= flag;
+        virtualMcuServePendingInterrupts();
+    }
+}
@@ -0,0 +1,20 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Virtual MCU global variables.
+ */
+
+#pragma once
+
+#include "VirtualMcuTypes.h"
+
+/**
+ * The default virtual MCU instance, used if no other instance is selected.
+ */
+VirtualMcu DefaultVirtualMcu;
+
+/**
+ * The virtual MCU the register macros of host/avr/io.h currently refer to.
+ * The pointer is thread local to let different threads step different MCUs.
+ */
+__thread VirtualMcu *CurrentVirtualMcu = &DefaultVirtualMcu;
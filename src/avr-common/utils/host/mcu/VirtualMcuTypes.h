@@ -0,0 +1,106 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Virtual MCU (register file) types used when compiling uc-core for the build host.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * The register file of the virtual MCU. The layout mimics the ATmega16 registers
+ * the firmware is accessing in simulation builds. Each field is accessed by the
+ * register name macros in host/avr/io.h.
+ */
+typedef struct VirtualRegisterFile {
+    /**
+     * status register
+     */
+    uint8_t sreg;
+    /**
+     * general interrupt control/flag register
+     */
+    uint8_t gicr;
+    uint8_t gifr;
+    uint8_t mcucr;
+    uint8_t mcucsr;
+    /**
+     * timer/counter 0
+     */
+    uint8_t tccr0;
+    uint8_t tcnt0;
+    uint8_t ocr0;
+    /**
+     * timer/counter 1
+     */
+    uint8_t tccr1a;
+    uint8_t tccr1b;
+    uint16_t tcnt1;
+    uint16_t ocr1a;
+    uint16_t ocr1b;
+    /**
+     * timer/counter interrupt mask/flag register
+     */
+    uint8_t timsk;
+    uint8_t tifr;
+    /**
+     * io ports
+     */
+    uint8_t porta;
+    uint8_t pina;
+    uint8_t ddra;
+    uint8_t portb;
+    uint8_t pinb;
+    uint8_t ddrb;
+    uint8_t portc;
+    uint8_t pinc;
+    uint8_t ddrc;
+    uint8_t portd;
+    uint8_t pind;
+    uint8_t ddrd;
+    /**
+     * uart and eeprom registers, used by the simulation debug output macros
+     */
+    uint8_t udr;
+    uint8_t eearl;
+    uint8_t eedr;
+    uint8_t osccal;
+    /**
+     * sleep flag: set by sleep_cpu() while sleep_enable() is active
+     */
+    uint8_t isSleeping : 1;
+    uint8_t isSleepEnabled : 1;
+    uint8_t __pad : 6;
+} VirtualRegisterFile;
+
+/**
+ * A virtual MCU consists of its register file and the hidden timer/counter states.
+ */
+typedef struct VirtualMcu {
+    VirtualRegisterFile registers;
+    /**
+     * total number of CPU cycles passed since construction
+     */
+    uint64_t cyclesPassed;
+    /**
+     * CPU cycles the firmware requested to busy wait since the last consumption
+     */
+    uint32_t busyWaitCycles;
+    /**
+     * number of interrupt service routine invocations
+     */
+    uint32_t numInterruptsServed;
+    /**
+     * CPU cycles passed towards the next prescaled timer/counter 1 tick
+     */
+    uint16_t timer1PrescalerCycles;
+    /**
+     * CPU cycles passed towards the next prescaled timer/counter 0 tick
+     */
+    uint16_t timer0PrescalerCycles;
+    /**
+     * timer/counter 0 phase correct PWM position in [0, 510): counting up below 255, down otherwise
+     */
+    uint16_t timer0Phase;
+} VirtualMcu;
@@ -0,0 +1,32 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Virtual MCU types constructor implementation.
+ */
+
+#pragma once
+
+#include <string.h>
+#include "VirtualMcuTypes.h"
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructVirtualRegisterFile(VirtualRegisterFile *const o) {
+    memset(o, 0, sizeof(VirtualRegisterFile));
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructVirtualMcu(VirtualMcu *const o) {
+    constructVirtualRegisterFile(&o->registers);
+    o->cyclesPassed = 0;
+    o->busyWaitCycles = 0;
+    o->numInterruptsServed = 0;
+    o->timer1PrescalerCycles = 0;
+    o->timer0PrescalerCycles = 0;
+    o->timer0Phase = 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Edge trace recording and replay. A trace holds the captureSnapshot() arguments of one reception
+ * port. Replaying feeds them through captureSnapshot() and manchesterDecodeBuffer() of the currently
+ * selected particle, thus decoding and interpretation are reproduced without simulating the sender.
+ */
+
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "uc-core/particle/Particle.h"
+#include "mcu/VirtualMcu.h"
+#include "EdgeTraceTypes.h"
+
+/**
+ * Appends one captured edge.
+ * @param writer the trace to append to
+ * @param timerValue the snapshot's timer/counter value
+ * @param isRisingEdge the signal edge
+ * @param nextLocalTimeInterruptCompareValue the local time tracking compare value at capture time
+ */
+void edgeTraceWrite(EdgeTraceWriter *const writer, const uint16_t timerValue, const bool isRisingEdge,
+                    const uint16_t nextLocalTimeInterruptCompareValue) {
+    EdgeTraceRecord record;
+    record.timerValue = timerValue;
+    record.nextLocalTimeInterruptCompareValue = nextLocalTimeInterruptCompareValue;
+    record.isRisingEdge = isRisingEdge;
+    record.__pad = 0;
+    record.__reserved = 0;
+    if (fwrite(&record, sizeof(EdgeTraceRecord), 1, writer->file) != 1) {
+        fprintf(stderr, "edge trace: write failed\n");
+        exit(EXIT_FAILURE);
+    }
+    writer->numRecords++;
+}
+
+/**
+ * Sets the selected particle's decoder timings as the synchronization does for the given clock delay.
+ */
+static void __edgeTraceSetTransmissionClockDelay(const uint16_t transmissionClockDelay) {
+    TransmissionTimerAdjustment *const timerAdjustment = &ParticleAttributes.communication.timerAdjustment;
+    timerAdjustment->transmissionClockDelay = transmissionClockDelay;
+    timerAdjustment->transmissionClockDelayHalf = transmissionClockDelay / 2;
+    timerAdjustment->newTransmissionClockDelay = calculationFromInteger(transmissionClockDelay);
+    timerAdjustment->newTransmissionClockDelayHalf = calculationFromInteger(timerAdjustment->transmissionClockDelayHalf);
+    timerAdjustment->maxShortIntervalDuration =
+            roundf(COMMUNICATION_DEFAULT_MAX_SHORT_RECEPTION_OVERTIME_PERCENTAGE_RATIO * transmissionClockDelay);
+    timerAdjustment->maxLongIntervalDuration =
+            roundf(COMMUNICATION_DEFAULT_MAX_LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO * transmissionClockDelay);
+}
+
+/**
+ * Replays the trace at the given port of the selected particle. Each edge is captured and decoded
+ * at its own timer/counter value; the last reception is completed by the decoder's timeout.
+ * @pre The interpreter implementation releases the reception buffer, otherwise the decoder stalls.
+ * @param reader the trace to replay
+ * @param port the port to capture and decode at
+ * @param interpreterImpl the interpreter the decoder hands received frames to
+ */
+void edgeTraceReplay(const EdgeTraceReader *const reader, DirectionOrientedPort *const port,
+                     void (*const interpreterImpl)(DirectionOrientedPort *)) {
+    __edgeTraceSetTransmissionClockDelay(reader->header->transmissionClockDelay);
+    uint16_t timerValue = TCNT1;
+    for (uint64_t idx = 0; idx < reader->numRecords; idx++) {
+        const EdgeTraceRecord *const record = &reader->records[idx];
+        timerValue = record->timerValue;
+        captureSnapshot(timerValue, record->isRisingEdge, record->nextLocalTimeInterruptCompareValue,
+                        port->rxPort);
+        TCNT1 = timerValue;
+        manchesterDecodeBuffer(port, interpreterImpl);
+    }
+    TCNT1 = timerValue + 2 * ParticleAttributes.communication.timerAdjustment.transmissionClockDelay;
+    manchesterDecodeBuffer(port, interpreterImpl);
+}
@@ -0,0 +1,90 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Edge trace types: the reception edges of one port as captureSnapshot() stored them.
+ * A trace file is an EdgeTraceHeader followed by EdgeTraceRecords. All fields are little endian
+ * and the structs are packed, thus the file can be memory mapped as is.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/**
+ * trace file magic "PETR"
+ */
+#define EDGE_TRACE_MAGIC ((uint32_t) 0x52544550)
+
+#define EDGE_TRACE_VERSION ((uint16_t) 1)
+
+/**
+ * The reception ports a trace may be recorded at.
+ */
+typedef enum EdgeTracePortType {
+    EDGE_TRACE_PORT_TYPE_NORTH = 0,
+    EDGE_TRACE_PORT_TYPE_EAST,
+    EDGE_TRACE_PORT_TYPE_SOUTH
+} EdgeTracePortType;
+
+typedef struct EdgeTraceHeader {
+    /**
+     * EDGE_TRACE_MAGIC
+     */
+    uint32_t magic;
+    /**
+     * EDGE_TRACE_VERSION
+     */
+    uint16_t version;
+    /**
+     * sizeof(EdgeTraceRecord)
+     */
+    uint16_t recordSize;
+    /**
+     * an EdgeTracePortType
+     */
+    uint8_t port;
+    uint8_t __reserved;
+    /**
+     * the receiver's manchester clock delay at trace start in timer ticks
+     */
+    uint16_t transmissionClockDelay;
+} EdgeTraceHeader;
+
+/**
+ * One captured edge: the arguments of captureSnapshot().
+ */
+typedef struct EdgeTraceRecord {
+    /**
+     * the snapshot's timer/counter value
+     */
+    uint16_t timerValue;
+    /**
+     * the local time tracking compare value at capture time
+     */
+    uint16_t nextLocalTimeInterruptCompareValue;
+    uint8_t isRisingEdge : 1;
+    uint8_t __pad : 7;
+    uint8_t __reserved;
+} EdgeTraceRecord;
+
+/**
+ * Appends records to a trace file.
+ */
+typedef struct EdgeTraceWriter {
+    FILE *file;
+    uint64_t numRecords;
+} EdgeTraceWriter;
+
+/**
+ * A memory mapped trace file.
+ */
+typedef struct EdgeTraceReader {
+    const EdgeTraceHeader *header;
+    const EdgeTraceRecord *records;
+    uint64_t numRecords;
+    /**
+     * length of the mapping in bytes
+     */
+    uint64_t mappedSize;
+} EdgeTraceReader;
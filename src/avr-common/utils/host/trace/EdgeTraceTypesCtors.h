@@ -0,0 +1,101 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Edge trace types constructor implementation.
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "EdgeTraceTypes.h"
+
+/**
+ * constructor function: creates the trace file and writes the header
+ * @param o reference to the object to construct
+ * @param path the file to create
+ * @param port the EdgeTracePortType the trace is recorded at
+ * @param transmissionClockDelay the receiver's manchester clock delay in timer ticks
+ */
+void constructEdgeTraceWriter(EdgeTraceWriter *const o, const char *const path, const uint8_t port,
+                              const uint16_t transmissionClockDelay) {
+    o->numRecords = 0;
+    o->file = fopen(path, "wb");
+    if (o->file == NULL) {
+        fprintf(stderr, "edge trace: failed to create %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    EdgeTraceHeader header;
+    header.magic = EDGE_TRACE_MAGIC;
+    header.version = EDGE_TRACE_VERSION;
+    header.recordSize = sizeof(EdgeTraceRecord);
+    header.port = port;
+    header.__reserved = 0;
+    header.transmissionClockDelay = transmissionClockDelay;
+    if (fwrite(&header, sizeof(EdgeTraceHeader), 1, o->file) != 1) {
+        fprintf(stderr, "edge trace: failed to write %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/**
+ * destructor function: flushes and closes the trace file
+ * @param o reference to the object to destruct
+ */
+void destructEdgeTraceWriter(EdgeTraceWriter *const o) {
+    if (o->file != NULL) {
+        fclose(o->file);
+        o->file = NULL;
+    }
+}
+
+/**
+ * constructor function: maps the trace file and validates the header
+ * @param o reference to the object to construct
+ * @param path the file to map
+ */
+void constructEdgeTraceReader(EdgeTraceReader *const o, const char *const path) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "edge trace: failed to open %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+    // struct stat is not safe to use with packed structs
+    const off_t size = lseek(fd, 0, SEEK_END);
+    if (size < (off_t) sizeof(EdgeTraceHeader)) {
+        fprintf(stderr, "edge trace: %s is truncated\n", path);
+        exit(EXIT_FAILURE);
+    }
+    void *const mapping = mmap(NULL, (size_t) size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        fprintf(stderr, "edge trace: failed to map %s\n", path);
+        exit(EXIT_FAILURE);
+    }
+
+    o->mappedSize = (uint64_t) size;
+    o->header = mapping;
+    if (o->header->magic != EDGE_TRACE_MAGIC || o->header->version != EDGE_TRACE_VERSION ||
+        o->header->recordSize != sizeof(EdgeTraceRecord)) {
+        fprintf(stderr, "edge trace: %s is no version %u trace\n", path, EDGE_TRACE_VERSION);
+        exit(EXIT_FAILURE);
+    }
+    o->records = (const EdgeTraceRecord *) (o->header + 1);
+    o->numRecords = (o->mappedSize - sizeof(EdgeTraceHeader)) / sizeof(EdgeTraceRecord);
+}
+
+/**
+ * destructor function: unmaps the trace file
+ * @param o reference to the object to destruct
+ */
+void destructEdgeTraceReader(EdgeTraceReader *const o) {
+    munmap((void *) o->header, (size_t) o->mappedSize);
+    o->header = NULL;
+    o->records = NULL;
+    o->numRecords = 0;
+    o->mappedSize = 0;
+}
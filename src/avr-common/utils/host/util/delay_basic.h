@@ -0,0 +1,25 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host replacement of <util/delay_basic.h>: busy waiting does not block on the build host,
+ * the cycles the loop would have taken are accounted to the currently selected virtual MCU.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "mcu/VirtualMcuGlobals.h"
+
+/**
+ * CPU cycles per iteration of the 16 bit delay loop
+ */
+#define __DELAY_LOOP_2_CYCLES_PER_ITERATION 4
+
+/**
+ * Accounts the cycles of a 16 bit delay loop to the current virtual MCU.
+ * @param __count the number of loop iterations, 0 means 65536 iterations
+ */
+static inline void _delay_loop_2(uint16_t __count) {
+    const uint32_t iterations = (__count == 0) ? 0x10000 : __count;
+    CurrentVirtualMcu->busyWaitCycles += iterations * __DELAY_LOOP_2_CYCLES_PER_ITERATION;
+}
@@ -17,6 +17,31 @@
 #include "uc-core/configuration/interrupts/LocalTime.h"
 #include "uc-core/time/Time.h"
 
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+
+#  include "TxFrameQueue.h"
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+#  include "Fragmentation.h"
+
+#endif
+
+#if defined(COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH) && !defined(COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION)
+#  error COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH requires COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_MULTICAST
+#  ifndef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+#    error COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_MULTICAST requires COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+#  endif
+
+#  include "HeatWiresMulticast.h"
+
+#endif
+
 
 /**
  * Executes a synchronize local time package.
@@ -52,16 +77,33 @@ void executeSynchronizeLocalTimePackage(const TimePackage *const package, PortBu
     SREG = sreg;
     MEMORY_BARRIER;
     const uint16_t preTxLatency =
-            ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay * 3;
+            calculationToInteger(ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay * 3);
     ParticleAttributes.timeSynchronization.isNextSyncPackageTimeUpdateRequest = package->forceTimePeriodUpdate;
 
     // consider local time tracking ISR delay shift on local time update
-    if (false == ParticleAttributes.localTime.isNewTimerCounterShiftUpdateable &&
-        package->forceTimePeriodUpdate) {
+#  ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+    // the clock discipline observes the phase offset on every time package
+    const bool isPhaseToBeShifted = false == ParticleAttributes.localTime.isNewTimerCounterShiftUpdateable &&
+                                    portBuffer->isPduReceivedTimestampLatched;
+#  else
+    const bool isPhaseToBeShifted = false == ParticleAttributes.localTime.isNewTimerCounterShiftUpdateable &&
+                                    portBuffer->isPduReceivedTimestampLatched &&
+                                    package->forceTimePeriodUpdate;
+#  endif
+    if (isPhaseToBeShifted) {
 
         const uint16_t sepPduEndToTimeIsrDelay = nextLocalTimeTriggerAfterReception - receptionEndTimestamp;
 
         // remote delay from time remote PDU was constructed until remote local time ISR trigger
+#  ifdef SYNCHRONIZATION_ENABLE_FIXED_POINT_CALCULATION
+        // the product of two 16 bit values rounded by half the divisor does not exceed 32 bit
+        const uint32_t sepConstructUntilIsr =
+                // remote phase applied to local time unit
+                ((uint32_t) package->delayUntilNextTimeTrackingIsr *
+                 ParticleAttributes.localTime.newTimePeriodInterruptDelay +
+                 package->localTimeTrackingPeriodInterruptDelay / 2) /
+                package->localTimeTrackingPeriodInterruptDelay;
+#  else
         const uint32_t sepConstructUntilIsr = roundf(
                 // factor of remote phase
                 ((float) package->delayUntilNextTimeTrackingIsr /
@@ -69,6 +111,7 @@ void executeSynchronizeLocalTimePackage(const TimePackage *const package, PortBu
                 // apply to local time unit
                 (float) ParticleAttributes.localTime.newTimePeriodInterruptDelay
         );
+#  endif
 
         // ---------------------- phase shift calculation ----------------------
         /**
@@ -91,6 +134,16 @@ void executeSynchronizeLocalTimePackage(const TimePackage *const package, PortBu
             shift -= ParticleAttributes.localTime.newTimePeriodInterruptDelay;
         }
 
+#  ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+        while (shift < 0) {
+            shift += ParticleAttributes.localTime.newTimePeriodInterruptDelay;
+        }
+        // the phase offset is the short side
+        if (shift >= (ParticleAttributes.localTime.newTimePeriodInterruptDelay / 2)) {
+            shift -= ParticleAttributes.localTime.newTimePeriodInterruptDelay;
+        }
+        shift = clockDisciplineUpdatePhase(shift, &ParticleAttributes.timeSynchronization.clockDiscipline);
+#  else
         // cap the value for the next shift to the maximum step
         uint16_t step;
         if (shift > LOCAL_TIME_IN_PHASE_SHIFTING_MAXIMUM_STEP) {
@@ -106,6 +159,7 @@ void executeSynchronizeLocalTimePackage(const TimePackage *const package, PortBu
             // on short side is right, sift right (extend the interval)
             shift = step;
         }
+#  endif
 
         // expose calculated phase shift to ISR
         ParticleAttributes.localTime.newTimerCounterShift = shift;
@@ -113,34 +167,37 @@ void executeSynchronizeLocalTimePackage(const TimePackage *const package, PortBu
         ParticleAttributes.localTime.isNewTimerCounterShiftUpdateable = true;
 
         // ---------------------- reproduce passed time intervals ----------------------
-        // TODO: reading TIMER_TX_RX_COUNTER_VALUE should happen as late as possible
-//        const uint16_t now = TIMER_TX_RX_COUNTER_VALUE;
-        const uint16_t postRxToInterpeterDelay = now - receptionEndTimestamp;
-
-        /**
-         * Total delay since the next remote time ISR triggers when PDU was constructed until
-         * now.
-         */
-        uint32_t totalSeparation =
-                // PDU received to interpreter latency
-                postRxToInterpeterDelay
-                // reception latency
-                + portBuffer->receptionDuration
-                // remote construction until transmission starts
-                + preTxLatency
-                // delay until remote time ISR triggers when PDU was constructed in local time units
-                - sepConstructUntilIsr;
-
-        uint16_t numTimeIntervals = 2;
-        while (totalSeparation >= ParticleAttributes.localTime.newTimePeriodInterruptDelay) {
-            totalSeparation -= ParticleAttributes.localTime.newTimePeriodInterruptDelay;
-            ++numTimeIntervals;
+        // the clock discipline shifts the phase on any time package, the time period on request only
+        if (package->forceTimePeriodUpdate) {
+            // TODO: reading TIMER_TX_RX_COUNTER_VALUE should happen as late as possible
+//            const uint16_t now = TIMER_TX_RX_COUNTER_VALUE;
+            const uint16_t postRxToInterpeterDelay = now - receptionEndTimestamp;
+
+            /**
+             * Total delay since the next remote time ISR triggers when PDU was constructed until
+             * now.
+             */
+            uint32_t totalSeparation =
+                    // PDU received to interpreter latency
+                    postRxToInterpeterDelay
+                    // reception latency
+                    + portBuffer->receptionDuration
+                    // remote construction until transmission starts
+                    + preTxLatency
+                    // delay until remote time ISR triggers when PDU was constructed in local time units
+                    - sepConstructUntilIsr;
+
+            uint16_t numTimeIntervals = 2;
+            while (totalSeparation >= ParticleAttributes.localTime.newTimePeriodInterruptDelay) {
+                totalSeparation -= ParticleAttributes.localTime.newTimePeriodInterruptDelay;
+                ++numTimeIntervals;
+            }
+
+            // expose calculated number of passed periods to ISR
+            ParticleAttributes.localTime.newNumTimePeriodsPassed = package->timePeriod + numTimeIntervals;
+            MEMORY_BARRIER;
+            ParticleAttributes.localTime.isNumTimePeriodsPassedUpdateable = true;
         }
-
-        // expose calculated number of passed periods to ISR
-        ParticleAttributes.localTime.newNumTimePeriodsPassed = package->timePeriod + numTimeIntervals;
-        MEMORY_BARRIER;
-        ParticleAttributes.localTime.isNumTimePeriodsPassedUpdateable = true;
     }
 
 #endif
@@ -205,22 +262,164 @@ void executeAnnounceNetworkGeometryPackage(const AnnounceNetworkGeometryPackage
 }
 
 /**
- * Copies exactly 9 bytes from source to destination.
+ * Copies exactly COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES bytes from source to destination.
  * @param source where to read the bytes from
  * @param destination where to store the bytes to
  */
-static void __volatileSram9ByteMemcopy(const void *const source,
-                                       volatile void *const destination) {
+static void __volatileSramBufferMemcopy(const void *const source,
+                                        volatile void *const destination) {
     ((uint16_t *) destination)[0] = ((uint16_t *) source)[0];
     ((uint16_t *) destination)[1] = ((uint16_t *) source)[1];
     ((uint16_t *) destination)[2] = ((uint16_t *) source)[2];
     ((uint16_t *) destination)[3] = ((uint16_t *) source)[3];
+#if defined(COMMUNICATION_ENABLE_ERROR_CORRECTION)
+    ((uint16_t *) destination)[4] = ((uint16_t *) source)[4];
+    ((uint8_t *) destination)[10] = ((uint8_t *) source)[10];
+#elif defined(COMMUNICATION_ENABLE_CRC8_FRAME_CHECK)
+    ((uint16_t *) destination)[4] = ((uint16_t *) source)[4];
+#else
     ((uint8_t *) destination)[8] = ((uint8_t *) source)[8];
+#endif
+}
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+
+/**
+ * Number of received bytes needed to route a heat wires package: header, row and column.
+ */
+#define __CUT_THROUGH_RELAY_HEAT_WIRES_ROUTING_BYTES 3
+/**
+ * Number of received bytes needed to route a heat wires range package: header and both addresses.
+ */
+#define __CUT_THROUGH_RELAY_HEAT_WIRES_RANGE_ROUTING_BYTES 5
+/**
+ * Number of received bytes needed to route a header package.
+ */
+#define __CUT_THROUGH_RELAY_HEADER_ROUTING_BYTES 1
+
+/**
+ * Evaluates to the number of bits in between buffer start and the given (uint16_t) BufferPointer.
+ * @param pointer the buffer pointer
+ */
+static uint8_t __pointerToNumberBits(const uint16_t pointer) {
+    uint8_t numberBits = (pointer & 0x000f) * 8;
+    for (uint8_t bitMask = pointer >> 8; bitMask > 1; bitMask >>= 1) {
+        numberBits++;
+    }
+    return numberBits;
+}
+
+/**
+ * Evaluates to the (uint16_t) BufferPointer pointing the given number of bits beyond the buffer start.
+ * @param numberBits the number of bits
+ */
+static uint16_t __numberBitsToPointer(const uint8_t numberBits) {
+    return __pointerBytes(numberBits >> 3) | __pointerBits(numberBits & 0x07);
+}
+
+/**
+ * Copies the bytes received since the last call to the destination's transmission buffer and
+ * advances the transmission's data end pointer accordingly, but never beyond the package's
+ * second last bit. If the transmission caught up with the data end pointer it already stopped.
+ * @param relay the ongoing relay
+ * @param numberReceivedBytes the number of completely received bytes
+ */
+static void __cutThroughRelayReceivedBytes(CutThroughRelay *const relay, const uint8_t numberReceivedBytes) {
+    const RxPort *const rxPort = relay->source->rxPort;
+    TxPort *const txPort = relay->destination->txPort;
+    for (uint8_t byteNumber = relay->numberRelayedBytes; byteNumber < numberReceivedBytes; byteNumber++) {
+        txPort->buffer.bytes[byteNumber] = rxDecodingBuffer(rxPort)->bytes[byteNumber];
+    }
+    relay->numberRelayedBytes = numberReceivedBytes;
+
+    uint8_t numberBits = numberReceivedBytes * 8;
+    const uint8_t maxNumberBits = __pointerToNumberBits(relay->dataEndPointer) - 1;
+    if (numberBits > maxNumberBits) {
+        numberBits = maxNumberBits;
+    }
+    uint8_t sreg = SREG;
+    MEMORY_BARRIER;
+    CLI;
+    MEMORY_BARRIER;
+    setBufferDataEndPointer(&txPort->dataEndPos, __numberBitsToPointer(numberBits));
+    MEMORY_BARRIER;
+    SREG = sreg;
+    MEMORY_BARRIER;
 }
 
+/**
+ * Completes the relay of the package if it is being relayed to the same destination:
+ * copies the remaining bytes and releases the package's last bit for transmission.
+ * @param source reference to the package to relay
+ * @param destination reference to the destination port
+ * @param dataEndPointer the pointer marking the data end on buffer
+ * @return true if the relay is completed, false if the package needs to be relayed from scratch
+ */
+static bool __completeCutThroughRelay(const Package *const source,
+                                      const DirectionOrientedPort *const destination,
+                                      const uint16_t dataEndPointer) {
+    CutThroughRelay *const relay = &ParticleAttributes.protocol.cutThroughRelay;
+    if (!relay->isActive || (const void *) source != (const void *) relay->source->rxPort->buffer.bytes) {
+        return false;
+    }
+    relay->isActive = false;
+    if (relay->destination != destination || relay->dataEndPointer != dataEndPointer) {
+        return false;
+    }
+
+    TxPort *const txPort = destination->txPort;
+    __volatileSramBufferMemcopy(source, txPort->buffer.bytes);
+    bool isCompleted = false;
+    uint8_t sreg = SREG;
+    MEMORY_BARRIER;
+    CLI;
+    MEMORY_BARRIER;
+    // on underrun the transmission stopped early
+    if (txPort->isTransmitting) {
+        setBufferDataEndPointer(&txPort->dataEndPos, dataEndPointer);
+        isCompleted = true;
+    }
+    MEMORY_BARRIER;
+    SREG = sreg;
+    MEMORY_BARRIER;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    if (isCompleted) {
+        retainHopRetransmission(txPort);
+    }
+#endif
+    return isCompleted;
+}
+
+#endif
+
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+
+/**
+ * Evaluates the state after a sending state's transmission has finished.
+ * @param sendingState the sending state
+ */
+static StateType __sentPackageEndState(const StateType sendingState) {
+    switch (sendingState) {
+        case STATE_TYPE_SENDING_PACKAGE_TO_NORTH_THEN_PREPARE_SLEEP:
+        case STATE_TYPE_SENDING_PACKAGE_TO_EAST_THEN_PREPARE_SLEEP:
+        case STATE_TYPE_SENDING_PACKAGE_TO_EAST_AND_SOUTH_THEN_PREPARE_SLEEP:
+        case STATE_TYPE_SENDING_PACKAGE_TO_SOUTH_THEN_PREPARE_SLEEP:
+            return STATE_TYPE_PREPARE_FOR_SLEEP;
+        default:
+            return STATE_TYPE_IDLE;
+    }
+}
+
+#endif
+
 /**
  * Copies the buffer from the source port to destination port and prepares
- * but does not enable the transmission.
+ * but does not enable the transmission. If the package is being relayed while
+ * received, the ongoing relay is completed instead.
+ * With transmission frame queues the package is enqueued at the destination port instead and
+ * the node switches to the state following the sending state without waiting.
+ * With CRC-8 frame check the package is relayed including the received trailer, with error
+ * correction including the corrected error correction trailer of marked packages.
  * @param source reference to the package to relay
  * @param destination reference to the destination transmission port
  * @param dataEndPointer the pointer marking the data end on buffer
@@ -230,9 +429,37 @@ static void __relayPackage(const Package *const source,
                            const DirectionOrientedPort *const destination,
                            uint16_t dataEndPointer,
                            StateType endState) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    endState = __sentPackageEndState(endState);
+#endif
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    dataEndPointer += FrameCheckTrailerPointerSize;
+#endif
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    if (source->asHeader.parityBit) {
+        dataEndPointer += ErrorCorrectionTrailerPointerSize;
+    }
+#endif
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+    if (__completeCutThroughRelay(source, destination, dataEndPointer)) {
+        destination->protocol->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_WAIT_FOR_TX_FINISHED;
+        ParticleAttributes.node.state = endState;
+        return;
+    }
+#endif
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    // @pre the interpreter keeps received packages buffered on exhausted pool
+    TxFrame *const frame = acquireTxFrame();
+    if (frame != NULL) {
+        __volatileSramBufferMemcopy(source, frame->bytes);
+        frame->dataEndPointer = dataEndPointer;
+        enqueueTxFrame(destination, frame);
+    }
+    ParticleAttributes.node.state = endState;
+#else
     clearTransmissionPortBuffer(destination->txPort);
     setInitiatorStateStart(destination->protocol);
-    __volatileSram9ByteMemcopy(source, destination->txPort->buffer.bytes);
+    __volatileSramBufferMemcopy(source, destination->txPort->buffer.bytes);
     setBufferDataEndPointer(&destination->txPort->dataEndPos, dataEndPointer);
     ParticleAttributes.node.state = endState;
 
@@ -241,6 +468,7 @@ static void __relayPackage(const Package *const source,
     } else {
         ParticleAttributes.protocol.isSimultaneousTransmissionEnabled = false;
     }
+#endif
 }
 
 
@@ -402,6 +630,30 @@ static void __scheduleHeatWiresCommand(const Package *const package) {
     }
 }
 
+/**
+ * Evaluates to true if the heat wires package reached its destination and is to be consumed.
+ * @param package the package to evaluate
+ */
+static bool __isHeatWiresPackageConsumed(const HeatWiresPackage *const package) {
+    return ParticleAttributes.node.address.row == package->addressRow &&
+           ParticleAttributes.node.address.column == package->addressColumn &&
+           ParticleAttributes.actuationCommand.executionState == ACTUATION_STATE_TYPE_IDLE;
+}
+
+/**
+ * Routes a heat wires package. Reads the header and address fields only.
+ * @param package the package to route
+ * @return the port to forward the package to or NULL
+ */
+static const DirectionOrientedPort *__routeHeatWiresPackage(const HeatWiresPackage *const package) {
+    if (ParticleAttributes.node.address.column < package->addressColumn) {
+        return &ParticleAttributes.directionOrientedPorts.east;
+    } else if (ParticleAttributes.node.address.column == package->addressColumn) {
+        return &ParticleAttributes.directionOrientedPorts.south;
+    }
+    return NULL;
+}
+
 /**
  * Forward/route package and execute a heat wires package.
  * Forwarding is skipped in broadcast mode.
@@ -409,21 +661,17 @@ static void __scheduleHeatWiresCommand(const Package *const package) {
  * @param package the package to interpret and execute
  */
 void executeHeatWiresPackage(const HeatWiresPackage *const package) {
-    if (ParticleAttributes.node.address.row == package->addressRow &&
-        ParticleAttributes.node.address.column == package->addressColumn &&
-        ParticleAttributes.actuationCommand.executionState == ACTUATION_STATE_TYPE_IDLE) {
+    if (__isHeatWiresPackageConsumed(package)) {
         // on package reached destination: consume package
         __scheduleHeatWiresCommand((Package *) package);
         return;
     }
 
-    bool routeToEast = false, routeToSouth = false, inferLocalCommand = false;
     // on package forwarding
-    if (ParticleAttributes.node.address.column < package->addressColumn) {
-        routeToEast = true;
-    } else if (ParticleAttributes.node.address.column == package->addressColumn) {
-        routeToSouth = true;
-    }
+    const DirectionOrientedPort *const destination = __routeHeatWiresPackage(package);
+    const bool routeToEast = destination == &ParticleAttributes.directionOrientedPorts.east;
+    const bool routeToSouth = destination == &ParticleAttributes.directionOrientedPorts.south;
+    bool inferLocalCommand = false;
 
     if ((ParticleAttributes.node.address.row + 1 == package->addressRow &&
          ParticleAttributes.node.address.column == package->addressColumn) ||
@@ -459,23 +707,15 @@ void executeHeatWiresPackage(const HeatWiresPackage *const package) {
 }
 
 /**
- * Forward/route package and execute a heat wires range package.
- * Forwarding is skipped in broadcast mode.
- * Performs simultaneous transmission on splitting points.
- * @param package the package to interpret and execute
+ * Routes a heat wires range package. Reads the header and address fields only.
+ * @param package the package to route
+ * @return the port to forward the package to or NULL
  */
-void executeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
-    NodeAddress nodeAddressTopLeft;
-    NodeAddress nodeAddressBottomRight;
-    nodeAddressTopLeft.row = package->addressRow0;
-    nodeAddressTopLeft.column = package->addressColumn0;
-    nodeAddressBottomRight.row = package->addressRow1;
-    nodeAddressBottomRight.column = package->addressColumn1;
-
+static const DirectionOrientedPort *__routeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
     // route to east if
     // i) current node's address column is less than node range bottom right column
     bool routeToEast = false;
-    if (ParticleAttributes.node.address.column < nodeAddressBottomRight.column &&
+    if (ParticleAttributes.node.address.column < package->addressColumn1 &&
         ParticleAttributes.directionOrientedPorts.east.discoveryPulseCounter->isConnected) {
         routeToEast = true;
     }
@@ -484,13 +724,39 @@ void executeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
     // i) current node's column is within node range columns boundary and
     // ii) current node's row is less than node range bottom right row
     bool routeToSouth = false;
-    if ((nodeAddressTopLeft.column <= ParticleAttributes.node.address.column &&
-         ParticleAttributes.node.address.column <= nodeAddressBottomRight.column) &&
-        ParticleAttributes.node.address.row < nodeAddressBottomRight.row &&
+    if ((package->addressColumn0 <= ParticleAttributes.node.address.column &&
+         ParticleAttributes.node.address.column <= package->addressColumn1) &&
+        ParticleAttributes.node.address.row < package->addressRow1 &&
         ParticleAttributes.directionOrientedPorts.south.discoveryPulseCounter->isConnected) {
         routeToSouth = true;
     }
 
+    if (routeToEast && routeToSouth) {
+        return &ParticleAttributes.directionOrientedPorts.simultaneous;
+    } else if (routeToEast) {
+        return &ParticleAttributes.directionOrientedPorts.east;
+    } else if (routeToSouth) {
+        return &ParticleAttributes.directionOrientedPorts.south;
+    }
+    return NULL;
+}
+
+/**
+ * Forward/route package and execute a heat wires range package.
+ * Forwarding is skipped in broadcast mode.
+ * Performs simultaneous transmission on splitting points.
+ * @param package the package to interpret and execute
+ */
+void executeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
+    NodeAddress nodeAddressTopLeft;
+    NodeAddress nodeAddressBottomRight;
+    nodeAddressTopLeft.row = package->addressRow0;
+    nodeAddressTopLeft.column = package->addressColumn0;
+    nodeAddressBottomRight.row = package->addressRow1;
+    nodeAddressBottomRight.column = package->addressColumn1;
+
+    const DirectionOrientedPort *const destination = __routeHeatWiresRangePackage(package);
+
     // a) infer local command if
     // i) the current node address is within the node range or
     // ii) belongs to the row above and is within the range columns boundary
@@ -509,7 +775,7 @@ void executeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
         inferLocalCommand = true;
     }
 
-    if (routeToEast && routeToSouth) {
+    if (destination == &ParticleAttributes.directionOrientedPorts.simultaneous) {
         if (!ParticleAttributes.protocol.isBroadcastEnabled) {
             __relayPackage((Package *) package,
                            &ParticleAttributes.directionOrientedPorts.simultaneous,
@@ -520,7 +786,7 @@ void executeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
             __inferEastActuatorCommand((Package *) package);
             __inferSouthActuatorCommand((Package *) package);
         }
-    } else if (routeToEast) {
+    } else if (destination == &ParticleAttributes.directionOrientedPorts.east) {
         if (!ParticleAttributes.protocol.isBroadcastEnabled) {
             __relayPackage((Package *) package, &ParticleAttributes.directionOrientedPorts.east,
                            HeatWiresRangePackageBufferPointerSize,
@@ -529,7 +795,7 @@ void executeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
         if (inferLocalCommand) {
             __inferEastActuatorCommand((Package *) package);
         }
-    } else if (routeToSouth) {
+    } else if (destination == &ParticleAttributes.directionOrientedPorts.south) {
         if (!ParticleAttributes.protocol.isBroadcastEnabled) {
             __relayPackage((Package *) package,
                            &ParticleAttributes.directionOrientedPorts.south,
@@ -551,6 +817,24 @@ void executeHeatWiresRangePackage(const HeatWiresRangePackage *const package) {
 
 }
 
+/**
+ * Routes a header package to all connected ports.
+ * @return the port to forward the package to or NULL
+ */
+static const DirectionOrientedPort *__routeHeaderPackage(void) {
+    bool routeToEast = ParticleAttributes.discoveryPulseCounters.east.isConnected;
+    bool routeToSouth = ParticleAttributes.discoveryPulseCounters.south.isConnected;
+
+    if (routeToEast && routeToSouth) {
+        return &ParticleAttributes.directionOrientedPorts.simultaneous;
+    } else if (routeToEast) {
+        return &ParticleAttributes.directionOrientedPorts.east;
+    } else if (routeToSouth) {
+        return &ParticleAttributes.directionOrientedPorts.south;
+    }
+    return NULL;
+}
+
 /**
  * Forwards a header package to all connected ports and interpret the relevant content.
  * Forwarding is skipped in broadcast mode.
@@ -561,17 +845,16 @@ void executeHeaderPackage(const HeaderPackage *const package) {
 
     if (!ParticleAttributes.protocol.isBroadcastEnabled) {
         // on disabled broadcast: relay package
-        bool routeToEast = ParticleAttributes.discoveryPulseCounters.east.isConnected;
-        bool routeToSouth = ParticleAttributes.discoveryPulseCounters.south.isConnected;
+        const DirectionOrientedPort *const destination = __routeHeaderPackage();
 
-        if (routeToEast && routeToSouth) {
-            __relayPackage((Package *) package, &ParticleAttributes.directionOrientedPorts.simultaneous,
+        if (destination == &ParticleAttributes.directionOrientedPorts.simultaneous) {
+            __relayPackage((Package *) package, destination,
                            HeaderPackagePointerSize, STATE_TYPE_SENDING_PACKAGE_TO_EAST_AND_SOUTH);
-        } else if (routeToEast) {
-            __relayPackage((Package *) package, &ParticleAttributes.directionOrientedPorts.east,
+        } else if (destination == &ParticleAttributes.directionOrientedPorts.east) {
+            __relayPackage((Package *) package, destination,
                            HeaderPackagePointerSize, STATE_TYPE_SENDING_PACKAGE_TO_EAST);
-        } else if (routeToSouth) {
-            __relayPackage((Package *) package, &ParticleAttributes.directionOrientedPorts.south,
+        } else if (destination == &ParticleAttributes.directionOrientedPorts.south) {
+            __relayPackage((Package *) package, destination,
                            HeaderPackagePointerSize, STATE_TYPE_SENDING_PACKAGE_TO_SOUTH);
         }
     }
@@ -594,15 +877,15 @@ void executeHeatWiresModePackage(const HeatWiresModePackage *const package) {
 
         if (routeToEast && routeToSouth) {
             __relayPackage((Package *) package, &ParticleAttributes.directionOrientedPorts.simultaneous,
-                           SetNetworkGeometryPackageBufferPointerSize,
+                           HeatWiresModePackageBufferPointerSize,
                            STATE_TYPE_SENDING_PACKAGE_TO_EAST_AND_SOUTH);
         } else if (routeToEast) {
             __relayPackage((Package *) package, &ParticleAttributes.directionOrientedPorts.east,
-                           SetNetworkGeometryPackageBufferPointerSize,
+                           HeatWiresModePackageBufferPointerSize,
                            STATE_TYPE_SENDING_PACKAGE_TO_EAST);
         } else if (routeToSouth) {
             __relayPackage((Package *) package, &ParticleAttributes.directionOrientedPorts.south,
-                           SetNetworkGeometryPackageBufferPointerSize,
+                           HeatWiresModePackageBufferPointerSize,
                            STATE_TYPE_SENDING_PACKAGE_TO_SOUTH);
         }
     }
@@ -610,3 +893,347 @@ void executeHeatWiresModePackage(const HeatWiresModePackage *const package) {
     ParticleAttributes.protocol.isBroadcastEnabled = package->header.enableBroadcast;
     ParticleAttributes.actuationCommand.actuationPower.dutyCycleLevel = package->heatMode;
 }
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+/**
+ * Routes a fragment package. Reads the header and address fields only.
+ * @param package the package to route
+ * @return the port to forward the package to or NULL
+ */
+static const DirectionOrientedPort *__routeFragmentPackage(const FragmentPackage *const package) {
+    if (ParticleAttributes.node.address.column < package->addressColumn) {
+        return &ParticleAttributes.directionOrientedPorts.east;
+    } else if (ParticleAttributes.node.address.column == package->addressColumn) {
+        return &ParticleAttributes.directionOrientedPorts.south;
+    }
+    return NULL;
+}
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+
+/**
+ * Builds a heat wires package from a heat wires batch entry.
+ * @param entry the entry to read
+ * @param package the package to build
+ */
+static void __heatWiresPackageFromBatchEntry(const HeatWiresBatchEntry *const entry,
+                                             HeatWiresPackage *const package) {
+    package->header.startBit = 1;
+    package->header.id = PACKAGE_HEADER_ID_TYPE_HEAT_WIRES;
+    package->header.isRangeCommand = false;
+    package->header.parityBit = 0;
+    package->header.enableBroadcast = false;
+    package->addressRow = entry->addressRow;
+    package->addressColumn = entry->addressColumn;
+    package->startTimeStamp = entry->startTimeStamp;
+    package->durationLsb = entry->durationLsb;
+    package->durationMsb = entry->durationMsb;
+    package->northLeft = entry->northLeft;
+    package->northRight = entry->northRight;
+    package->__pad = 0;
+}
+
+static void __swapHeatWiresBatchEntries(HeatWiresBatchEntry *const a, HeatWiresBatchEntry *const b) {
+    const HeatWiresBatchEntry temporary = *a;
+    *a = *b;
+    *b = temporary;
+}
+
+/**
+ * Executes a complete heat wires batch: schedules the entry addressed to this node and splits the
+ * remaining entries in place into the east bound entries followed by the south bound ones.
+ * Entries not route-able from this node on are dropped. Like on heat wires packages, the command
+ * of the east or south actuator is inferred if an entry addresses the adjacent neighbour.
+ * The sub-lists are forwarded by {@link relayHeatWiresTransfer()}.
+ * @param reassembly the reassembly buffering the batch
+ */
+void executeHeatWiresBatch(FragmentReassembly *const reassembly) {
+    HeatWiresTransferRelay *const relay = &ParticleAttributes.protocol.heatWiresTransferRelay;
+    HeatWiresBatchEntry *const entries = (HeatWiresBatchEntry *) reassembly->bytes;
+    uint8_t numberEntries = reassembly->numberBytes / sizeof(HeatWiresBatchEntry);
+    uint8_t numberEastEntries = 0;
+    uint8_t idx = 0;
+
+    while (idx < numberEntries) {
+        HeatWiresPackage package;
+        __heatWiresPackageFromBatchEntry(&entries[idx], &package);
+        const DirectionOrientedPort *const destination = __routeHeatWiresPackage(&package);
+
+        if (ParticleAttributes.node.address.row == package.addressRow &&
+            ParticleAttributes.node.address.column == package.addressColumn) {
+            // on entry reached destination: consume entry
+            if (__isHeatWiresPackageConsumed(&package)) {
+                __scheduleHeatWiresCommand((Package *) &package);
+            }
+            entries[idx] = entries[--numberEntries];
+        } else if (destination == &ParticleAttributes.directionOrientedPorts.east) {
+            if (ParticleAttributes.node.address.row == package.addressRow &&
+                ParticleAttributes.node.address.column + 1 == package.addressColumn) {
+                __inferEastActuatorCommand((Package *) &package);
+            }
+            __swapHeatWiresBatchEntries(&entries[idx], &entries[numberEastEntries]);
+            numberEastEntries++;
+            idx++;
+        } else if (destination == &ParticleAttributes.directionOrientedPorts.south) {
+            if (ParticleAttributes.node.address.row + 1 == package.addressRow &&
+                ParticleAttributes.node.address.column == package.addressColumn) {
+                __inferSouthActuatorCommand((Package *) &package);
+            }
+            idx++;
+        } else {
+            // on not route-able entry
+            entries[idx] = entries[--numberEntries];
+        }
+    }
+
+    reassembly->numberBytes = numberEntries * sizeof(HeatWiresBatchEntry);
+    relay->numberEastBytes = numberEastEntries * sizeof(HeatWiresBatchEntry);
+    relay->southBytesOffset = relay->numberEastBytes;
+    relay->numberSouthBytes = reassembly->numberBytes - relay->numberEastBytes;
+    relay->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_BATCH;
+    relay->isEastPending = relay->numberEastBytes != 0;
+    relay->isSouthPending = relay->numberSouthBytes != 0;
+    relay->isActive = true;
+}
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_MULTICAST
+
+/**
+ * Executes a complete heat wires multicast: schedules the command if this node's bit is set and
+ * infers the command of the east or south actuator if the adjacent neighbour's bit is set.
+ * The multicast is forwarded unchanged by {@link relayHeatWiresTransfer()} to the south neighbour
+ * if a bit of the nodes below is set, and from the 1st row on to the east neighbour if a bit of
+ * the columns to the east is set. Thus subtrees without addressed nodes are pruned.
+ * @param reassembly the reassembly buffering the multicast
+ */
+void executeHeatWiresMulticast(FragmentReassembly *const reassembly) {
+    HeatWiresTransferRelay *const relay = &ParticleAttributes.protocol.heatWiresTransferRelay;
+    const HeatWiresMulticastHeader *const header = (const HeatWiresMulticastHeader *) reassembly->bytes;
+    const uint8_t *const runs = &reassembly->bytes[sizeof(HeatWiresMulticastHeader)];
+    const uint8_t numberRuns = reassembly->numberBytes - sizeof(HeatWiresMulticastHeader);
+    const uint8_t row = ParticleAttributes.node.address.row;
+    const uint8_t column = ParticleAttributes.node.address.column;
+
+    relay->numberEastBytes = 0;
+    relay->southBytesOffset = 0;
+    relay->numberSouthBytes = 0;
+    relay->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_MULTICAST;
+    relay->isEastPending = false;
+    relay->isSouthPending = false;
+    relay->isActive = true;
+
+    if (reassembly->numberBytes < sizeof(HeatWiresMulticastHeader) ||
+        row == 0 || column == 0 || row > header->rows || column > header->columns) {
+        // on malformed multicast or node outside the bitmap
+        return;
+    }
+
+    HeatWiresPackage package;
+    package.header.startBit = 1;
+    package.header.id = PACKAGE_HEADER_ID_TYPE_HEAT_WIRES;
+    package.header.isRangeCommand = false;
+    package.header.parityBit = 0;
+    package.header.enableBroadcast = false;
+    package.addressRow = row;
+    package.addressColumn = column;
+    package.startTimeStamp = header->startTimeStamp;
+    package.durationLsb = header->durationLsb;
+    package.durationMsb = header->durationMsb;
+    package.northLeft = header->northLeft;
+    package.northRight = header->northRight;
+    package.__pad = 0;
+
+    const uint16_t bitIndex = (uint16_t) (column - 1) * header->rows + (row - 1);
+    const uint16_t nextColumnBitIndex = (uint16_t) column * header->rows;
+    if (isHeatWiresMulticastBitSet(runs, numberRuns, bitIndex, bitIndex + 1) &&
+        __isHeatWiresPackageConsumed(&package)) {
+        __scheduleHeatWiresCommand((Package *) &package);
+    }
+    if (column < header->columns &&
+        isHeatWiresMulticastBitSet(runs, numberRuns, bitIndex + header->rows, bitIndex + header->rows + 1)) {
+        __inferEastActuatorCommand((Package *) &package);
+    }
+    if (row < header->rows && isHeatWiresMulticastBitSet(runs, numberRuns, bitIndex + 1, bitIndex + 2)) {
+        __inferSouthActuatorCommand((Package *) &package);
+    }
+
+    if (row == 1 && isHeatWiresMulticastBitSet(runs, numberRuns, nextColumnBitIndex,
+                                               (uint16_t) header->columns * header->rows)) {
+        relay->numberEastBytes = reassembly->numberBytes;
+        relay->isEastPending = true;
+    }
+    if (isHeatWiresMulticastBitSet(runs, numberRuns, bitIndex + 1, nextColumnBitIndex)) {
+        relay->numberSouthBytes = reassembly->numberBytes;
+        relay->isSouthPending = true;
+    }
+}
+
+#endif
+
+/**
+ * Forward/route a fragment package or reassemble it if it reached its destination.
+ * A completed heat wires batch or multicast is executed, see {@link executeHeatWiresBatch()} and
+ * {@link executeHeatWiresMulticast()}.
+ * Forwarding is skipped in broadcast mode.
+ * @param package the package to interpret and execute
+ * @param numberPayloadBytes the fragment's number of payload bytes
+ */
+void executeFragmentPackage(const FragmentPackage *const package, const uint8_t numberPayloadBytes) {
+    if (ParticleAttributes.node.address.row == package->addressRow &&
+        ParticleAttributes.node.address.column == package->addressColumn) {
+        // on package reached destination: consume package
+        FragmentReassembly *const reassembly = &ParticleAttributes.protocol.fragmentReassembly;
+        if (reassembleFragment(package, numberPayloadBytes)) {
+            switch (reassembly->contentType) {
+                case FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION:
+                    break;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+                case FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_BATCH:
+                    executeHeatWiresBatch(reassembly);
+                    break;
+#endif
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_MULTICAST
+                case FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_MULTICAST:
+                    executeHeatWiresMulticast(reassembly);
+                    break;
+#endif
+                default:
+                    // on unsupported content
+                    releaseFragmentedTransfer();
+                    break;
+            }
+        }
+        return;
+    }
+
+    // on package forwarding
+    const DirectionOrientedPort *const destination = __routeFragmentPackage(package);
+    if (destination == NULL || ParticleAttributes.protocol.isBroadcastEnabled) {
+        return;
+    }
+    __relayPackage((Package *) package, destination,
+                   FragmentPackageBufferPointerSize(numberPayloadBytes),
+                   (destination == &ParticleAttributes.directionOrientedPorts.east) ?
+                   STATE_TYPE_SENDING_PACKAGE_TO_EAST : STATE_TYPE_SENDING_PACKAGE_TO_SOUTH);
+}
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+
+/**
+ * Relays heat wires, heat wires range and header packages while they are received. Once the
+ * bytes needed for routing are decoded, the same routing as on package execution decides the
+ * destination and the transmission starts. Subsequent calls forward the bytes received meanwhile.
+ * The relay is completed by the package's execution after the frame check, otherwise aborted.
+ * With CRC-8 frame check the received trailer is relayed too. With error correction packages
+ * marked for correction are not relayed while received but corrected and stored before.
+ * Called after each decoding of the respective port.
+ * @param port the port the package is received at
+ */
+void handleCutThroughRelay(const DirectionOrientedPort *const port) {
+    CutThroughRelay *const relay = &ParticleAttributes.protocol.cutThroughRelay;
+    const RxPort *const rxPort = port->rxPort;
+    const uint8_t numberReceivedBytes = rxDecodingBuffer(rxPort)->pointer.byteNumber;
+
+    if (relay->isActive) {
+        if (relay->source == port && numberReceivedBytes > relay->numberRelayedBytes) {
+            __cutThroughRelayReceivedBytes(relay, numberReceivedBytes);
+        }
+        return;
+    }
+
+    if (numberReceivedBytes == 0 ||
+        rxPort->isDataBuffered ||
+        rxPort->snapshotsBuffer.decoderStates.decodingState != DECODER_STATE_TYPE_DECODING ||
+        ParticleAttributes.node.state != STATE_TYPE_IDLE ||
+        ParticleAttributes.protocol.isBroadcastEnabled ||
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+        hasPendingTxFrames() ||
+#endif
+        ParticleAttributes.communication.ports.tx.north.isTransmitting ||
+        ParticleAttributes.communication.ports.tx.east.isTransmitting ||
+        ParticleAttributes.communication.ports.tx.south.isTransmitting) {
+        return;
+    }
+
+    const Package *const package = (const Package *) rxDecodingBuffer(rxPort)->bytes;
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    if (package->asHeader.parityBit) {
+        return;
+    }
+#endif
+    const DirectionOrientedPort *destination = NULL;
+    uint16_t dataEndPointer = 0;
+    switch (package->asHeader.id) {
+        case PACKAGE_HEADER_ID_TYPE_HEAT_WIRES:
+            if (package->asHeader.isRangeCommand) {
+                if (numberReceivedBytes >= __CUT_THROUGH_RELAY_HEAT_WIRES_RANGE_ROUTING_BYTES) {
+                    destination = __routeHeatWiresRangePackage(&package->asHeatWiresRangePackage);
+                    dataEndPointer = HeatWiresRangePackageBufferPointerSize;
+                }
+            } else {
+                if (numberReceivedBytes >= __CUT_THROUGH_RELAY_HEAT_WIRES_ROUTING_BYTES &&
+                    !__isHeatWiresPackageConsumed(&package->asHeatWiresPackage)) {
+                    destination = __routeHeatWiresPackage(&package->asHeatWiresPackage);
+                    dataEndPointer = HeatWiresPackageBufferPointerSize;
+                }
+            }
+            break;
+
+        case PACKAGE_HEADER_ID_HEADER:
+            if (numberReceivedBytes >= __CUT_THROUGH_RELAY_HEADER_ROUTING_BYTES) {
+                destination = __routeHeaderPackage();
+                dataEndPointer = HeaderPackagePointerSize;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if (destination == NULL) {
+        return;
+    }
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    dataEndPointer += FrameCheckTrailerPointerSize;
+#endif
+
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+    // a faster outgoing link would outrun the reception
+    if (destination->linkRate->clockDelayShift > rxPort->snapshotsBuffer.decoderStates.clockDelayShift) {
+        return;
+    }
+#endif
+
+    DEBUG_CHAR_OUT('>');
+    relay->source = port;
+    relay->destination = destination;
+    relay->dataEndPointer = dataEndPointer;
+    relay->numberRelayedBytes = 0;
+    relay->isActive = true;
+    clearTransmissionPortBuffer(destination->txPort);
+    ParticleAttributes.protocol.isSimultaneousTransmissionEnabled =
+            (destination == &ParticleAttributes.directionOrientedPorts.simultaneous);
+    __cutThroughRelayReceivedBytes(relay, numberReceivedBytes);
+    enableTransmission(destination->txPort);
+}
+
+/**
+ * Aborts the relay of a package received at the given port which has not been completed on
+ * execution, i.e. on frame check error or wrong package size. The transmission stops at the held back
+ * last bit, thus the receiver discards the truncated package.
+ * @param port the port the package has been received at
+ */
+void abortCutThroughRelay(const DirectionOrientedPort *const port) {
+    CutThroughRelay *const relay = &ParticleAttributes.protocol.cutThroughRelay;
+    if (relay->isActive && relay->source == port) {
+        DEBUG_CHAR_OUT('<');
+        relay->isActive = false;
+    }
+}
+
+#endif
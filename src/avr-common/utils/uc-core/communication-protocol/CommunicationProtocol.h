@@ -58,13 +58,41 @@ void clearReceptionPortBuffer(RxPort *const o) {
     DEBUG_CHAR_OUT('c');
 }
 
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+
+/**
+ * Returns the retransmission state of the package last transmitted on the given port.
+ * @param txPort the transmission port
+ * @return the state or NULL if the port is no transmission port, i.e. a temporary package buffer
+ */
+HopRetransmission *hopRetransmission(const TxPort *const txPort) {
+    if (txPort == &ParticleAttributes.communication.ports.tx.north) {
+        return &ParticleAttributes.protocol.ports.north.hopRetransmission;
+    } else if (txPort == &ParticleAttributes.communication.ports.tx.east) {
+        return &ParticleAttributes.protocol.ports.east.hopRetransmission;
+    } else if (txPort == &ParticleAttributes.communication.ports.tx.south) {
+        return &ParticleAttributes.protocol.ports.south.hopRetransmission;
+    }
+    return NULL;
+}
+
+#endif
+
 /**
  * Prepares the given transmission port for buffering and later transmission.
+ * A package kept for hop retransmission is discarded.
  * @param o the port to prepare
  */
 void clearTransmissionPortBuffer(TxPort *const o) {
     o->isTransmitting = false;
+    o->isDefaultClockDelayForced = false;
     bufferBitPointerStart(&o->buffer.pointer);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    HopRetransmission *const retransmission = hopRetransmission(o);
+    if (retransmission != NULL) {
+        retransmission->isRetransmittable = false;
+    }
+#endif
 }
 
 /**
@@ -18,6 +18,18 @@
  */
 #define __pointerBits(numBits) (((uint16_t) 0x0100) << numBits)
 
+/**
+ * Length of the CRC-8 frame check trailer following a package, expressed as (uint16_t) BufferPointer
+ * increment, see COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+ */
+#define FrameCheckTrailerPointerSize __pointerBytes(1)
+
+/**
+ * Length of the error correction trailer following the CRC-8 trailer of selected packages,
+ * expressed as (uint16_t) BufferPointer increment, see COMMUNICATION_ENABLE_ERROR_CORRECTION
+ */
+#define ErrorCorrectionTrailerPointerSize __pointerBytes(1)
+
 /**
  * Describes possible header IDs. Note the enum values must not exceed uint8_t max.
  */
@@ -36,8 +48,8 @@ typedef enum PackageHeaderId {
     PACKAGE_HEADER_ID_TYPE_HEAT_WIRES = 10,
     PACKAGE_HEADER_ID_TYPE_HEAT_WIRES_MODE = 11,
     __UNUSED11 = 11,
-    __UNUSED12 = 12,
-    __UNUSED13 = 13,
+    PACKAGE_HEADER_ID_TYPE_LINK_RATE = 12,
+    PACKAGE_HEADER_ID_TYPE_NACK = 13,
     __UNUSED14 = 14,
     PACKAGE_HEADER_ID_TYPE_EXTENDED_HEADER = 15,
     __UNUSED00 = 0,
@@ -89,6 +101,16 @@ typedef HeaderPackage ResetPackage;
  */
 #define AckPackagePointerSize HeaderPackagePointerSize
 
+/**
+ * describes a negative acknowledge package: the neighbour's last package failed the frame check
+ */
+typedef HeaderPackage NackPackage;
+
+/**
+ * NackPackage data length expressed as (uint16_t) BufferPointer
+ */
+#define NackPackagePointerSize HeaderPackagePointerSize
+
 /**
  * describes an acknowledge package with subsequent address
  */
@@ -248,6 +270,109 @@ typedef struct HeatWiresModePackage {
  */
 #define HeatWiresModePackageBufferPointerSize (__pointerBytes(1) | __pointerBits(2))
 
+/**
+ * Bit pattern transmitted by link rate packages: mixes short and long intervals.
+ */
+#define LINK_RATE_PACKAGE_PATTERN ((uint16_t) 0x3c5a)
+
+/**
+ * describes a link rate probe and its response
+ */
+typedef struct LinkRatePackage {
+    HeaderPackage header;
+    /**
+     * the probed clock delay shift
+     */
+    uint8_t clockDelayShift : 2;
+    /**
+     * response only: true if the probes received so far at this shift are within budget
+     */
+    uint8_t isAccepted : 1;
+    uint8_t __pad : 5;
+    uint16_t pattern : 16;
+} LinkRatePackage;
+
+/**
+ * LinkRatePackage length expressed as (uint16_t) BufferPointer
+ */
+#define LinkRatePackageBufferPointerSize (__pointerBytes(4) | __pointerBits(0))
+
+/**
+ * Number of payload bytes carried by a fragment package.
+ */
+#define FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES 5
+
+/**
+ * Max. number of fragments per transfer as limited by the sequence number.
+ */
+#define FRAGMENT_PACKAGE_MAX_NUMBER_FRAGMENTS 16
+
+/**
+ * describes a fragment of a transfer to a node;
+ * the header's range command flag marks the fragments of a heat wires batch,
+ * the header's broadcast flag the fragments of a heat wires multicast
+ */
+typedef struct FragmentPackage {
+    HeaderPackage header;
+    uint8_t addressRow : 8;
+    uint8_t addressColumn : 8;
+    /**
+     * distinguishes consecutive transfers of the same origin
+     */
+    uint8_t transferId : 3;
+    /**
+     * the fragment's position in the transfer, starting with 0
+     */
+    uint8_t sequenceNumber : 4;
+    uint8_t isLastFragment : 1;
+    uint8_t payload[FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES];
+} FragmentPackage;
+
+/**
+ * FragmentPackage length expressed as (uint16_t) BufferPointer
+ * @param numberPayloadBytes the number of payload bytes ∈ [1, FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES]
+ */
+#define FragmentPackageBufferPointerSize(numberPayloadBytes) \
+    (__pointerBytes(4 + (numberPayloadBytes)) | __pointerBits(0))
+
+/**
+ * describes an entry of a heat wires batch, a list of heat wires commands transferred as
+ * fragmented transfer; the fields equal the heat wires package's fields without header
+ */
+typedef struct HeatWiresBatchEntry {
+    uint8_t addressRow : 8;
+    uint8_t addressColumn: 8;
+    uint16_t startTimeStamp : 16;
+    uint8_t durationLsb : 8;
+    uint8_t durationMsb : 2;
+    uint8_t northLeft : 1;
+    uint8_t northRight: 1;
+    uint8_t __pad: 4;
+} HeatWiresBatchEntry;
+
+/**
+ * describes the header of a heat wires multicast, a heat wires command for the set of nodes
+ * whose bits are set in the bitmap following the header; the bitmap is stored in column major
+ * order, thus the bit of node (row, column) has the index (column - 1) * rows + (row - 1),
+ * see also {@link encodeHeatWiresMulticastBitmap()}
+ */
+typedef struct HeatWiresMulticastHeader {
+    /**
+     * the bitmap's number of rows
+     */
+    uint8_t rows : 8;
+    /**
+     * the bitmap's number of columns
+     */
+    uint8_t columns : 8;
+    uint16_t startTimeStamp : 16;
+    uint8_t durationLsb : 8;
+    uint8_t durationMsb : 2;
+    uint8_t northLeft : 1;
+    uint8_t northRight: 1;
+    uint8_t __pad: 4;
+} HeatWiresMulticastHeader;
+
 /**
  * Union for a convenient way to access buffered packages.
  */
@@ -296,4 +421,12 @@ typedef union Package {
      * package transmitted to set up the heat wires mode/power
      */
     HeatWiresModePackage asHeatWiresModePackage;
+    /**
+     * package transmitted when negotiating the link rate
+     */
+    LinkRatePackage asLinkRatePackage;
+    /**
+     * package transmitted when transferring a payload exceeding a package
+     */
+    FragmentPackage asFragmentPackage;
 } Package;
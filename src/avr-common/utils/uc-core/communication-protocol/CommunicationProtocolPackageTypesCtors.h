@@ -9,7 +9,7 @@
 #include "./CommunicationProtocol.h"
 #include "./CommunicationProtocolPackageTypes.h"
 #include "uc-core/particle/Globals.h"
-#include "uc-core/parity/Parity.h"
+#include "uc-core/frame-check/FrameCheck.h"
 #include "uc-core/configuration/interrupts/LocalTime.h"
 
 /**
@@ -47,7 +47,7 @@ void constructEnumeratePackage(TxPort *const txPort,
     package->asEnumerationPackage.addressRow = localAddressRow;
     package->asEnumerationPackage.addressColumn = localAddressColumn;
     setBufferDataEndPointer(&txPort->dataEndPos, EnumerationPackageBufferPointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
 }
 
 /**
@@ -64,10 +64,26 @@ void constructEnumerationACKPackage(TxPort *const txPort) {
     package->asACKPackage.isRangeCommand = false;
 
     setBufferDataEndPointer(&txPort->dataEndPos, AckPackagePointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
 
 }
 
+/**
+ * Constructor function: builds the protocol package at the given port's buffer.
+ * @param txPort the port reference where to buffer the package at
+ */
+void constructNackPackage(TxPort *const txPort) {
+    clearTransmissionPortBuffer(txPort);
+    Package *package = (Package *) txPort->buffer.bytes;
+    package->asHeader.startBit = 1;
+    package->asHeader.id = PACKAGE_HEADER_ID_TYPE_NACK;
+    package->asHeader.isRangeCommand = false;
+    package->asHeader.enableBroadcast = false;
+
+    setBufferDataEndPointer(&txPort->dataEndPos, NackPackagePointerSize);
+    setFrameCheck(txPort);
+}
+
 /**
  * Constructor function: builds the protocol package at north port's buffer.
  */
@@ -82,9 +98,37 @@ void constructEnumerationACKWithAddressToParentPackage(void) {
 
     setBufferDataEndPointer(&ParticleAttributes.communication.ports.tx.north.dataEndPos,
                             AckWithAddressPackageBufferPointerSize);
-    setEvenParityBit(&ParticleAttributes.communication.ports.tx.north);
+    setFrameCheck(&ParticleAttributes.communication.ports.tx.north);
 }
 
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+
+/**
+ * The synchronization measures the time package up to its last bit, which must be cleared.
+ * With CRC-8 frame check the last bit is the trailer's most significant bit, thus stuffing bits
+ * are flipped until the CRC's most significant bit is cleared.
+ * @param package the time package, all fields but the stuffing must be set up
+ */
+static void __clearTimePackageFrameCheckEndBit(TimePackage *const package) {
+    const uint8_t lastByte = (TimePackageBufferPointerSize & 0x000f) - 1;
+    package->header.parityBit = 0;
+    BufferBitPointer lastByteStart;
+    lastByteStart.byteNumber = lastByte;
+    lastByteStart.__pad = 0;
+    lastByteStart.bitMask = 1;
+    const FrameCheckType frameCheck = computeFrameCheck((const uint8_t *) package, &lastByteStart);
+
+    const uint8_t stuffing = package->stuffing;
+    uint8_t flip = 1;
+    while ((crc8UpdateByte(frameCheck, ((const uint8_t *) package)[lastByte]) & 0x80) && flip < (1 << 6)) {
+        // on set end bit: flip the next stuffing bit instead
+        package->stuffing = stuffing ^ flip;
+        flip <<= 1;
+    }
+}
+
+#endif
+
 /**
  * Constructor function: builds the protocol package at the given port's buffer.
  * @param txPort the port reference where to buffer the package at
@@ -92,6 +136,8 @@ void constructEnumerationACKWithAddressToParentPackage(void) {
 //void constructSyncTimePackage(TxPort *const txPort) {
 void constructSyncTimePackage(TxPort *const txPort, bool forceTimePeriodUpdate) {
     clearTransmissionPortBuffer(txPort);
+    // the reception duration is measured for synchronization
+    txPort->isDefaultClockDelayForced = true;
     Package *package = (Package *) txPort->buffer.bytes;
     package->asSyncTimePackage.header.startBit = 1;
     package->asSyncTimePackage.header.id = PACKAGE_HEADER_ID_TYPE_SYNC_TIME;
@@ -127,10 +173,13 @@ void constructSyncTimePackage(TxPort *const txPort, bool forceTimePeriodUpdate)
     package->asSyncTimePackage.forceTimePeriodUpdate = forceTimePeriodUpdate;
     package->asSyncTimePackage.stuffing = 42;
     package->asSyncTimePackage.endBit = 0; // Must be UNset, do not change!
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    __clearTimePackageFrameCheckEndBit(&package->asSyncTimePackage);
+#endif
     // for evaluation purpose
 
     setBufferDataEndPointer(&txPort->dataEndPos, TimePackageBufferPointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
     // DEBUG_INT16_OUT(TIMER_TX_RX_COUNTER_VALUE);
 }
 
@@ -152,7 +201,7 @@ void constructAnnounceNetworkGeometryPackage(uint8_t row, uint8_t column) {
 
     setBufferDataEndPointer(&ParticleAttributes.communication.ports.tx.north.dataEndPos,
                             AnnounceNetworkGeometryPackageBufferPointerSize);
-    setEvenParityBit(&ParticleAttributes.communication.ports.tx.north);
+    setFrameCheck(&ParticleAttributes.communication.ports.tx.north);
 }
 
 
@@ -175,7 +224,7 @@ void constructSetNetworkGeometryPackage(TxPort *const txPort, const uint8_t rows
     package->asSetNetworkGeometryPackage.columns = columns;
 
     setBufferDataEndPointer(&txPort->dataEndPos, SetNetworkGeometryPackageBufferPointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
 }
 
 /**
@@ -208,7 +257,7 @@ void constructHeatWiresPackage(TxPort *const txPort,
     package->asHeatWiresPackage.northRight = wires->northRight;
 
     setBufferDataEndPointer(&txPort->dataEndPos, HeatWiresPackageBufferPointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
 }
 
 /**
@@ -244,23 +293,25 @@ void constructHeatWiresRangePackage(TxPort *const txPort,
     package->asHeatWiresRangePackage.northRight = wires->northRight;
 
     setBufferDataEndPointer(&txPort->dataEndPos, HeatWiresRangePackageBufferPointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
 }
 
 /**
  * Constructor function: builds the protocol package at the given port's buffer.
  * @param txPort the port reference where to buffer the package at
+ * @param id the package's header id
+ * @param enableBroadcast whether the receivers switch to broadcast mode
  */
-void constructHeaderPackage(TxPort *const txPort) {
+void constructHeaderPackage(TxPort *const txPort, const uint8_t id, const bool enableBroadcast) {
     clearTransmissionPortBuffer(txPort);
     Package *package = (Package *) txPort->buffer.bytes;
     package->asHeader.startBit = 1;
-    package->asHeader.id = PACKAGE_HEADER_ID_HEADER;
+    package->asHeader.id = id;
     package->asHeader.isRangeCommand = false;
-    package->asHeader.enableBroadcast = false;
+    package->asHeader.enableBroadcast = enableBroadcast;
 
     setBufferDataEndPointer(&txPort->dataEndPos, HeaderPackagePointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
 }
 
 /**
@@ -278,5 +329,121 @@ void constructHeatWiresModePackage(TxPort *const txPort,
     package->asHeatWiresModePackage.heatMode = heatingPowerLevel;
 
     setBufferDataEndPointer(&txPort->dataEndPos, HeatWiresModePackageBufferPointerSize);
-    setEvenParityBit(txPort);
+    setFrameCheck(txPort);
+}
+
+/**
+ * Constructor function: builds the protocol package at the given port's buffer.
+ * @param txPort the port reference where to buffer the package at
+ * @param clockDelayShift the probed clock delay shift
+ * @param isAccepted the receptionist's probe evaluation, false for probes
+ */
+void constructLinkRatePackage(TxPort *const txPort, const uint8_t clockDelayShift, const bool isAccepted) {
+    clearTransmissionPortBuffer(txPort);
+    Package *package = (Package *) txPort->buffer.bytes;
+    package->asLinkRatePackage.header.startBit = 1;
+    package->asLinkRatePackage.header.id = PACKAGE_HEADER_ID_TYPE_LINK_RATE;
+    package->asLinkRatePackage.header.isRangeCommand = false;
+    package->asLinkRatePackage.header.enableBroadcast = false;
+    package->asLinkRatePackage.clockDelayShift = clockDelayShift;
+    package->asLinkRatePackage.isAccepted = isAccepted;
+    package->asLinkRatePackage.__pad = 0;
+    package->asLinkRatePackage.pattern = LINK_RATE_PACKAGE_PATTERN;
+
+    setBufferDataEndPointer(&txPort->dataEndPos, LinkRatePackageBufferPointerSize);
+    setFrameCheck(txPort);
+}
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+/**
+ * Constructor function: builds the protocol package at the given port's buffer.
+ * @param txPort the port reference where to buffer the package at
+ * @param address the destination node address
+ * @param transferId the transfer's id
+ * @param sequenceNumber the fragment's position in the transfer
+ * @param isLastFragment true if the fragment completes the transfer
+ * @param contentType the transfer's content, see {@link FragmentedTransferContentType}
+ * @param payload the fragment's payload
+ * @param numberPayloadBytes the number of payload bytes ∈ [1, FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES]
+ */
+void constructFragmentPackage(TxPort *const txPort,
+                              const NodeAddress *const address,
+                              const uint8_t transferId,
+                              const uint8_t sequenceNumber,
+                              const bool isLastFragment,
+                              const FragmentedTransferContentType contentType,
+                              const uint8_t *const payload,
+                              const uint8_t numberPayloadBytes) {
+    clearTransmissionPortBuffer(txPort);
+    Package *package = (Package *) txPort->buffer.bytes;
+    package->asFragmentPackage.header.startBit = 1;
+    package->asFragmentPackage.header.id = PACKAGE_HEADER_ID_TYPE_EXTENDED_HEADER;
+    package->asFragmentPackage.header.isRangeCommand =
+            contentType == FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_BATCH;
+    package->asFragmentPackage.header.enableBroadcast =
+            contentType == FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_MULTICAST;
+    package->asFragmentPackage.addressRow = address->row;
+    package->asFragmentPackage.addressColumn = address->column;
+    package->asFragmentPackage.transferId = transferId;
+    package->asFragmentPackage.sequenceNumber = sequenceNumber;
+    package->asFragmentPackage.isLastFragment = isLastFragment;
+    for (uint8_t idx = 0; idx < numberPayloadBytes; idx++) {
+        package->asFragmentPackage.payload[idx] = payload[idx];
+    }
+
+    setBufferDataEndPointer(&txPort->dataEndPos, FragmentPackageBufferPointerSize(numberPayloadBytes));
+    setFrameCheck(txPort);
+}
+
+#endif
+
+/**
+ * Constructor function: builds a heat wires batch entry.
+ * For more details about time stamp and duration see {@link constructHeatWiresPackage()}.
+ * @param entry the entry to build
+ * @param address the destination node address
+ * @param wires wire flags, note: just north wires are considered
+ * @param startTimeStamp the time stamp when heating starts
+ * @param duration the 10 bit heating period duration
+ */
+void constructHeatWiresBatchEntry(HeatWiresBatchEntry *const entry,
+                                  const NodeAddress *const address,
+                                  const Actuators *const wires,
+                                  const uint16_t startTimeStamp,
+                                  const uint16_t duration) {
+    entry->addressRow = address->row;
+    entry->addressColumn = address->column;
+    entry->startTimeStamp = startTimeStamp;
+    entry->durationLsb = duration & 0x00ff;
+    entry->durationMsb = (duration & 0x0300) >> 8;
+    entry->northLeft = wires->northLeft;
+    entry->northRight = wires->northRight;
+    entry->__pad = 0;
+}
+
+/**
+ * Constructor function: builds a heat wires multicast header.
+ * For more details about time stamp and duration see {@link constructHeatWiresPackage()}.
+ * @param header the header to build
+ * @param rows the bitmap's number of rows
+ * @param columns the bitmap's number of columns
+ * @param wires wire flags, note: just north wires are considered
+ * @param startTimeStamp the time stamp when heating starts
+ * @param duration the 10 bit heating period duration
+ */
+void constructHeatWiresMulticastHeader(HeatWiresMulticastHeader *const header,
+                                       const uint8_t rows,
+                                       const uint8_t columns,
+                                       const Actuators *const wires,
+                                       const uint16_t startTimeStamp,
+                                       const uint16_t duration) {
+    header->rows = rows;
+    header->columns = columns;
+    header->startTimeStamp = startTimeStamp;
+    header->durationLsb = duration & 0x00ff;
+    header->durationMsb = (duration & 0x0300) >> 8;
+    header->northLeft = wires->northLeft;
+    header->northRight = wires->northRight;
+    header->__pad = 0;
 }
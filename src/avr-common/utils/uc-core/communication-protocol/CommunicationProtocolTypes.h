@@ -7,6 +7,7 @@
 #pragma once
 
 #include <stdint.h>
+#include "uc-core/configuration/CommunicationProtocol.h"
 
 /**
  * Describes communication states of the initiator. The initiator is the particle which
@@ -18,7 +19,11 @@ typedef enum CommunicationInitiatorStateTypes {
     COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_WAIT_FOR_TX_FINISHED,
     COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_RESPONSE,
     COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK,
-    COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK_WAIT_FOR_TX_FINISHED
+    COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK_WAIT_FOR_TX_FINISHED,
+    COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE,
+    COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED,
+    COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE,
+    COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED
 } CommunicationInitiatorStateTypes;
 
 /**
@@ -30,9 +35,48 @@ typedef enum CommunicationReceptionistStateTypes {
     COMMUNICATION_RECEPTIONIST_STATE_TYPE_RECEIVE,
     COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_ACK,
     COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_ACK_WAIT_TX_FINISHED,
-    COMMUNICATION_RECEPTIONIST_STATE_TYPE_WAIT_FOR_RESPONSE
+    COMMUNICATION_RECEPTIONIST_STATE_TYPE_WAIT_FOR_RESPONSE,
+    COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE,
+    COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE_WAIT_TX_FINISHED
 } CommunicationReceptionistStateTypes;
 
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+
+/**
+ * Describes the retransmission state of the package last transmitted on a port,
+ * see COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION.
+ */
+typedef struct HopRetransmission {
+    /**
+     * tx/rx timer value the retransmission window opened at
+     */
+    uint16_t windowStart;
+    /**
+     * number of tx/rx timer ticks the window lasts at least
+     */
+    uint16_t windowDuration;
+    /**
+     * local time period the retransmission window closes at the latest
+     */
+    uint16_t windowEndPeriod;
+    /**
+     * number of retransmissions on negative acknowledge
+     */
+    uint16_t numberRetransmissions;
+    /**
+     * number of negative acknowledges sent
+     */
+    uint16_t numberNacks;
+    uint8_t isRetransmittable : 1; // true while the port's buffer holds the package for retransmission
+    uint8_t isWindowOpen : 1; // true once the package's transmission has finished
+    uint8_t isRequested : 1; // true if the neighbour negatively acknowledged the package
+    uint8_t isNackPending : 1; // true if the neighbour's package is to be negatively acknowledged
+    uint8_t retransmissions : 2; // number of retransmissions of the package so far
+    uint8_t __pad : 2;
+} HopRetransmission;
+
+#endif
+
 /**
  * Describes the communication port state.
  */
@@ -48,6 +92,9 @@ typedef struct CommunicationProtocolPortState {
     */
     uint8_t reTransmissions : 4;
     uint8_t __pad : 4;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    HopRetransmission hopRetransmission;
+#endif
 } CommunicationProtocolPortState;
 
 /**
@@ -67,12 +114,196 @@ typedef struct NetworkGeometry {
     uint8_t columns;
 } NetworkGeometry;
 
+/**
+ * Link rate negotiation state. A particle negotiates with one neighbour at a time: first as
+ * receptionist with the north neighbour, then as initiator with the east and south neighbours.
+ */
+typedef struct LinkRateNegotiation {
+    /**
+     * receptionist: the 1st probe's reception duration at the current shift
+     */
+    uint16_t referenceSample;
+    /**
+     * receptionist: sum of the probes' reception duration deviations from the reference sample
+     */
+    int16_t deviationSum;
+    /**
+     * receptionist: sum of the squared deviations
+     */
+    uint32_t squaredDeviationSum;
+    /**
+     * the currently probed clock delay shift
+     */
+    uint8_t clockDelayShift : 2;
+    /**
+     * initiator: the fastest shift all probes were accepted at
+     */
+    uint8_t confirmedClockDelayShift : 2;
+    /**
+     * initiator: number of accepted probes, receptionist: number of samples at the current shift
+     */
+    uint8_t numberProbes : 3;
+    /**
+     * receptionist: the evaluation of the last probe
+     */
+    uint8_t isAccepted : 1;
+} LinkRateNegotiation;
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+
+struct DirectionOrientedPort;
+
+/**
+ * Describes a package relayed while being received.
+ */
+typedef struct CutThroughRelay {
+    /**
+     * the port the package is received at
+     */
+    const struct DirectionOrientedPort *source;
+    /**
+     * the port the package is relayed to
+     */
+    const struct DirectionOrientedPort *destination;
+    /**
+     * the package's data end pointer
+     */
+    uint16_t dataEndPointer;
+    /**
+     * number of received bytes copied to the destination's transmission buffer
+     */
+    uint8_t numberRelayedBytes : 4;
+    volatile uint8_t isActive : 1;
+    uint8_t __pad : 3;
+} CutThroughRelay;
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+/**
+ * Describes the content of a fragmented transfer.
+ */
+typedef enum FragmentedTransferContentType {
+    /**
+     * payload for the application, see {@link isFragmentedTransferReceived()}
+     */
+    FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION,
+    /**
+     * list of heat wires batch entries
+     */
+    FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_BATCH,
+    /**
+     * heat wires multicast header followed by the encoded bitmap of addressed nodes
+     */
+    FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_MULTICAST
+} FragmentedTransferContentType;
+
+/**
+ * Describes an outgoing fragmented transfer. Fragments are sent as transmission frames become available.
+ */
+typedef struct FragmentedTransfer {
+    /**
+     * the payload to transfer, must not be modified until the transfer is finished
+     */
+    const uint8_t *payload;
+    uint8_t addressRow;
+    uint8_t addressColumn;
+    uint8_t numberBytes;
+    uint8_t numberSentBytes;
+    /**
+     * the id of the current or last transfer
+     */
+    uint8_t transferId : 3;
+    /**
+     * the sequence number of the next fragment
+     */
+    uint8_t sequenceNumber : 4;
+    uint8_t isActive : 1;
+    /**
+     * the payload's content, see {@link FragmentedTransferContentType}
+     */
+    uint8_t contentType : 2;
+    uint8_t __pad : 6;
+} FragmentedTransfer;
+
+/**
+ * Describes the reassembly of an incoming fragmented transfer.
+ */
+typedef struct FragmentReassembly {
+    uint8_t bytes[COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES];
+    uint8_t numberBytes;
+    /**
+     * number of transfers aborted on missing fragments or exceeded buffer
+     */
+    uint8_t numberAbortedTransfers;
+    /**
+     * the id of the transfer being reassembled
+     */
+    uint8_t transferId : 3;
+    /**
+     * the sequence number of the next expected fragment
+     */
+    uint8_t sequenceNumber : 5;
+    uint8_t isReceiving : 1;
+    /**
+     * true if the transfer is complete, until released
+     */
+    uint8_t isComplete : 1;
+    /**
+     * the transfer's content, see {@link FragmentedTransferContentType}
+     */
+    uint8_t contentType : 2;
+    uint8_t __pad : 4;
+} FragmentReassembly;
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+
+/**
+ * Describes the forwarding of a received heat wires batch or multicast to the east and south
+ * neighbour. The bytes to forward are kept at the reassembly buffer.
+ */
+typedef struct HeatWiresTransferRelay {
+    uint8_t numberEastBytes;
+    /**
+     * offset of the south bound bytes at the reassembly buffer
+     */
+    uint8_t southBytesOffset;
+    uint8_t numberSouthBytes;
+    /**
+     * the forwarded transfers' content, see {@link FragmentedTransferContentType}
+     */
+    uint8_t contentType : 2;
+    uint8_t isEastPending : 1;
+    uint8_t isSouthPending : 1;
+    /**
+     * true while the reassembly buffer is in use by the transfer
+     */
+    uint8_t isActive : 1;
+    uint8_t __pad : 3;
+} HeatWiresTransferRelay;
+
+#endif
+
 /**
  * The communication protocol structure.
  */
 typedef struct CommunicationProtocol {
     CommunicationProtocolPorts ports;
     NetworkGeometry networkGeometry;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+    CutThroughRelay cutThroughRelay;
+#endif
+    LinkRateNegotiation linkRateNegotiation;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+    FragmentedTransfer fragmentedTransfer;
+    FragmentReassembly fragmentReassembly;
+#endif
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+    HeatWiresTransferRelay heatWiresTransferRelay;
+#endif
     uint8_t hasNetworkGeometryDiscoveryBreadCrumb : 1;
     volatile uint8_t isBroadcastEnabled : 1;
     volatile uint8_t isSimultaneousTransmissionEnabled : 1;
@@ -9,6 +9,27 @@
 #include "uc-core/particle/Globals.h"
 #include "./CommunicationProtocolTypes.h"
 
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructHopRetransmission(HopRetransmission *const o) {
+    o->windowStart = 0;
+    o->windowDuration = 0;
+    o->windowEndPeriod = 0;
+    o->numberRetransmissions = 0;
+    o->numberNacks = 0;
+    o->isRetransmittable = false;
+    o->isWindowOpen = false;
+    o->isRequested = false;
+    o->isNackPending = false;
+    o->retransmissions = 0;
+}
+
+#endif
+
 /**
  * constructor function
  * @param o reference to the object to construct
@@ -18,6 +39,9 @@ void constructCommunicationProtocolPortState(CommunicationProtocolPortState *con
     o->receptionistState = COMMUNICATION_RECEPTIONIST_STATE_TYPE_IDLE;
     o->stateTimeoutCounter = COMMUNICATION_PROTOCOL_TIMEOUT_COUNTER_MAX;
     o->reTransmissions = COMMUNICATION_PROTOCOL_RETRANSMISSION_COUNTER_MAX;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    constructHopRetransmission(&o->hopRetransmission);
+#endif
 }
 
 /**
@@ -40,6 +64,91 @@ void constructNetworkGeometry(NetworkGeometry *const o) {
     o->columns = 0;
 }
 
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructCutThroughRelay(CutThroughRelay *const o) {
+    o->source = NULL;
+    o->destination = NULL;
+    o->dataEndPointer = 0;
+    o->numberRelayedBytes = 0;
+    o->isActive = false;
+}
+
+#endif
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructLinkRateNegotiation(LinkRateNegotiation *const o) {
+    o->referenceSample = 0;
+    o->deviationSum = 0;
+    o->squaredDeviationSum = 0;
+    o->clockDelayShift = 0;
+    o->confirmedClockDelayShift = 0;
+    o->numberProbes = 0;
+    o->isAccepted = false;
+}
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructFragmentedTransfer(FragmentedTransfer *const o) {
+    o->payload = NULL;
+    o->addressRow = 0;
+    o->addressColumn = 0;
+    o->numberBytes = 0;
+    o->numberSentBytes = 0;
+    o->transferId = 0;
+    o->sequenceNumber = 0;
+    o->isActive = false;
+    o->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION;
+    o->__pad = 0;
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructFragmentReassembly(FragmentReassembly *const o) {
+    o->numberBytes = 0;
+    o->numberAbortedTransfers = 0;
+    o->transferId = 0;
+    o->sequenceNumber = 0;
+    o->isReceiving = false;
+    o->isComplete = false;
+    o->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION;
+    o->__pad = 0;
+}
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructHeatWiresTransferRelay(HeatWiresTransferRelay *const o) {
+    o->numberEastBytes = 0;
+    o->southBytesOffset = 0;
+    o->numberSouthBytes = 0;
+    o->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION;
+    o->isEastPending = false;
+    o->isSouthPending = false;
+    o->isActive = false;
+    o->__pad = 0;
+}
+
+#endif
+
 /**
  * constructor function
  * @param o reference to the object to construct
@@ -47,6 +156,17 @@ void constructNetworkGeometry(NetworkGeometry *const o) {
 void constructCommunicationProtocol(CommunicationProtocol *const o) {
     constructCommunicationProtocolPorts(&o->ports);
     constructNetworkGeometry(&o->networkGeometry);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+    constructCutThroughRelay(&o->cutThroughRelay);
+#endif
+    constructLinkRateNegotiation(&o->linkRateNegotiation);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+    constructFragmentedTransfer(&o->fragmentedTransfer);
+    constructFragmentReassembly(&o->fragmentReassembly);
+#endif
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+    constructHeatWiresTransferRelay(&o->heatWiresTransferRelay);
+#endif
     o->hasNetworkGeometryDiscoveryBreadCrumb = false;
     o->isBroadcastEnabled = false;
     o->isSimultaneousTransmissionEnabled = false;
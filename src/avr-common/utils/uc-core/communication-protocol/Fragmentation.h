@@ -0,0 +1,133 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Fragmentation related implementation. A payload exceeding a package is transferred as sequence
+ * of fragment packages. Each fragment carries the destination address, the transfer id, its
+ * sequence number and up to FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES payload bytes. Fragments are routed
+ * like heat wires packages, thus they arrive in order. The destination appends them to a bounded
+ * reassembly buffer, a missing fragment aborts the transfer. With hop retransmission a repeated
+ * fragment is ignored.
+ */
+
+#pragma once
+
+#include "uc-core/configuration/CommunicationProtocol.h"
+#include "uc-core/configuration/communication/Communication.h"
+#include "uc-core/particle/Globals.h"
+#include "CommunicationProtocolPackageTypes.h"
+
+#ifndef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+#  error COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION requires COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+#endif
+
+#if COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES > \
+    (FRAGMENT_PACKAGE_MAX_NUMBER_FRAGMENTS * FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES)
+#  error COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES exceeds the max. number of fragments
+#endif
+
+/**
+ * Evaluates the number of payload bytes of a received fragment package.
+ * @param pointer the reception buffer's pointer
+ * @return the number of payload bytes or 0 if the size is no fragment package size
+ */
+uint8_t fragmentPackagePayloadBytes(const BufferBitPointer *const pointer) {
+    if (pointer->bitMask != 1 ||
+        pointer->byteNumber <= (FragmentPackageBufferPointerSize(0) & 0x000f) ||
+        pointer->byteNumber > (FragmentPackageBufferPointerSize(FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES) & 0x000f)) {
+        return 0;
+    }
+    return pointer->byteNumber - (FragmentPackageBufferPointerSize(0) & 0x000f);
+}
+
+/**
+ * Stops the reassembly of the current transfer.
+ * @param reassembly the reassembly to abort
+ */
+static void __abortFragmentReassembly(FragmentReassembly *const reassembly) {
+    DEBUG_CHAR_OUT('F');
+    reassembly->isReceiving = false;
+    if (reassembly->numberAbortedTransfers < UINT8_MAX) {
+        reassembly->numberAbortedTransfers++;
+    }
+}
+
+/**
+ * Appends the fragment to the reassembly buffer. A 1st fragment starts a new transfer unless
+ * a complete transfer has not been released yet.
+ * @param package the fragment addressed to this node
+ * @param numberPayloadBytes the fragment's number of payload bytes
+ * @return true if the fragment completed the transfer, false otherwise
+ */
+bool reassembleFragment(const FragmentPackage *const package, const uint8_t numberPayloadBytes) {
+    FragmentReassembly *const reassembly = &ParticleAttributes.protocol.fragmentReassembly;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    if (package->transferId == reassembly->transferId &&
+        package->sequenceNumber + 1 == reassembly->sequenceNumber) {
+        // on duplicate of the last fragment, i.e. retransmitted although received
+        return false;
+    }
+#endif
+    if (reassembly->isComplete) {
+        // on unreleased transfer: the new transfer is lost
+        if (package->sequenceNumber == 0) {
+            __abortFragmentReassembly(reassembly);
+        }
+        return false;
+    }
+
+    if (package->sequenceNumber == 0) {
+        if (reassembly->isReceiving) {
+            __abortFragmentReassembly(reassembly);
+        }
+        reassembly->isReceiving = true;
+        reassembly->transferId = package->transferId;
+        reassembly->sequenceNumber = 0;
+        reassembly->numberBytes = 0;
+        if (package->header.isRangeCommand) {
+            reassembly->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_BATCH;
+        } else if (package->header.enableBroadcast) {
+            reassembly->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_MULTICAST;
+        } else {
+            reassembly->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION;
+        }
+    } else if (!reassembly->isReceiving) {
+        return false;
+    } else if (package->transferId != reassembly->transferId ||
+               package->sequenceNumber != reassembly->sequenceNumber) {
+        // on missing fragment
+        __abortFragmentReassembly(reassembly);
+        return false;
+    }
+
+    if (reassembly->numberBytes + numberPayloadBytes > COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES) {
+        __abortFragmentReassembly(reassembly);
+        return false;
+    }
+    for (uint8_t idx = 0; idx < numberPayloadBytes; idx++) {
+        reassembly->bytes[reassembly->numberBytes++] = package->payload[idx];
+    }
+    reassembly->sequenceNumber++;
+
+    if (package->isLastFragment) {
+        reassembly->isReceiving = false;
+        reassembly->isComplete = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @return true if a complete application transfer is buffered, false otherwise
+ */
+bool isFragmentedTransferReceived(void) {
+    return ParticleAttributes.protocol.fragmentReassembly.isComplete &&
+           ParticleAttributes.protocol.fragmentReassembly.contentType == FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION;
+}
+
+/**
+ * Releases the received transfer's buffer for the next transfer.
+ */
+void releaseFragmentedTransfer(void) {
+    ParticleAttributes.protocol.fragmentReassembly.isComplete = false;
+    ParticleAttributes.protocol.fragmentReassembly.numberBytes = 0;
+}
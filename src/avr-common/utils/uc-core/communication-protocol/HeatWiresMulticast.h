@@ -0,0 +1,74 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Heat wires multicast bitmap related implementation. The bitmap of addressed nodes is encoded
+ * as sequence of run lengths of alternating bit values starting with a run of cleared bits.
+ * A run exceeding UINT8_MAX is continued after a run of zero length. Trailing cleared bits
+ * are not encoded.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * Run-length encodes the bitmap.
+ * @param bitmap the bitmap, the bit of index i is bit (i % 8) of byte (i / 8)
+ * @param numberBits the bitmap's number of bits
+ * @param runs the buffer to write the run lengths to
+ * @param maxNumberRuns the buffer's size
+ * @param numberRuns the number of written run lengths
+ * @return false if the buffer is too small, true otherwise
+ */
+bool encodeHeatWiresMulticastBitmap(const uint8_t *const bitmap, const uint16_t numberBits,
+                                    uint8_t *const runs, const uint8_t maxNumberRuns,
+                                    uint8_t *const numberRuns) {
+    uint8_t value = 0;
+    uint8_t run = 0;
+    *numberRuns = 0;
+
+    for (uint16_t idx = 0; idx < numberBits; idx++) {
+        const uint8_t bit = (bitmap[idx >> 3] >> (idx & 0x7)) & 1;
+        while (bit != value || run == UINT8_MAX) {
+            if (*numberRuns >= maxNumberRuns) {
+                return false;
+            }
+            runs[(*numberRuns)++] = run;
+            run = 0;
+            value ^= 1;
+        }
+        run++;
+    }
+
+    if (value == 1) {
+        // on trailing run of set bits
+        if (*numberRuns >= maxNumberRuns) {
+            return false;
+        }
+        runs[(*numberRuns)++] = run;
+    }
+    return true;
+}
+
+/**
+ * Evaluates whether any bit in the given index range is set.
+ * @param runs the encoded bitmap
+ * @param numberRuns the number of run lengths
+ * @param fromIndex the first bit index of the range
+ * @param toIndex the bit index following the range
+ * @return true if at least one bit ∈ [fromIndex, toIndex) is set, false otherwise
+ */
+bool isHeatWiresMulticastBitSet(const uint8_t *const runs, const uint8_t numberRuns,
+                                const uint16_t fromIndex, const uint16_t toIndex) {
+    uint16_t runStart = 0;
+    for (uint8_t idx = 0; idx < numberRuns && runStart < toIndex; idx++) {
+        const uint16_t runEnd = runStart + runs[idx];
+        // odd runs are runs of set bits
+        if ((idx & 1) && runEnd > fromIndex && runEnd > runStart) {
+            return true;
+        }
+        runStart = runEnd;
+    }
+    return false;
+}
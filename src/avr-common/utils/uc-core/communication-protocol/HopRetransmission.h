@@ -0,0 +1,214 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Hop retransmission related implementation. A package transmitted from the transmission frame
+ * queues is kept in the port's transmission buffer. The receiver answers a package failing the
+ * frame check with a negative acknowledge (NACK) package. On NACK received within the window
+ * following the transmission the package is transmitted again, at most
+ * COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_MAX times. Until the window closes the port's next
+ * package is held back, thus a NACK always refers to the port's last package.
+ * The window is measured in Manchester clocks of the package's link rate: it closes once a NACK
+ * would have started arriving, unless a reception from the neighbour is in progress then.
+ */
+
+#pragma once
+
+#include "uc-core/configuration/CommunicationProtocol.h"
+#include "uc-core/configuration/communication/Communication.h"
+#include "uc-core/particle/Globals.h"
+#include "uc-core/communication/Transmission.h"
+#include "CommunicationProtocol.h"
+#include "CommunicationProtocolPackageTypesCtors.h"
+
+#ifndef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+#  error COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION requires COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+#endif
+
+#if COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_MAX > 3
+#  error COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_MAX must not exceed 3
+#endif
+
+#if COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_WINDOW_CLOCKS > 16
+#  error COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_WINDOW_CLOCKS must not exceed 16
+#endif
+
+/**
+ * Number of local time periods the window closes after at the latest. Bounds the window if
+ * the neighbour's receptions are not interpreted, i.e. in states other than idle, and
+ * guards the tx/rx timer's wrap around.
+ */
+#define __HOP_RETRANSMISSION_MAX_WINDOW_PERIODS ((uint16_t) 2)
+
+/**
+ * Starts the retransmission state of a newly buffered package.
+ * @param retransmission the port's retransmission state
+ */
+static void __startHopRetransmission(HopRetransmission *const retransmission) {
+    retransmission->isRetransmittable = true;
+    retransmission->isWindowOpen = false;
+    retransmission->isRequested = false;
+    retransmission->retransmissions = 0;
+}
+
+/**
+ * Keeps the package buffered at the given port for retransmission. A package transmitted
+ * simultaneously is copied to the south port's buffer too, thus it is retransmitted on the
+ * negatively acknowledging port only.
+ * @param txPort the port the package is buffered at
+ */
+void retainHopRetransmission(TxPort *const txPort) {
+    __startHopRetransmission(hopRetransmission(txPort));
+
+    if (txPort == &ParticleAttributes.communication.ports.tx.east &&
+        ParticleAttributes.protocol.isSimultaneousTransmissionEnabled) {
+        TxPort *const southPort = &ParticleAttributes.communication.ports.tx.south;
+        for (uint8_t idx = 0; idx < COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES; idx++) {
+            southPort->buffer.bytes[idx] = txPort->buffer.bytes[idx];
+        }
+        bufferBitPointerStart(&southPort->buffer.pointer);
+        southPort->dataEndPos.byteNumber = txPort->dataEndPos.byteNumber;
+        southPort->dataEndPos.bitMask = txPort->dataEndPos.bitMask;
+        __startHopRetransmission(hopRetransmission(southPort));
+    }
+}
+
+/**
+ * @return true if a package is kept for retransmission or a NACK is to be sent, false otherwise
+ */
+bool hasPendingHopRetransmissions(void) {
+    const CommunicationProtocolPorts *const ports = &ParticleAttributes.protocol.ports;
+    return ports->north.hopRetransmission.isRetransmittable || ports->north.hopRetransmission.isNackPending ||
+           ports->east.hopRetransmission.isRetransmittable || ports->east.hopRetransmission.isNackPending ||
+           ports->south.hopRetransmission.isRetransmittable || ports->south.hopRetransmission.isNackPending;
+}
+
+/**
+ * Requests the neighbour to retransmit its last package since the package received at the
+ * given port failed the frame check. Receptions shorter than a header and its trailer are no
+ * packages the neighbour keeps, i.e. discovery pulses. Receptions in broadcast mode are mirrored
+ * edge by edge by the neighbour, which keeps no package for retransmission either. Neither is
+ * negatively acknowledged.
+ * @param port the port the package has been received at
+ */
+void requestHopRetransmission(const DirectionOrientedPort *const port) {
+    if (port->rxPort->buffer.pointer.byteNumber == 0 || ParticleAttributes.protocol.isBroadcastEnabled) {
+        return;
+    }
+    DEBUG_CHAR_OUT('N');
+    port->protocol->hopRetransmission.isNackPending = true;
+}
+
+/**
+ * Schedules the retransmission of the port's last package if it is still kept.
+ * @param port the port the NACK has been received at
+ */
+void executeNackPackage(const DirectionOrientedPort *const port) {
+    HopRetransmission *const retransmission = &port->protocol->hopRetransmission;
+    if (retransmission->isRetransmittable) {
+        retransmission->isRequested = true;
+    }
+}
+
+/**
+ * @param port the designated port
+ * @return true if a package from the neighbour is being received or waits for interpretation,
+ * false otherwise
+ */
+static bool __isHopReceptionPending(const DirectionOrientedPort *const port) {
+    const RxPort *const rxPort = port->rxPort;
+    return rxPort->snapshotsBuffer.decoderStates.decodingState == DECODER_STATE_TYPE_DECODING ||
+           rxPort->snapshotsBuffer.startIndex != rxPort->snapshotsBuffer.endIndex ||
+#ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+           rxPort->isDecodedPackagePending ||
+#endif
+           rxPort->isDataBuffered;
+}
+
+/**
+ * Enables the transmission on the given port only. A retransmission or NACK on east or south
+ * does not disturb the other port.
+ * @param txPort the port to transmit the buffered package on
+ */
+static void __enableHopTransmission(TxPort *const txPort) {
+    if (txPort != &ParticleAttributes.communication.ports.tx.north) {
+        ParticleAttributes.protocol.isSimultaneousTransmissionEnabled = false;
+    }
+    enableTransmission(txPort);
+}
+
+/**
+ * Sends a pending NACK, retransmits a negatively acknowledged package and closes the
+ * retransmission window once expired.
+ * @pre the port is not transmitting
+ * @param port the designated port
+ * @return true if the port is in use, thus no further package must be loaded, false otherwise
+ */
+bool processHopRetransmission(const DirectionOrientedPort *const port) {
+    TxPort *const txPort = port->txPort;
+    HopRetransmission *const retransmission = &port->protocol->hopRetransmission;
+
+    if (txPort == &ParticleAttributes.communication.ports.tx.south &&
+        ParticleAttributes.protocol.isSimultaneousTransmissionEnabled &&
+        ParticleAttributes.communication.ports.tx.east.isTransmitting) {
+        // on simultaneous transmission ongoing
+        return true;
+    }
+
+    if (retransmission->isNackPending) {
+        retransmission->isNackPending = false;
+        if (retransmission->numberNacks < UINT16_MAX) {
+            retransmission->numberNacks++;
+        }
+        constructNackPackage(txPort);
+        __enableHopTransmission(txPort);
+        return true;
+    }
+
+    if (!retransmission->isRetransmittable) {
+        return false;
+    }
+
+    // the 16 bit timer and period counter are updated by ISRs
+    uint8_t sreg = SREG;
+    MEMORY_BARRIER;
+    CLI;
+    MEMORY_BARRIER;
+    const uint16_t now = TIMER_TX_RX_COUNTER_VALUE;
+    const uint16_t nowPeriod = ParticleAttributes.localTime.numTimePeriodsPassed;
+    MEMORY_BARRIER;
+    SREG = sreg;
+    MEMORY_BARRIER;
+    if (!retransmission->isWindowOpen) {
+        // on package transmitted
+        retransmission->isWindowOpen = true;
+        retransmission->windowStart = now;
+        retransmission->windowDuration = COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_WINDOW_CLOCKS * 2 *
+                                         txPort->clockDelayHalf;
+        retransmission->windowEndPeriod = nowPeriod + __HOP_RETRANSMISSION_MAX_WINDOW_PERIODS;
+        return true;
+    }
+
+    if (retransmission->isRequested &&
+        retransmission->retransmissions < COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_MAX) {
+        DEBUG_CHAR_OUT('R');
+        retransmission->isRequested = false;
+        retransmission->isWindowOpen = false;
+        retransmission->retransmissions++;
+        if (retransmission->numberRetransmissions < UINT16_MAX) {
+            retransmission->numberRetransmissions++;
+        }
+        bufferBitPointerStart(&txPort->buffer.pointer);
+        __enableHopTransmission(txPort);
+        return true;
+    }
+
+    if (retransmission->isRequested ||
+        ((uint16_t) (now - retransmission->windowStart) >= retransmission->windowDuration &&
+         !__isHopReceptionPending(port)) ||
+        (int16_t) (nowPeriod - retransmission->windowEndPeriod) >= 0) {
+        // on retransmissions exhausted or window closed
+        retransmission->isRetransmittable = false;
+        return false;
+    }
+    return true;
+}
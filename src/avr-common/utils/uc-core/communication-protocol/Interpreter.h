@@ -8,9 +8,15 @@
 
 #include "CommunicationProtocolTypes.h"
 #include "Commands.h"
-#include "uc-core/parity/Parity.h"
+#include "uc-core/frame-check/FrameCheck.h"
 #include "uc-core/time/Time.h"
 
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+
+#  include "LinkRateNegotiation.h"
+
+#endif
+
 /**
  * Interprets reception in wait for being enumerate states.
  * @param rxPort the port to interpret data from
@@ -24,12 +30,12 @@ static void __interpretWaitForBeingEnumeratedReception(RxPort *const rxPort,
         // on received address information
         case COMMUNICATION_RECEPTIONIST_STATE_TYPE_RECEIVE:
             // on address package
-            if (//isEvenParity(rxPort) &&
+            if (//isFrameCheckValid(rxPort) &&
                     equalsPackageSize(&rxPort->buffer.pointer, EnumerationPackageBufferPointerSize) &&
                     package->asHeader.id == PACKAGE_HEADER_ID_TYPE_ENUMERATE) {
 
                 // TODO: evaluation code
-                if (!isEvenParity(rxPort)) {
+                if (!isFrameCheckValid(rxPort)) {
                     clearReceptionPortBuffer(rxPort);
                     break;
                 }
@@ -44,27 +50,45 @@ static void __interpretWaitForBeingEnumeratedReception(RxPort *const rxPort,
 
             // on received ack
         case COMMUNICATION_RECEPTIONIST_STATE_TYPE_WAIT_FOR_RESPONSE:
-            if (// isEvenParity(rxPort) &&
+            if (// isFrameCheckValid(rxPort) &&
                     equalsPackageSize(&rxPort->buffer.pointer, AckPackagePointerSize) &&
                     package->asACKPackage.id == PACKAGE_HEADER_ID_TYPE_ACK) {
 
                 // TODO: evaluation code
-                if (!isEvenParity(rxPort)) {
+                if (!isFrameCheckValid(rxPort)) {
                     clearReceptionPortBuffer(rxPort);
                     break;
                 }
 
                 // DEBUG_CHAR_OUT('d');
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+                // adopt the rate the acknowledge is transmitted at
+                ParticleAttributes.communication.timerAdjustment.linkRates.north.clockDelayShift =
+                        rxPort->snapshotsBuffer.decoderStates.clockDelayShift;
+                ParticleAttributes.communication.timerAdjustment.linkRates.north.maxReceptionClockDelayShift =
+                        rxPort->snapshotsBuffer.decoderStates.clockDelayShift;
+#endif
                 ParticleAttributes.protocol.isBroadcastEnabled = package->asACKPackage.enableBroadcast;
                 ParticleAttributes.node.state = STATE_TYPE_LOCALLY_ENUMERATED;
                 commPortState->receptionistState = COMMUNICATION_RECEPTIONIST_STATE_TYPE_IDLE;
             }
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+            // on link rate probe
+            else if (isFrameCheckValid(rxPort) &&
+                     equalsPackageSize(&rxPort->buffer.pointer, LinkRatePackageBufferPointerSize) &&
+                     package->asHeader.id == PACKAGE_HEADER_ID_TYPE_LINK_RATE) {
+                evaluateLinkRateProbe(rxPort);
+                commPortState->receptionistState = COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE;
+            }
+#endif
             clearReceptionPortBuffer(rxPort);
             break;
 
         case COMMUNICATION_RECEPTIONIST_STATE_TYPE_IDLE:
         case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_ACK:
         case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_ACK_WAIT_TX_FINISHED:
+        case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE:
+        case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE_WAIT_TX_FINISHED:
             clearReceptionPortBuffer(rxPort);
             break;
     }
@@ -73,21 +97,46 @@ static void __interpretWaitForBeingEnumeratedReception(RxPort *const rxPort,
 /**
  * Interpret received packages in working state (idle state).
  * @param rxPort the port to interpret data from
+ * @return false if the package is kept buffered on back-pressure, true otherwise
  */
 
-static void __interpretReceivedPackage(const DirectionOrientedPort *const port) {
+static bool __interpretReceivedPackage(const DirectionOrientedPort *const port) {
     Package *package = (Package *) port->rxPort->buffer.bytes;
 
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    if (!isFrameCheckValid(port->rxPort)) {
+        requestHopRetransmission(port);
+        clearReceptionPortBuffer(port->rxPort);
+        return true;
+    }
+    // a NACK needs no transmission frame
+    if (package->asHeader.id == PACKAGE_HEADER_ID_TYPE_NACK) {
+        if (equalsPackageSize(&port->rxPort->buffer.pointer, NackPackagePointerSize)) {
+            executeNackPackage(port);
+        }
+        clearReceptionPortBuffer(port->rxPort);
+        return true;
+    }
+#endif
+
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    if (isTxFramePoolExhausted()) {
+        // on back-pressure: keep the package buffered until a frame is released
+        DEBUG_CHAR_OUT('q');
+        return false;
+    }
+#endif
+
     switch (package->asHeader.id) {
         case PACKAGE_HEADER_ID_TYPE_SYNC_TIME:
-            if (isEvenParity(port->rxPort) &&
+            if (isFrameCheckValid(port->rxPort) &&
                 equalsPackageSize(&port->rxPort->buffer.pointer, TimePackageBufferPointerSize)) {
                 executeSynchronizeLocalTimePackage(&package->asSyncTimePackage, &port->rxPort->buffer);
             }
             break;
 
         case PACKAGE_HEADER_ID_TYPE_NETWORK_GEOMETRY_RESPONSE:
-            if (isEvenParity(port->rxPort) &&
+            if (isFrameCheckValid(port->rxPort) &&
                 equalsPackageSize(&port->rxPort->buffer.pointer,
                                   AnnounceNetworkGeometryPackageBufferPointerSize)) {
                 executeAnnounceNetworkGeometryPackage(&package->asAnnounceNetworkGeometryPackage);
@@ -95,7 +144,7 @@ static void __interpretReceivedPackage(const DirectionOrientedPort *const port)
             break;
 
         case PACKAGE_HEADER_ID_TYPE_SET_NETWORK_GEOMETRY:
-            if (isEvenParity(port->rxPort) &&
+            if (isFrameCheckValid(port->rxPort) &&
                 equalsPackageSize(&port->rxPort->buffer.pointer,
                                   SetNetworkGeometryPackageBufferPointerSize)) {
                 executeSetNetworkGeometryPackage(&package->asSetNetworkGeometryPackage);
@@ -103,7 +152,7 @@ static void __interpretReceivedPackage(const DirectionOrientedPort *const port)
             break;
 
         case PACKAGE_HEADER_ID_TYPE_HEAT_WIRES:
-            if (isEvenParity(port->rxPort)) {
+            if (isFrameCheckValid(port->rxPort)) {
                 if (package->asHeader.isRangeCommand) {
                     if (equalsPackageSize(&port->rxPort->buffer.pointer,
                                           HeatWiresRangePackageBufferPointerSize)) {
@@ -118,24 +167,36 @@ static void __interpretReceivedPackage(const DirectionOrientedPort *const port)
             break;
 
         case PACKAGE_HEADER_ID_HEADER:
-            if (isEvenParity(port->rxPort) &&
+            if (isFrameCheckValid(port->rxPort) &&
                 equalsPackageSize(&port->rxPort->buffer.pointer, HeaderPackagePointerSize)) {
                 executeHeaderPackage(&package->asHeader);
             }
             break;
 
         case PACKAGE_HEADER_ID_TYPE_HEAT_WIRES_MODE:
-            if (isEvenParity(port->rxPort) &&
+            if (isFrameCheckValid(port->rxPort) &&
                 equalsPackageSize(&port->rxPort->buffer.pointer, HeatWiresModePackageBufferPointerSize)) {
                 executeHeatWiresModePackage(&package->asHeatWiresModePackage);
             }
             break;
 
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+        case PACKAGE_HEADER_ID_TYPE_EXTENDED_HEADER:
+            if (isFrameCheckValid(port->rxPort)) {
+                const uint8_t numberPayloadBytes = fragmentPackagePayloadBytes(&port->rxPort->buffer.pointer);
+                if (numberPayloadBytes > 0) {
+                    executeFragmentPackage(&package->asFragmentPackage, numberPayloadBytes);
+                }
+            }
+            break;
+#endif
+
         default:
             DEBUG_CHAR_OUT('u');
             break;
     }
     clearReceptionPortBuffer(port->rxPort);
+    return true;
 }
 
 /**
@@ -158,14 +219,19 @@ static void __interpretEnumerateNeighbourAckReception(RxPort *const rxPort,
         // on ack wih remote address
         case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_RESPONSE:
             // on ack with data
-            if (isEvenParity(rxPort) &&
+            if (isFrameCheckValid(rxPort) &&
                 equalsPackageSize(&rxPort->buffer.pointer, AckWithAddressPackageBufferPointerSize) &&
                 package->asHeader.id == PACKAGE_HEADER_ID_TYPE_ACK_WITH_DATA) {
                 // on correct address
                 if (expectedRemoteAddressRow == package->asACKWithRemoteAddress.addressRow &&
                     expectedRemoteAddressColumn == package->asACKWithRemoteAddress.addressColumn) {
                     // DEBUG_CHAR_OUT('D');
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+                    startLinkRateNegotiation();
+                    commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE;
+#else
                     commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK;
+#endif
                 } else { // on wrong address, restart transmission
                     // DEBUG_CHAR_OUT('V');
                     // DEBUG_CHAR_OUT('T');
@@ -175,11 +241,30 @@ static void __interpretEnumerateNeighbourAckReception(RxPort *const rxPort,
 
             clearReceptionPortBuffer(rxPort);
             break;
+
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+            // on link rate probe response
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+            if (isFrameCheckValid(rxPort) &&
+                equalsPackageSize(&rxPort->buffer.pointer, LinkRatePackageBufferPointerSize) &&
+                package->asHeader.id == PACKAGE_HEADER_ID_TYPE_LINK_RATE) {
+                interpretLinkRateResponse(rxPort, commPortState);
+            }
+            clearReceptionPortBuffer(rxPort);
+            break;
+#endif
+
         case COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_WAIT_FOR_TX_FINISHED:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
+#ifndef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+#endif
             break;
     }
 }
@@ -212,7 +297,10 @@ static void interpretRxBuffer(DirectionOrientedPort *const port) {
             break;
 
         case STATE_TYPE_IDLE:
-            __interpretReceivedPackage(port);
+            if (!__interpretReceivedPackage(port)) {
+                // on back-pressure: the package and its relay are kept for later interpretation
+                return;
+            }
             break;
 
         default:
@@ -223,5 +311,25 @@ static void interpretRxBuffer(DirectionOrientedPort *const port) {
         LED_STATUS4_TOGGLE;
         ParticleAttributes.protocol.isLastReceptionInterpreted = false;
     }
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+    // a relay not completed on execution is aborted
+    abortCutThroughRelay(port);
+#endif
     // DEBUG_CHAR_OUT('i');
 }
+
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+
+/**
+ * Interprets a package kept buffered on back-pressure as soon as a transmission frame is available.
+ * @param port the port the package has been received at
+ */
+void interpretDeferredRxBuffer(DirectionOrientedPort *const port) {
+    if (port->rxPort->isDataBuffered &&
+        ParticleAttributes.node.state == STATE_TYPE_IDLE &&
+        !isTxFramePoolExhausted()) {
+        interpretRxBuffer(port);
+    }
+}
+
+#endif
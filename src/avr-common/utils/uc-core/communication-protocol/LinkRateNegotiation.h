@@ -0,0 +1,129 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Link rate negotiation related implementation. After the neighbour acknowledged its address the
+ * enumerating particle (initiator) transmits probes at progressively shorter clock delays. The
+ * neighbour (receptionist) samples each probe's reception duration and responds at the probed rate
+ * if the samples' variance is within budget, otherwise at the default rate. The initiator settles on
+ * the fastest rate all probes were accepted at and acknowledges the enumeration at this rate, thus
+ * the receptionist adopts the rate the acknowledge is received at.
+ */
+
+#pragma once
+
+#include "uc-core/configuration/communication/Communication.h"
+#include "uc-core/particle/Globals.h"
+#include "CommunicationProtocolPackageTypes.h"
+
+#if COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT < 1
+#  error COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT must be at least 1, undefine COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION instead
+#endif
+
+/**
+ * Initiator: resets the negotiation to probe the rate next to the default one first.
+ */
+void startLinkRateNegotiation(void) {
+    LinkRateNegotiation *const negotiation = &ParticleAttributes.protocol.linkRateNegotiation;
+    negotiation->clockDelayShift = 1;
+    negotiation->confirmedClockDelayShift = 0;
+    negotiation->numberProbes = 0;
+}
+
+/**
+ * Receptionist: prepares the sampling of a new negotiation.
+ */
+void resetLinkRateNegotiationSamples(void) {
+    ParticleAttributes.protocol.linkRateNegotiation.numberProbes = 0;
+}
+
+/**
+ * Evaluates the decoding margin at the given clock delay shift: the distance of a short interval
+ * to the maximum short interval duration.
+ * @param clockDelayShift the link's clock delay shift
+ */
+static uint16_t __linkRateDecodingMargin(const uint8_t clockDelayShift) {
+    return (ParticleAttributes.communication.timerAdjustment.maxShortIntervalDuration -
+            ParticleAttributes.communication.timerAdjustment.transmissionClockDelayHalf) >> clockDelayShift;
+}
+
+/**
+ * Receptionist: samples the received probe's reception duration and evaluates whether all probes
+ * at the probe's clock delay shift are within budget.
+ * @param rxPort the port the probe has been received at
+ */
+void evaluateLinkRateProbe(const RxPort *const rxPort) {
+    LinkRateNegotiation *const negotiation = &ParticleAttributes.protocol.linkRateNegotiation;
+    const LinkRatePackage *const package = (const LinkRatePackage *) rxPort->buffer.bytes;
+    const uint16_t sample = rxPort->buffer.receptionDuration;
+
+    // on 1st probe at this shift: reset sampling
+    if (negotiation->numberProbes == 0 || negotiation->clockDelayShift != package->clockDelayShift) {
+        negotiation->clockDelayShift = package->clockDelayShift;
+        negotiation->referenceSample = sample;
+        negotiation->deviationSum = 0;
+        negotiation->squaredDeviationSum = 0;
+        negotiation->numberProbes = 0;
+        negotiation->isAccepted = true;
+    }
+
+    bool isAccepted = package->pattern == LINK_RATE_PACKAGE_PATTERN &&
+                      rxPort->snapshotsBuffer.decoderStates.clockDelayShift == package->clockDelayShift;
+
+    const int16_t margin = __linkRateDecodingMargin(package->clockDelayShift);
+    const int16_t deviation = (int16_t) (sample - negotiation->referenceSample);
+    if (deviation > margin || deviation < -margin) {
+        isAccepted = false;
+    } else if (negotiation->numberProbes < 7) {
+        negotiation->numberProbes++;
+        negotiation->deviationSum += deviation;
+        negotiation->squaredDeviationSum += (int32_t) deviation * deviation;
+
+        // n² * variance = n * sum(d²) - sum(d)²
+        const int32_t numberProbes = negotiation->numberProbes;
+        const int32_t scaledVariance = numberProbes * (int32_t) negotiation->squaredDeviationSum -
+                                       (int32_t) negotiation->deviationSum * negotiation->deviationSum;
+        const int32_t maxStdDeviance = margin / COMMUNICATION_LINK_RATE_DECODING_MARGIN_TO_STD_DEVIANCE_RATIO;
+        if (scaledVariance > numberProbes * numberProbes * maxStdDeviance * maxStdDeviance) {
+            isAccepted = false;
+        }
+    }
+    negotiation->isAccepted = negotiation->isAccepted && isAccepted;
+}
+
+/**
+ * Initiator: interprets the receptionist's response to the last probe.
+ * @param rxPort the port the response has been received at
+ * @param commPortState the port's communication state
+ */
+void interpretLinkRateResponse(const RxPort *const rxPort, CommunicationProtocolPortState *const commPortState) {
+    LinkRateNegotiation *const negotiation = &ParticleAttributes.protocol.linkRateNegotiation;
+    const LinkRatePackage *const package = (const LinkRatePackage *) rxPort->buffer.bytes;
+
+    if (package->isAccepted &&
+        package->pattern == LINK_RATE_PACKAGE_PATTERN &&
+        package->clockDelayShift == negotiation->clockDelayShift &&
+        rxPort->snapshotsBuffer.decoderStates.clockDelayShift == negotiation->clockDelayShift) {
+        negotiation->numberProbes++;
+        commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE;
+    } else {
+        commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED;
+    }
+}
+
+/**
+ * Updates the simultaneous transmission's link rate to the slower of the connected east and south links.
+ */
+void updateSimultaneousLinkRate(void) {
+    LinkRates *const linkRates = &ParticleAttributes.communication.timerAdjustment.linkRates;
+    uint8_t clockDelayShift = COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT;
+    if (ParticleAttributes.discoveryPulseCounters.east.isConnected &&
+        linkRates->east.clockDelayShift < clockDelayShift) {
+        clockDelayShift = linkRates->east.clockDelayShift;
+    }
+    if (ParticleAttributes.discoveryPulseCounters.south.isConnected &&
+        linkRates->south.clockDelayShift < clockDelayShift) {
+        clockDelayShift = linkRates->south.clockDelayShift;
+    }
+    linkRates->simultaneous.clockDelayShift = clockDelayShift;
+    linkRates->simultaneous.maxReceptionClockDelayShift = linkRates->east.maxReceptionClockDelayShift;
+}
@@ -0,0 +1,165 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Transmission frame queue related implementation. Packages to be relayed or originated are
+ * written into a frame of a fixed size pool which is enqueued at the destination port's queue
+ * by index. Whenever a port becomes available its next frame is loaded into the port's
+ * transmission buffer, the frame is released to the pool and the transmission is enabled.
+ * An exhausted pool signals back-pressure: received packages are kept buffered until a frame
+ * is released. With hop retransmission a port keeps its last package and loads the next frame
+ * not before the retransmission window has closed.
+ */
+
+#pragma once
+
+#include "uc-core/particle/Globals.h"
+#include "uc-core/communication/Transmission.h"
+#include "CommunicationProtocol.h"
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+
+#  include "HopRetransmission.h"
+
+#endif
+
+/**
+ * @return true if no frame is available, false otherwise
+ */
+bool isTxFramePoolExhausted(void) {
+    return ParticleAttributes.communication.frameQueues.freeFrames == 0;
+}
+
+/**
+ * Takes a frame from the pool. The frame is returned to the pool when being transmitted.
+ * @return the frame or NULL if the pool is exhausted
+ */
+TxFrame *acquireTxFrame(void) {
+    TxFrameQueues *const queues = &ParticleAttributes.communication.frameQueues;
+    for (uint8_t idx = 0; idx < COMMUNICATION_TX_FRAME_POOL_SIZE; idx++) {
+        if (queues->freeFrames & (1 << idx)) {
+            queues->freeFrames &= ~(1 << idx);
+            return &queues->pool[idx];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Returns the queue the given port's frames are enqueued at. Simultaneous frames are enqueued
+ * at the east queue.
+ * @param port the destination port
+ */
+static TxFrameQueue *__txFrameQueue(const DirectionOrientedPort *const port) {
+    if (port == &ParticleAttributes.directionOrientedPorts.north) {
+        return &ParticleAttributes.communication.frameQueues.north;
+    } else if (port == &ParticleAttributes.directionOrientedPorts.south) {
+        return &ParticleAttributes.communication.frameQueues.south;
+    }
+    return &ParticleAttributes.communication.frameQueues.east;
+}
+
+/**
+ * Enqueues an acquired frame at the given port without copying it.
+ * If the port's queue is full the frame is dropped and returned to the pool.
+ * @param port the destination port
+ * @param frame the acquired frame
+ */
+void enqueueTxFrame(const DirectionOrientedPort *const port, TxFrame *const frame) {
+    TxFrameQueues *const queues = &ParticleAttributes.communication.frameQueues;
+    TxFrameQueue *const queue = __txFrameQueue(port);
+    const uint8_t frameIndex = frame - queues->pool;
+
+    if (queue->numberFrames >= COMMUNICATION_TX_FRAME_QUEUE_SIZE) {
+        queues->freeFrames |= (1 << frameIndex);
+        return;
+    }
+    frame->isSimultaneous = (port == &ParticleAttributes.directionOrientedPorts.simultaneous);
+    queue->frameIndices[(queue->head + queue->numberFrames) & (COMMUNICATION_TX_FRAME_QUEUE_SIZE - 1)] =
+            frameIndex;
+    queue->numberFrames++;
+}
+
+/**
+ * @return true if frames are enqueued, being transmitted or kept for retransmission, false otherwise
+ */
+bool hasPendingTxFrames(void) {
+    const TxFrameQueues *const queues = &ParticleAttributes.communication.frameQueues;
+    return queues->north.numberFrames != 0 || queues->north.isFrameInFlight ||
+           queues->east.numberFrames != 0 || queues->east.isFrameInFlight ||
+           queues->south.numberFrames != 0 || queues->south.isFrameInFlight
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+           || hasPendingHopRetransmissions()
+#endif
+            ;
+}
+
+/**
+ * Loads the next frame of the queue into the port's transmission buffer and enables the
+ * transmission if the port is available. A simultaneous frame occupies the east and south port.
+ * @param queue the port's queue
+ * @param port the designated port
+ */
+static void __processTxFrameQueue(TxFrameQueue *const queue, DirectionOrientedPort *const port) {
+    TxFrameQueues *const queues = &ParticleAttributes.communication.frameQueues;
+    TxPort *const txPort = port->txPort;
+
+    if (txPort->isTransmitting) {
+        return;
+    }
+    queue->isFrameInFlight = false;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    if (processHopRetransmission(port)) {
+        return;
+    }
+#endif
+    if (queue->numberFrames == 0) {
+        return;
+    }
+
+    const uint8_t frameIndex = queue->frameIndices[queue->head];
+    const TxFrame *const frame = &queues->pool[frameIndex];
+    if (txPort == &ParticleAttributes.communication.ports.tx.east) {
+        if (frame->isSimultaneous && ParticleAttributes.communication.ports.tx.south.isTransmitting) {
+            return;
+        }
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+        // the south port's kept package must not be overwritten
+        if (frame->isSimultaneous && ParticleAttributes.protocol.ports.south.hopRetransmission.isRetransmittable) {
+            return;
+        }
+#endif
+        ParticleAttributes.protocol.isSimultaneousTransmissionEnabled = frame->isSimultaneous;
+    } else if (txPort == &ParticleAttributes.communication.ports.tx.south) {
+        if (ParticleAttributes.protocol.isSimultaneousTransmissionEnabled) {
+            if (ParticleAttributes.communication.ports.tx.east.isTransmitting) {
+                return;
+            }
+            ParticleAttributes.protocol.isSimultaneousTransmissionEnabled = false;
+        }
+    }
+
+    clearTransmissionPortBuffer(txPort);
+    for (uint8_t idx = 0; idx < COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES; idx++) {
+        txPort->buffer.bytes[idx] = frame->bytes[idx];
+    }
+    setBufferDataEndPointer(&txPort->dataEndPos, frame->dataEndPointer);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    retainHopRetransmission(txPort);
+#endif
+    queues->freeFrames |= (1 << frameIndex);
+    queue->head = (queue->head + 1) & (COMMUNICATION_TX_FRAME_QUEUE_SIZE - 1);
+    queue->numberFrames--;
+    queue->isFrameInFlight = true;
+    enableTransmission(txPort);
+}
+
+/**
+ * Starts the transmission of enqueued frames at available ports.
+ * Called once per main loop iteration.
+ */
+void processTxFrameQueues(void) {
+    TxFrameQueues *const queues = &ParticleAttributes.communication.frameQueues;
+    __processTxFrameQueue(&queues->north, &ParticleAttributes.directionOrientedPorts.north);
+    __processTxFrameQueue(&queues->east, &ParticleAttributes.directionOrientedPorts.east);
+    __processTxFrameQueue(&queues->south, &ParticleAttributes.directionOrientedPorts.south);
+}
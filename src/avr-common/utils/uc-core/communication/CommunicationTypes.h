@@ -10,6 +10,14 @@
 #include "ManchesterDecodingTypes.h"
 #include "uc-core/configuration/Particle.h"
 #include "uc-core/configuration/communication/Communication.h"
+#include "uc-core/synchronization/BasicCalculationTypes.h"
+
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+/**
+ * The CRC-8 register a package's frame check is computed in.
+ */
+typedef uint8_t FrameCheckType;
+#endif
 
 /**
  * Describes a bit within a 4 byte buffer.
@@ -41,13 +49,19 @@ typedef struct PortBuffer {
      */
     uint16_t lastFallingToRisingDuration;
     /**
-     * compare value of time tracking ISR when last PDU was received
+     * compare value of time tracking ISR when the PDU's last edge was received
      */
-    volatile uint16_t nextLocalTimeInterruptOnPduReceived;
+    uint16_t nextLocalTimeInterruptOnPduReceived;
     /**
-     * timer/counter value when lsat PDU was received
+     * timer/counter value when the PDU's last edge was received
      */
-    volatile uint16_t localTimeTrackingTimerCounterValueOnPduReceived;
+    uint16_t localTimeTrackingTimerCounterValueOnPduReceived;
+    /**
+     * true if both values above are latched from the PDU's last edge, false if a subsequent edge
+     * has been received before the PDU's end was decoded
+     */
+    uint8_t isPduReceivedTimestampLatched : 1;
+    uint8_t __pad : 7;
 } PortBuffer;
 
 /**
@@ -59,9 +73,60 @@ typedef struct TxPort {
     volatile uint8_t isTransmitting : 1; // true during transmission, else false
     volatile uint8_t isTxClockPhase : 1; // true if clock phase, else on data phase
     volatile uint8_t isDataBuffered : 1; // true if the buffer contains data to be transmitted
-    uint8_t __pad : 5;
+    uint8_t isDefaultClockDelayForced : 1; // true if the data is to be transmitted at the default link rate
+    uint8_t __pad : 4;
+    /**
+     * timer/counter value the port's next signal edge is due at
+     */
+    volatile uint16_t nextEdgeDeadline;
+    /**
+     * the half clock delay the ongoing transmission is clocked at
+     */
+    volatile uint16_t clockDelayHalf;
 } TxPort;
 
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+
+/**
+ * A frame to be transmitted, enqueued at a port's transmission queue.
+ */
+typedef struct TxFrame {
+    uint8_t bytes[COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES];
+    /**
+     * the data end position as uint16_t, see setBufferDataEndPointer()
+     */
+    uint16_t dataEndPointer;
+    uint8_t isSimultaneous : 1; // true if the frame is to be transmitted on east and south
+    uint8_t __pad : 7;
+} TxFrame;
+
+/**
+ * Ring of pool frame indices waiting for the port to become available.
+ */
+typedef struct TxFrameQueue {
+    uint8_t frameIndices[COMMUNICATION_TX_FRAME_QUEUE_SIZE];
+    uint8_t head : 2; // index of the next frame to transmit
+    uint8_t numberFrames : 3;
+    uint8_t isFrameInFlight : 1; // true while a dequeued frame is being transmitted
+    uint8_t __pad : 2;
+} TxFrameQueue;
+
+/**
+ * Per port transmission queues and the frame pool they share.
+ */
+typedef struct TxFrameQueues {
+    TxFrame pool[COMMUNICATION_TX_FRAME_POOL_SIZE];
+    /**
+     * bit mask of unused pool frames
+     */
+    uint8_t freeFrames;
+    TxFrameQueue north;
+    TxFrameQueue east;
+    TxFrameQueue south;
+} TxFrameQueues;
+
+#endif
+
 /**
  * Transmission ports bundle.
  */
@@ -77,13 +142,101 @@ typedef struct TxPorts {
 typedef struct RxPort {
     // each pin interrupt stores snapshots and the flank direction into the buffer
     RxSnapshotBuffer snapshotsBuffer;
-    PortBuffer buffer;
+    PortBuffer buffer; // the received package to be interpreted
+#ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+    PortBuffer decodingBuffer; // the package being decoded
+    /**
+     * number of decoded packages dropped since the reception buffer has not been released in time
+     */
+    uint16_t numberDroppedPackages;
+#endif
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    /**
+     * CRC-8 residue of the received package including its trailer, 0 if the package is intact
+     */
+    FrameCheckType frameCheck;
+#  ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+    FrameCheckType decodingFrameCheck; // CRC-8 register of the package being decoded
+#  endif
+#endif
+    /**
+     * number of received packages discarded due to a failed frame check
+     */
+    uint16_t numberFrameCheckErrors;
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    /**
+     * number of received packages a single bit error has been corrected in
+     */
+    uint16_t numberCorrectedErrors;
+#endif
     volatile uint8_t isOverflowed : 1;
     volatile uint8_t isDataBuffered : 1;
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+#  ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+    volatile uint8_t isDecodedPackagePending : 1; // true if a decoded package waits for the reception buffer
+    volatile uint8_t __pad : 5;
+#  else
+    volatile uint8_t __pad : 6;
+#  endif
+#else
     volatile uint8_t parityBitCounter : 1; // 1-bit counter to track odd number of 1-bits
+#  ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+    volatile uint8_t decodingParityBitCounter : 1; // parity bit counter of the package being decoded
+    volatile uint8_t isDecodedPackagePending : 1; // true if a decoded package waits for the reception buffer
+    volatile uint8_t __pad : 3;
+#  else
     volatile uint8_t __pad : 5;
+#  endif
+#endif
 } RxPort;
 
+#ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+/**
+ * Evaluates to the buffer the port's reception is decoded to.
+ */
+#  define rxDecodingBuffer(rxPort) (&(rxPort)->decodingBuffer)
+/**
+ * Evaluates to the CRC-8 register of the port's reception being decoded.
+ */
+#  define rxDecodingFrameCheck(rxPort) ((rxPort)->decodingFrameCheck)
+/**
+ * Evaluates to the parity bit counter of the port's reception being decoded.
+ */
+#  define rxDecodingParityBitCounter(rxPort) ((rxPort)->decodingParityBitCounter)
+#else
+#  define rxDecodingBuffer(rxPort) (&(rxPort)->buffer)
+#  define rxDecodingFrameCheck(rxPort) ((rxPort)->frameCheck)
+#  define rxDecodingParityBitCounter(rxPort) ((rxPort)->parityBitCounter)
+#endif
+
+/**
+ * The negotiated rate of a link: its manchester clock delay is transmissionClockDelay >> clockDelayShift.
+ */
+typedef struct LinkRate {
+    /**
+     * the clock delay shift transmissions are performed at
+     */
+    uint8_t clockDelayShift : 2;
+    /**
+     * receptions are decoded at clock delay shifts up to this value
+     */
+    uint8_t maxReceptionClockDelayShift : 2;
+    uint8_t __pad : 4;
+} LinkRate;
+
+/**
+ * Link rates bundle.
+ */
+typedef struct LinkRates {
+    LinkRate north;
+    LinkRate east;
+    LinkRate south;
+    /**
+     * the slower of the connected east and south links
+     */
+    LinkRate simultaneous;
+} LinkRates;
+
 /**
  * Transmission timing related fields that allows runtime changes.
  */
@@ -111,17 +264,21 @@ typedef struct TransmissionTimerAdjustment {
     /**
      * the newly calculated / approximated transmission clock delay
      */
-    volatile float newTransmissionClockDelay;
+    volatile CalculationType newTransmissionClockDelay;
     /**
      * the newly calculated / approximated transmission half clock delay
      */
-    volatile float newTransmissionClockDelayHalf;
+    volatile CalculationType newTransmissionClockDelayHalf;
     /**
      * Flag indicating that a new transmission clock delay is available. The value is considered
      * by the next corresponding ISR.
      */
     volatile uint8_t isTransmissionClockDelayUpdateable : 1;
     uint8_t __pad : 7;
+    /**
+     * per port negotiated link rates
+     */
+    LinkRates linkRates;
 } TransmissionTimerAdjustment;
 
 /**
@@ -147,4 +304,7 @@ typedef struct CommunicationPorts {
 typedef struct Communication {
     TransmissionTimerAdjustment timerAdjustment;
     CommunicationPorts ports;
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    TxFrameQueues frameQueues;
+#endif
 } Communication;
\ No newline at end of file
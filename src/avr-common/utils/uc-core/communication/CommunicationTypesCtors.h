@@ -7,8 +7,15 @@
 
 #include <math.h>
 #include "CommunicationTypes.h"
+#include "uc-core/synchronization/Calculation.h"
 #include "ManchesterDecodingTypesCtors.h"
 
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+
+#  include "uc-core/frame-check/Crc8.h"
+
+#endif
+
 /**
  * constructor function
  * @param o reference to the object to construct
@@ -41,6 +48,7 @@ void constructPortBuffer(volatile PortBuffer *const o) {
     o->lastFallingToRisingDuration = 0;
     o->nextLocalTimeInterruptOnPduReceived = 0;
     o->localTimeTrackingTimerCounterValueOnPduReceived = 0;
+    o->isPduReceivedTimestampLatched = false;
 }
 
 /**
@@ -53,10 +61,39 @@ void constructTxPort(TxPort *const o) {
     o->isTransmitting = false;
     o->isTxClockPhase = false;
     o->isDataBuffered = false;
+    o->isDefaultClockDelayForced = false;
 
     o->isTxClockPhase = false;
+    o->nextEdgeDeadline = 0;
+    o->clockDelayHalf = COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY / 2;
 }
 
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructTxFrameQueue(TxFrameQueue *const o) {
+    o->head = 0;
+    o->numberFrames = 0;
+    o->isFrameInFlight = false;
+    o->__pad = 0;
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructTxFrameQueues(TxFrameQueues *const o) {
+    o->freeFrames = (uint8_t) ((1 << COMMUNICATION_TX_FRAME_POOL_SIZE) - 1);
+    constructTxFrameQueue(&o->north);
+    constructTxFrameQueue(&o->east);
+    constructTxFrameQueue(&o->south);
+}
+
+#endif
+
 /**
  * constructor function
  * @param o reference to the object to construct
@@ -76,7 +113,25 @@ void constructRxPort(RxPort *const o) {
     constructPortBuffer(&o->buffer);
     o->isOverflowed = false;
     o->isDataBuffered = false;
+    o->numberFrameCheckErrors = 0;
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    o->numberCorrectedErrors = 0;
+#endif
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    o->frameCheck = CRC8_INITIAL_VALUE;
+#else
     o->parityBitCounter = 0;
+#endif
+#ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+    constructPortBuffer(&o->decodingBuffer);
+    o->numberDroppedPackages = 0;
+#  ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    o->decodingFrameCheck = CRC8_INITIAL_VALUE;
+#  else
+    o->decodingParityBitCounter = 0;
+#  endif
+    o->isDecodedPackagePending = false;
+#endif
 }
 
 /**
@@ -98,6 +153,27 @@ void constructCommunicationPorts(CommunicationPorts *const o) {
     constructRxPorts(&o->rx);
 }
 
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructLinkRate(LinkRate *const o) {
+    o->clockDelayShift = 0;
+    o->maxReceptionClockDelayShift = 0;
+    o->__pad = 0;
+}
+
+/**
+ * constructor function
+ * @param o reference to the object to construct
+ */
+void constructLinkRates(LinkRates *const o) {
+    constructLinkRate(&o->north);
+    constructLinkRate(&o->east);
+    constructLinkRate(&o->south);
+    constructLinkRate(&o->simultaneous);
+}
+
 /**
  * constructor function
  * @param o reference to the object to construct
@@ -112,9 +188,10 @@ void constructTransmissionTimerAdjustment(TransmissionTimerAdjustment *const o)
 
     o->transmissionClockDelay = COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY;
     o->transmissionClockDelayHalf = COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY / 2;
-    o->newTransmissionClockDelay = o->transmissionClockDelay;
-    o->newTransmissionClockDelayHalf = o->transmissionClockDelayHalf;
+    o->newTransmissionClockDelay = calculationFromInteger(o->transmissionClockDelay);
+    o->newTransmissionClockDelayHalf = calculationFromInteger(o->transmissionClockDelayHalf);
     o->isTransmissionClockDelayUpdateable = false;
+    constructLinkRates(&o->linkRates);
 }
 
 /**
@@ -124,4 +201,7 @@ void constructTransmissionTimerAdjustment(TransmissionTimerAdjustment *const o)
 void constructCommunication(Communication *const o) {
     constructTransmissionTimerAdjustment(&o->timerAdjustment);
     constructCommunicationPorts(&o->ports);
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    constructTxFrameQueues(&o->frameQueues);
+#endif
 }
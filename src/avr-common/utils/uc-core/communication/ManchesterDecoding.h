@@ -5,6 +5,7 @@
 #pragma once
 
 #include <math.h>
+#include <avr/pgmspace.h>
 #include "Communication.h"
 #include "ManchesterDecodingTypes.h"
 #include "uc-core/configuration/interrupts/TxRxTimer.h"
@@ -16,6 +17,24 @@
 #include "uc-core/periphery/Periphery.h"
 #include "uc-core/synchronization/Synchronization.h"
 
+#ifdef MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END
+
+#  include "uc-core/communication-protocol/CommunicationProtocolPackageTypes.h"
+
+#endif
+
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+
+#  include "uc-core/frame-check/Crc8.h"
+
+#  ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+
+#    include "uc-core/frame-check/ErrorCorrection.h"
+
+#  endif
+
+#endif
+
 /**
  * Resets the decoder phase state do default.
  * @param decoderPhaseState the phase state field to reset
@@ -72,30 +91,305 @@
 #endif
 
 /**
- * Stores the data bit to the reception buffer unless the buffer is saturated.
- * @param rxPort the port where to buffer the bit
- * @param isRisingEdge the signal edge
+ * Decoding table of four consecutive intervals. The index is composed of
+ * <br/>[5]   the edge terminating the 1st interval (1 if rising),
+ * <br/>[4]   the phase state before the 1st interval,
+ * <br/>[3:0] the interval classes (bit i is set if the i-th interval is short).
+ * Edges are assumed to alternate. Each entry holds
+ * <br/>[8]   the phase state after the 4th interval,
+ * <br/>[7]   the parity of the decoded bits,
+ * <br/>[6:4] the number of decoded bits (0 to 4),
+ * <br/>[3:0] the decoded bits, 1st bit at the least significant position.
+ */
+const uint16_t manchesterDecodingIntervalsTable[64] PROGMEM = {
+        0x000, 0x14a, 0x135, 0x010, 0x1a2, 0x0a2, 0x091, 0x1b4,
+        0x191, 0x0b2, 0x0a1, 0x1a2, 0x010, 0x136, 0x123, 0x020,
+        0x14a, 0x000, 0x010, 0x135, 0x0a2, 0x1a2, 0x1b4, 0x091,
+        0x0b2, 0x191, 0x1a2, 0x0a1, 0x136, 0x010, 0x020, 0x123,
+        0x000, 0x145, 0x1b2, 0x091, 0x1a1, 0x0a1, 0x010, 0x133,
+        0x110, 0x035, 0x0a2, 0x1a1, 0x091, 0x1b1, 0x120, 0x023,
+        0x145, 0x000, 0x091, 0x1b2, 0x0a1, 0x1a1, 0x133, 0x010,
+        0x035, 0x110, 0x1a1, 0x0a2, 0x1b1, 0x091, 0x023, 0x120,
+};
+
+/**
+ * Number of intervals decoded by one table lookup.
+ */
+#define __MANCHESTER_DECODING_TABLE_INTERVALS 4
+
+/**
+ * Appends decoded bits to the bit accumulator and stores the accumulator to the reception buffer
+ * once a byte is complete. With CRC-8 frame check the stored byte updates the CRC.
+ * Bits exceeding the reception buffer are discarded.
+ * @param rxPort the port where to buffer the bits
+ * @param bits the decoded bits, 1st bit at the least significant position
+ * @param numberBits the number of decoded bits (at most 4)
  */
-static void __storeDataBit(RxPort *const rxPort, const bool isRisingEdge) {
-    // save bit to buffer
-    if (!isBufferEndPosition(&rxPort->buffer.pointer)) {
-        if (isRisingEdge) {
-//            DEBUG_CHAR_OUT('1');
-//            LED_STATUS2_TOGGLE;
-            rxPort->buffer.bytes[rxPort->buffer.pointer.byteNumber] setBit rxPort->buffer.pointer.bitMask;
-            rxPort->parityBitCounter++;
+static void __storeDataBits(RxPort *const rxPort, const uint8_t bits, const uint8_t numberBits) {
+    ManchesterDecoderStates *const states = &rxPort->snapshotsBuffer.decoderStates;
+    uint16_t accumulator = states->bitAccumulator | ((uint16_t) bits << states->numberAccumulatedBits);
+    uint8_t numberAccumulatedBits = states->numberAccumulatedBits + numberBits;
+
+    if (numberAccumulatedBits >= 8) {
+        if (rxDecodingBuffer(rxPort)->pointer.byteNumber < sizeof(rxDecodingBuffer(rxPort)->bytes)) {
+            rxDecodingBuffer(rxPort)->bytes[rxDecodingBuffer(rxPort)->pointer.byteNumber] = (uint8_t) accumulator;
+            rxDecodingBuffer(rxPort)->pointer.byteNumber++;
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+            rxDecodingFrameCheck(rxPort) = crc8UpdateByte(rxDecodingFrameCheck(rxPort), (uint8_t) accumulator);
+#endif
         } else {
-//            DEBUG_CHAR_OUT('0');
-//            LED_STATUS3_TOGGLE;
-            rxPort->buffer.bytes[rxPort->buffer.pointer.byteNumber] unsetBit rxPort->buffer.pointer.bitMask;
+            rxPort->isOverflowed = true;
+            blinkReceptionBufferOverflowErrorForever(rxPort);
+        }
+        accumulator >>= 8;
+        numberAccumulatedBits -= 8;
+    }
+    states->bitAccumulator = (uint8_t) accumulator;
+    states->numberAccumulatedBits = numberAccumulatedBits;
+}
+
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+
+/**
+ * Corrects a single bit error of a package marked by the error correction flag and strips the
+ * error correction trailer. The CRC-8 residue is evaluated again over the corrected package
+ * including the CRC-8 trailer. Marked receptions shorter than a header followed by both trailers
+ * fail the frame check. Receptions whose flag contradicts the header id's selection fail the
+ * frame check too: otherwise a corrupted flag would leave the trailers misaligned to the CRC-8.
+ * @pre the reception buffer pointer points to the error correction trailer
+ * @param rxPort the port to correct the reception of
+ */
+static void __correctDataBits(RxPort *const rxPort) {
+    PortBuffer *const buffer = rxDecodingBuffer(rxPort);
+    const bool isMarked = (buffer->bytes[0] & ERROR_CORRECTION_HEADER_FLAG_BIT) != 0;
+    if (isMarked != isErrorCorrectionSelected(errorCorrectionHeaderId(buffer->bytes[0]))) {
+        // any non-zero residue fails the check
+        rxDecodingFrameCheck(rxPort) = UINT8_MAX;
+        return;
+    }
+    if (!isMarked) {
+        return;
+    }
+
+    if (buffer->pointer.byteNumber >= sizeof(FrameCheckType) + sizeof(ErrorCorrectionType)) {
+        if (correctSingleBitError(buffer->bytes, &buffer->pointer) && rxPort->numberCorrectedErrors < UINT16_MAX) {
+            rxPort->numberCorrectedErrors++;
         }
-        bufferBitPointerIncrement(&rxPort->buffer.pointer);
+        rxDecodingFrameCheck(rxPort) = computeFrameCheck(buffer->bytes, &buffer->pointer);
+        buffer->pointer.byteNumber -= sizeof(ErrorCorrectionType);
     } else {
-        rxPort->isOverflowed = true;
-        blinkReceptionBufferOverflowErrorForever(rxPort);
+        // any non-zero residue fails the check
+        rxDecodingFrameCheck(rxPort) = UINT8_MAX;
+    }
+}
+
+#endif
+
+/**
+ * Stores the accumulated bits of an incomplete byte to the reception buffer and points the
+ * reception buffer pointer beyond the last decoded bit. With CRC-8 frame check the CRC is
+ * updated by the remaining bits and the trailer is stripped from the buffered package: the
+ * pointer is moved back by one byte. Receptions shorter than the trailer fail the frame check.
+ * With error correction the error correction trailer is stripped too and evaluated beforehand.
+ * @param rxPort the port to flush
+ */
+static void __flushDataBits(RxPort *const rxPort) {
+    ManchesterDecoderStates *const states = &rxPort->snapshotsBuffer.decoderStates;
+    if (states->numberAccumulatedBits > 0) {
+        if (rxDecodingBuffer(rxPort)->pointer.byteNumber < sizeof(rxDecodingBuffer(rxPort)->bytes)) {
+            rxDecodingBuffer(rxPort)->bytes[rxDecodingBuffer(rxPort)->pointer.byteNumber] = states->bitAccumulator;
+            rxDecodingBuffer(rxPort)->pointer.bitMask = 1 << states->numberAccumulatedBits;
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+            rxDecodingFrameCheck(rxPort) = crc8UpdateBits(rxDecodingFrameCheck(rxPort), states->bitAccumulator,
+                                                          states->numberAccumulatedBits);
+#endif
+        } else {
+            rxPort->isOverflowed = true;
+            blinkReceptionBufferOverflowErrorForever(rxPort);
+        }
+    }
+    states->bitAccumulator = 0;
+    states->numberAccumulatedBits = 0;
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    if (rxDecodingBuffer(rxPort)->pointer.byteNumber >= sizeof(FrameCheckType)) {
+        rxDecodingBuffer(rxPort)->pointer.byteNumber -= sizeof(FrameCheckType);
+#  ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+        __correctDataBits(rxPort);
+#  endif
+    } else {
+        // any non-zero residue fails the check
+        rxDecodingFrameCheck(rxPort) = UINT8_MAX;
+    }
+#endif
+}
+
+/**
+ * Decodes the pending intervals one by one. Used for less than a table's number of intervals
+ * and for non alternating edges, i.e. on missed edges.
+ * @param rxPort the port to decode
+ */
+static void __decodePendingIntervalsSequentially(RxPort *const rxPort) {
+    ManchesterDecoderStates *const states = &rxPort->snapshotsBuffer.decoderStates;
+    for (uint8_t interval = 0; interval < states->numberPendingIntervals; interval++) {
+        if (states->pendingShortIntervals & (1 << interval)) {
+            __phaseStateAdvanceShortInterval(states->phaseState);
+        } else {
+            __phaseStateAdvanceLongInterval(states->phaseState);
+        }
+        if (__isDataPhase(states->phaseState)) {
+            const uint8_t bit = (states->pendingRisingEdges >> interval) & 1;
+#ifndef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+            rxDecodingParityBitCounter(rxPort) += bit;
+#endif
+            __storeDataBits(rxPort, bit, 1);
+        }
+    }
+    states->numberPendingIntervals = 0;
+    states->pendingShortIntervals = 0;
+    states->pendingRisingEdges = 0;
+}
+
+/**
+ * Decodes the pending intervals by one table lookup if the edges alternate, otherwise sequentially.
+ * @pre __MANCHESTER_DECODING_TABLE_INTERVALS intervals are pending
+ * @param rxPort the port to decode
+ */
+static void __decodePendingIntervals(RxPort *const rxPort) {
+    ManchesterDecoderStates *const states = &rxPort->snapshotsBuffer.decoderStates;
+    const uint8_t risingEdges = states->pendingRisingEdges;
+    if (risingEdges != 0x5 && risingEdges != 0xa) {
+        __decodePendingIntervalsSequentially(rxPort);
+        return;
+    }
+
+    const uint16_t entry = pgm_read_word(&manchesterDecodingIntervalsTable[
+            ((risingEdges & 1) << 5) | (states->phaseState << 4) | states->pendingShortIntervals]);
+    states->phaseState = (entry >> 8) & 1;
+#ifndef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    rxDecodingParityBitCounter(rxPort) += (entry >> 7) & 1;
+#endif
+    __storeDataBits(rxPort, entry & 0xf, (entry >> 4) & 0x7);
+    states->numberPendingIntervals = 0;
+    states->pendingShortIntervals = 0;
+    states->pendingRisingEdges = 0;
+}
+
+/**
+ * Appends a classified interval to the pending intervals and decodes them once a table's number
+ * of intervals is pending.
+ * @param rxPort the port to decode
+ * @param isShortInterval true on a short interval, false on a long one
+ * @param isRisingEdge the edge terminating the interval
+ */
+static void __decodeInterval(RxPort *const rxPort, const bool isShortInterval, const bool isRisingEdge) {
+    ManchesterDecoderStates *const states = &rxPort->snapshotsBuffer.decoderStates;
+    const uint8_t interval = states->numberPendingIntervals;
+    states->pendingShortIntervals |= isShortInterval << interval;
+    states->pendingRisingEdges |= isRisingEdge << interval;
+    states->numberPendingIntervals = interval + 1;
+    if (interval + 1 >= __MANCHESTER_DECODING_TABLE_INTERVALS) {
+        __decodePendingIntervals(rxPort);
+    }
+}
+
+#ifdef MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END
+
+/**
+ * Marks receptions of unknown length, see ManchesterDecoderStates.expectedNumberBits.
+ */
+#define __EXPECTED_NUMBER_BITS_UNKNOWN UINT8_MAX
+
+/**
+ * Evaluates the number of bits of a reception by its header, including the trailers.
+ * Time and link rate packages are not considered: their reception duration is measured up to
+ * the last edge, which may follow the last bit.
+ * @param header the received header
+ * @return the number of bits or __EXPECTED_NUMBER_BITS_UNKNOWN for variable length, measured and
+ * unknown packages
+ */
+static uint8_t __expectedReceptionNumberBits(const HeaderPackage *const header) {
+    uint16_t pointerSize;
+    switch (header->id) {
+        case PACKAGE_HEADER_ID_HEADER:
+        case PACKAGE_HEADER_ID_TYPE_ACK:
+        case PACKAGE_HEADER_ID_TYPE_NACK:
+            pointerSize = HeaderPackagePointerSize;
+            break;
+        case PACKAGE_HEADER_ID_TYPE_ACK_WITH_DATA:
+            pointerSize = AckWithAddressPackageBufferPointerSize;
+            break;
+        case PACKAGE_HEADER_ID_TYPE_NETWORK_GEOMETRY_RESPONSE:
+            pointerSize = AnnounceNetworkGeometryPackageBufferPointerSize;
+            break;
+        case PACKAGE_HEADER_ID_TYPE_SET_NETWORK_GEOMETRY:
+            pointerSize = SetNetworkGeometryPackageBufferPointerSize;
+            break;
+        case PACKAGE_HEADER_ID_TYPE_ENUMERATE:
+            pointerSize = EnumerationPackageBufferPointerSize;
+            break;
+        case PACKAGE_HEADER_ID_TYPE_HEAT_WIRES:
+            pointerSize = header->isRangeCommand ? HeatWiresRangePackageBufferPointerSize
+                                                 : HeatWiresPackageBufferPointerSize;
+            break;
+        case PACKAGE_HEADER_ID_TYPE_HEAT_WIRES_MODE:
+            pointerSize = HeatWiresModePackageBufferPointerSize;
+            break;
+        default:
+            return __EXPECTED_NUMBER_BITS_UNKNOWN;
+    }
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    pointerSize += FrameCheckTrailerPointerSize;
+#  ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    if (header->parityBit) {
+        pointerSize += ErrorCorrectionTrailerPointerSize;
     }
+#  endif
+#endif
+    uint8_t numberBits = (pointerSize & 0x000f) * 8;
+    for (uint8_t bitMask = pointerSize >> 8; bitMask > 1; bitMask >>= 1) {
+        numberBits++;
+    }
+    return numberBits;
+}
+
+/**
+ * Evaluates whether the reception's number of bits implied by its header has been received,
+ * including the bits of the intervals pending for decoding.
+ * @param rxPort the port to evaluate
+ * @return true if the reception is complete, false if its header has not been decoded yet, its
+ * length is unknown or bits are missing
+ */
+static bool __isExpectedLengthReceived(RxPort *const rxPort) {
+    ManchesterDecoderStates *const states = &rxPort->snapshotsBuffer.decoderStates;
+    if (rxDecodingBuffer(rxPort)->pointer.byteNumber == 0) {
+        return false;
+    }
+    if (states->expectedNumberBits == 0) {
+        states->expectedNumberBits =
+                __expectedReceptionNumberBits((const HeaderPackage *) rxDecodingBuffer(rxPort)->bytes);
+    }
+
+    uint8_t numberBits = rxDecodingBuffer(rxPort)->pointer.byteNumber * 8 + states->numberAccumulatedBits;
+    uint8_t phaseState = states->phaseState;
+    for (uint8_t interval = 0; interval < states->numberPendingIntervals; interval++) {
+        // a long interval keeps the phase
+        if (states->pendingShortIntervals & (1 << interval)) {
+            phaseState ^= 1;
+        }
+        numberBits += phaseState;
+    }
+    return numberBits >= states->expectedNumberBits;
 }
 
+#endif
+
+/**
+ * Evaluates to the number of buffered snapshots. The free running indices wrap at 256, which is a
+ * multiple of the buffer size, thus the unsigned difference needs no wrap around correction.
+ */
+#define __rxSnapshotBufferSize(rxSnapshotBuffer) \
+    ((uint8_t) ((rxSnapshotBuffer)->endIndex - (rxSnapshotBuffer)->startIndex))
+
 //#ifdef SIMULATION_doesnotexist
 #ifdef SIMULATION
 
@@ -106,17 +400,7 @@ static void __storeDataBit(RxPort *const rxPort, const bool isRisingEdge) {
  * for evaluation purpose
  */
 static void __printSnapshotBufferSizeToSimulationRegister(RxSnapshotBuffer *o) {
-    uint16_t size = 0;
-    if (o->endIndex > o->startIndex) {
-        size = o->endIndex - o->startIndex;
-    } else if (o->endIndex < o->startIndex) {
-        size = o->endIndex + (MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS - o->startIndex);
-    }
-
-    // cut off possible overflows due to race with incomint reception interrupt
-    if (size <= MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS) {
-        DEBUG_INT16_OUT(size);
-    }
+    DEBUG_INT16_OUT(__rxSnapshotBufferSize(o));
 }
 
 #else
@@ -124,31 +408,14 @@ static void __printSnapshotBufferSizeToSimulationRegister(RxSnapshotBuffer *o) {
 #endif
 
 /**
- * Increments the snapshots circular buffer start index.
+ * Increments the snapshots circular buffer start index. Written by the decoder only.
  * @param o the snapshot buffer reference
  */
 static void __rxSnapshotBufferIncrementStartIndex(RxSnapshotBuffer *const o) {
-    if (o->startIndex >= (MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS - 1)) {
-        o->startIndex = 0;
-    } else {
-        o->startIndex++;
-    }
-
+    o->startIndex++;
     __ifSimulationPrintSnapshotBufferSize(o);
 }
 
-/**
- * Increments the snapshots circular buffer end index.
- * @param o the snapshot buffer reference
- */
-static void __rxSnapshotBufferIncrementEndIndex(RxSnapshotBuffer *const o) {
-    if (o->endIndex >= (MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS - 1)) {
-        o->endIndex = 0;
-    } else {
-        o->endIndex++;
-    }
-}
-
 /**
  * Releases the next element at the start of the queue.
  */
@@ -159,7 +426,7 @@ static void __rxSnapshotBufferIncrementEndIndex(RxSnapshotBuffer *const o) {
  * Evaluates to the next element at the start of the queue.
  */
 #define __rxSnapshotBufferPeek(rxSnapshotBuffer) \
-    (&(rxSnapshotBuffer)->snapshots[(rxSnapshotBuffer)->startIndex])
+    (&(rxSnapshotBuffer)->snapshots[(rxSnapshotBuffer)->startIndex & MANCHESTER_DECODING_RX_SNAPSHOTS_INDEX_MASK])
 
 
 /**
@@ -170,7 +437,9 @@ static void __rxSnapshotBufferIncrementEndIndex(RxSnapshotBuffer *const o) {
 
 /**
  * Appends a value and the specified flank to the snapshot buffer. The least significant counter value
- * bit is discarded and used to store the flank.
+ * bit is discarded and used to store the flank. The end index is written by this function only and
+ * published after the snapshot is stored, thus the decoder may run concurrently without disabling
+ * interrupts. On a full buffer the snapshot is dropped and the overflow flag is set.
  * @param timerCounterValue the counter value to store
  * @param isRisingEdge the signal edge
  * @param snapshotsBuffer a reference to the buffer to store to
@@ -180,70 +449,170 @@ void captureSnapshot(const uint16_t timerCounterValue, const bool isRisingEdge,
                      const uint16_t nextLocalTimeInterruptCompareValue,
                      RxPort *const rxPort) {
     RxSnapshotBuffer *const snapshotBuffer = &rxPort->snapshotsBuffer;
-    uint8_t nextEndIdx = 0;
-    if (snapshotBuffer->endIndex < (MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS - 1)) {
-        nextEndIdx = snapshotBuffer->endIndex + 1;
-    }
+    const uint8_t endIndex = snapshotBuffer->endIndex;
 
-    if (nextEndIdx == snapshotBuffer->startIndex) {
+    if ((uint8_t) (endIndex - snapshotBuffer->startIndex) >= MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS) {
         snapshotBuffer->isOverflowed = true;
 #ifdef SIMULATION
         DEBUG_CHAR_OUT('8');
 #endif
         blinkReceptionSnapshotBufferOverflowErrorForever(snapshotBuffer);
+        return;
     }
 
-    volatile Snapshot *snapshot = &(snapshotBuffer->snapshots[snapshotBuffer->endIndex]);
-    __rxSnapshotBufferIncrementEndIndex(snapshotBuffer);
+    volatile Snapshot *const snapshot =
+            &(snapshotBuffer->snapshots[endIndex & MANCHESTER_DECODING_RX_SNAPSHOTS_INDEX_MASK]);
 
-    // TODO: the real observation between compressed and not compressed has not been measured yet
 #ifdef MANCHESTER_DECODING_ENABLE_MERGE_TIMESTAMP_WITH_EDGE_DIRECTION
     // using a more compressed storage of snapshot and edge direction with loosing least significant bit
-    if (isRisingEdge) {
-        (*((volatile uint16_t *) (snapshot))) = (*timerCounterValue & 0xFFFE) | 1;
-    } else {
-        (*((volatile uint16_t *) (snapshot))) = (*timerCounterValue & 0xFFFE);
-    }
+    (*((volatile uint16_t *) (snapshot))) = (timerCounterValue & 0xFFFE) | isRisingEdge;
 #else
     // not compressed, but more accurate
     snapshot->timerValue = timerCounterValue;
     snapshot->isRisingEdge = isRisingEdge;
 #endif
+    MEMORY_BARRIER;
+    snapshotBuffer->endIndex = endIndex + 1;
+
     /**
      * The current local time tracking ISR
      * + timer compare value to
      * + snapshot timer value
      * relation is needed on last PDU edge for shifting local time tracking in phase with transmitter.
+     * It is kept for the last two snapshots and latched by the decoder at the PDU's end, see
+     * __latchPduReceivedTimestamp().
      */
+    snapshotBuffer->lastSnapshotsLocalTimeInterruptCompareValue[1] =
+            snapshotBuffer->lastSnapshotsLocalTimeInterruptCompareValue[0];
+    snapshotBuffer->lastSnapshotsLocalTimeInterruptCompareValue[0] = nextLocalTimeInterruptCompareValue;
+    snapshotBuffer->lastSnapshotsTimerValue[1] = snapshotBuffer->lastSnapshotsTimerValue[0];
+    snapshotBuffer->lastSnapshotsTimerValue[0] = timerCounterValue;
 
-    /**
-     * The timer compare value:
-     * TODO: On consecutive package, if the decoder/interpreter has not been called and considered
-     * before next package this value will be overwritten, thus invalid!
-     */
-    rxPort->buffer.nextLocalTimeInterruptOnPduReceived = nextLocalTimeInterruptCompareValue;
+    __ifSimulationPrintSnapshotBufferSize(snapshotBuffer);
+}
 
-    /**
-     * The snapshot timer value.
-     */
-    rxPort->buffer.localTimeTrackingTimerCounterValueOnPduReceived = timerCounterValue;
+/**
+ * Classifies the clock delay shift of a reception by its 1st interval. Each package starts with
+ * a 1-bit, thus the 1st interval is a short one at any link rate.
+ * @param firstInterval the duration of the reception's 1st interval
+ * @param maxClockDelayShift the highest shift to consider
+ * @return the shift of the fastest rate the interval is a short one at
+ */
+static uint8_t __classifyReceptionClockDelayShift(const uint16_t firstInterval, const uint8_t maxClockDelayShift) {
+    uint8_t clockDelayShift = 0;
+    while (clockDelayShift < maxClockDelayShift &&
+           firstInterval <=
+           (ParticleAttributes.communication.timerAdjustment.maxShortIntervalDuration >> (clockDelayShift + 1))) {
+        clockDelayShift++;
+    }
+    return clockDelayShift;
+}
 
-    __ifSimulationPrintSnapshotBufferSize(snapshotBuffer);
+/**
+ * Latches the time tracking relation of the reception's last edge to the decoding buffer, thus the
+ * package keeps it while the next reception is being captured. All edges of the reception are
+ * dequeued at this point, thus the reception's last edge is the snapshot captured just before the
+ * queued ones. The reception ISR keeps the relation of the last two snapshots: on more queued
+ * snapshots the package is marked as not latched.
+ * @param rxPort the port the reception ended at
+ */
+static void __latchPduReceivedTimestamp(RxPort *const rxPort) {
+    PortBuffer *const buffer = rxDecodingBuffer(rxPort);
+    RxSnapshotBuffer *const snapshotBuffer = &rxPort->snapshotsBuffer;
+    // written by the reception ISR
+    uint8_t sreg = SREG;
+    MEMORY_BARRIER;
+    CLI;
+    MEMORY_BARRIER;
+    const uint8_t numberQueuedSnapshots = __rxSnapshotBufferSize(snapshotBuffer);
+    buffer->isPduReceivedTimestampLatched = numberQueuedSnapshots < 2;
+    if (buffer->isPduReceivedTimestampLatched) {
+        buffer->nextLocalTimeInterruptOnPduReceived =
+                snapshotBuffer->lastSnapshotsLocalTimeInterruptCompareValue[numberQueuedSnapshots];
+        buffer->localTimeTrackingTimerCounterValueOnPduReceived =
+                snapshotBuffer->lastSnapshotsTimerValue[numberQueuedSnapshots];
+    }
+    MEMORY_BARRIER;
+    SREG = sreg;
+    MEMORY_BARRIER;
 }
 
+#ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+
+/**
+ * Hands the decoded package over to the interpreter if the reception buffer has been released:
+ * copies the decoding buffer to the reception buffer and calls the interpreter.
+ * @param port the port the package has been received at
+ * @param interpreterImpl a interpreter implementation reference
+ * @return true if the package has been handed over, false otherwise
+ */
+static bool __handOverDecodedPackage(DirectionOrientedPort *const port,
+                                     void (*const interpreterImpl)(DirectionOrientedPort *)) {
+    RxPort *const rxPort = port->rxPort;
+    if (rxPort->isDataBuffered == true) {
+        return false;
+    }
+
+    PortBuffer *const buffer = &rxPort->buffer;
+    const PortBuffer *const decodingBuffer = &rxPort->decodingBuffer;
+    for (uint8_t idx = 0; idx < COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES; idx++) {
+        buffer->bytes[idx] = decodingBuffer->bytes[idx];
+    }
+    buffer->pointer = decodingBuffer->pointer;
+    buffer->receptionDuration = decodingBuffer->receptionDuration;
+    buffer->firstFallingToRisingDuration = decodingBuffer->firstFallingToRisingDuration;
+    buffer->lastFallingToRisingDuration = decodingBuffer->lastFallingToRisingDuration;
+    buffer->nextLocalTimeInterruptOnPduReceived = decodingBuffer->nextLocalTimeInterruptOnPduReceived;
+    buffer->localTimeTrackingTimerCounterValueOnPduReceived =
+            decodingBuffer->localTimeTrackingTimerCounterValueOnPduReceived;
+    buffer->isPduReceivedTimestampLatched = decodingBuffer->isPduReceivedTimestampLatched;
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    rxPort->frameCheck = rxPort->decodingFrameCheck;
+#else
+    rxPort->parityBitCounter = rxPort->decodingParityBitCounter;
+#endif
+
+    rxPort->isDecodedPackagePending = false;
+    rxPort->isDataBuffered = true;
+    interpreterImpl(port);
+    return true;
+}
+
+#endif
+
 /**
  * State driven decoding of the specified snapshots buffer. The result is a bit oriented stream.
- * The order is the same as the snapshot buffer's. On package end/timeout calls the interpreter with
- * the respective port as argument.
+ * Intervals in between snapshots are classified as short or long and decoded in groups by table lookup.
+ * The order is the same as the snapshot buffer's. Intervals are classified at the reception's clock
+ * delay shift, which is classified by the 1st interval. On package end/timeout calls the interpreter with
+ * the respective port as argument. With MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END the package
+ * ends as soon as the number of bits implied by its header has been decoded and no snapshot is pending.
+ * With double buffered reception the package is decoded to the decoding buffer and handed over to
+ * the interpreter once the reception buffer is released. Meanwhile decoding pauses until the
+ * snapshot buffer fills up, then the waiting package is dropped and counted.
  * @param port the port to decode from and buffer to
  * @param interpreterImpl a interpreter implementation reference
  */
 void manchesterDecodeBuffer(DirectionOrientedPort *const port,
                             void (*const interpreterImpl)(DirectionOrientedPort *)) {
     RxPort *rxPort = port->rxPort;
+#ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+    if (rxPort->isDecodedPackagePending == true && !__handOverDecodedPackage(port, interpreterImpl)) {
+        if (__rxSnapshotBufferSize(&rxPort->snapshotsBuffer) < MANCHESTER_DECODING_RX_DROP_PACKAGE_NUMBER_SNAPSHOTS) {
+            return;
+        }
+        // on sustained load: drop the waiting package in favour of the subsequent reception
+        DEBUG_CHAR_OUT('d');
+        rxPort->isDecodedPackagePending = false;
+        if (rxPort->numberDroppedPackages < UINT16_MAX) {
+            rxPort->numberDroppedPackages++;
+        }
+    }
+#else
     if (rxPort->isDataBuffered == true) {
         return;
     }
+#endif
     switch (rxPort->snapshotsBuffer.decoderStates.decodingState) {
 
         case DECODER_STATE_TYPE_START:
@@ -251,15 +620,28 @@ void manchesterDecodeBuffer(DirectionOrientedPort *const port,
                 volatile Snapshot *snapshot = __rxSnapshotBufferPeek(&rxPort->snapshotsBuffer);
 
                 if (snapshot->isRisingEdge == false) {
-                    bufferBitPointerStart(&rxPort->buffer.pointer);
+                    bufferBitPointerStart(&rxDecodingBuffer(rxPort)->pointer);
                     __resetDecoderPhaseState(rxPort->snapshotsBuffer.decoderStates.phaseState);
+                    rxPort->snapshotsBuffer.decoderStates.numberPendingIntervals = 0;
+                    rxPort->snapshotsBuffer.decoderStates.pendingShortIntervals = 0;
+                    rxPort->snapshotsBuffer.decoderStates.pendingRisingEdges = 0;
+                    rxPort->snapshotsBuffer.decoderStates.bitAccumulator = 0;
+                    rxPort->snapshotsBuffer.decoderStates.numberAccumulatedBits = 0;
+                    rxPort->snapshotsBuffer.decoderStates.clockDelayShift = 0;
+#ifdef MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END
+                    rxPort->snapshotsBuffer.decoderStates.expectedNumberBits = 0;
+#endif
                     rxPort->snapshotsBuffer.temporarySnapshotTimerValue = __getTimerValue(snapshot);
 
                     DEBUG_CHAR_OUT('+');
-                    rxPort->parityBitCounter = 0;
-                    rxPort->buffer.receptionDuration = 0;
-                    rxPort->buffer.firstFallingToRisingDuration = 0;
-//                    rxPort->buffer.receptionStartTimestamp = rxPort->snapshotsBuffer.temporarySnapshotTimerValue;
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+                    rxDecodingFrameCheck(rxPort) = CRC8_INITIAL_VALUE;
+#else
+                    rxDecodingParityBitCounter(rxPort) = 0;
+#endif
+                    rxDecodingBuffer(rxPort)->receptionDuration = 0;
+                    rxDecodingBuffer(rxPort)->firstFallingToRisingDuration = 0;
+//                    rxDecodingBuffer(rxPort)->receptionStartTimestamp = rxPort->snapshotsBuffer.temporarySnapshotTimerValue;
                     rxPort->snapshotsBuffer.decoderStates.decodingState = DECODER_STATE_TYPE_DECODING;
                     __rxSnapshotBufferDequeue(&rxPort->snapshotsBuffer);
                     goto __DECODER_STATE_TYPE_DECODING;
@@ -279,36 +661,41 @@ void manchesterDecodeBuffer(DirectionOrientedPort *const port,
                 const uint16_t difference = timerValue - rxPort->snapshotsBuffer.temporarySnapshotTimerValue;
 //                DEBUG_INT16_OUT(difference);
 
+                // on 1st interval: classify the link rate
+                if (rxDecodingBuffer(rxPort)->receptionDuration == 0) {
+                    rxPort->snapshotsBuffer.decoderStates.clockDelayShift =
+                            __classifyReceptionClockDelayShift(difference,
+                                                               port->linkRate->maxReceptionClockDelayShift);
+                }
+                const uint8_t clockDelayShift = rxPort->snapshotsBuffer.decoderStates.clockDelayShift;
+
                 if (difference <=
-                    ParticleAttributes.communication.timerAdjustment.maxLongIntervalDuration) {
+                    (ParticleAttributes.communication.timerAdjustment.maxLongIntervalDuration >> clockDelayShift)) {
                     // on short interval
                     if (difference <=
-                        ParticleAttributes.communication.timerAdjustment.maxShortIntervalDuration) {
-                        __phaseStateAdvanceShortInterval(rxPort->snapshotsBuffer.decoderStates.phaseState);
+                        (ParticleAttributes.communication.timerAdjustment.maxShortIntervalDuration >>
+                         clockDelayShift)) {
                         __cycleCounterAdvanceShortInterval(rxPort->snapshotsBuffer.numberHalfCyclesPassed);
+                        __decodeInterval(rxPort, true, snapshot->isRisingEdge);
                         // DEBUG_CHAR_OUT('x');
                     }
                         // on long interval
                     else {
-                        __phaseStateAdvanceLongInterval(rxPort->snapshotsBuffer.decoderStates.phaseState);
                         __cycleCounterAdvanceLongInterval(rxPort->snapshotsBuffer.numberHalfCyclesPassed);
+                        __decodeInterval(rxPort, false, snapshot->isRisingEdge);
                         // DEBUG_CHAR_OUT('X');
                     }
 
-                    if (__isDataPhase(rxPort->snapshotsBuffer.decoderStates.phaseState)) {
-                        __storeDataBit(rxPort, snapshot->isRisingEdge);
-                    } else {
-                    }
                     rxPort->snapshotsBuffer.temporarySnapshotTimerValue = timerValue;
                     // store the delay from last bit until PDU end for later synchronization
-                    rxPort->buffer.lastFallingToRisingDuration = difference;
+                    rxDecodingBuffer(rxPort)->lastFallingToRisingDuration = difference;
                     // store the delay from PDU start until 1st bit for later synchronization
-                    if (rxPort->buffer.firstFallingToRisingDuration == 0) {
-                        rxPort->buffer.firstFallingToRisingDuration = difference;
+                    if (rxDecodingBuffer(rxPort)->firstFallingToRisingDuration == 0) {
+                        rxDecodingBuffer(rxPort)->firstFallingToRisingDuration = difference;
                     }
 
-                    rxPort->buffer.receptionDuration += difference;
-//                    rxPort->buffer.receptionEndTimestamp = timerValue;
+                    rxDecodingBuffer(rxPort)->receptionDuration += difference;
+//                    rxDecodingBuffer(rxPort)->receptionEndTimestamp = timerValue;
                     __rxSnapshotBufferDequeue(&rxPort->snapshotsBuffer);
                     // on overdue: difference of two snapshots exceed the max. rx clock duration
                 } else {
@@ -321,6 +708,15 @@ void manchesterDecodeBuffer(DirectionOrientedPort *const port,
 
             // on empty queue check for timeout
             if (__rxSnapshotBufferIsEmpty(&rxPort->snapshotsBuffer)) {
+#ifdef MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END
+                // on all bits implied by the header received: no need to wait for the timeout
+                if (__isExpectedLengthReceived(rxPort)) {
+#  ifdef SIMULATION
+                    rxPort->snapshotsBuffer.decoderStates.decodingState = DECODER_STATE_TYPE_POST_TIMEOUT_PROCESS;
+#  endif
+                    goto __DECODER_STATE_TYPE_POST_TIMEOUT_PROCESS;
+                }
+#endif
                 uint8_t sreg = SREG;
                 MEMORY_BARRIER;
                 CLI;
@@ -332,7 +728,8 @@ void manchesterDecodeBuffer(DirectionOrientedPort *const port,
                 uint16_t difference = now - rxPort->snapshotsBuffer.temporarySnapshotTimerValue;
 //                DEBUG_INT16_OUT(difference);
                 if (difference >=
-                    (ParticleAttributes.communication.timerAdjustment.transmissionClockDelay * 2)) {
+                    ((ParticleAttributes.communication.timerAdjustment.transmissionClockDelay * 2) >>
+                     rxPort->snapshotsBuffer.decoderStates.clockDelayShift)) {
 #ifdef SIMULATION
                     rxPort->snapshotsBuffer.decoderStates.decodingState = DECODER_STATE_TYPE_POST_TIMEOUT_PROCESS;
 #endif
@@ -343,17 +740,25 @@ void manchesterDecodeBuffer(DirectionOrientedPort *const port,
 
         __DECODER_STATE_TYPE_POST_TIMEOUT_PROCESS:
         case DECODER_STATE_TYPE_POST_TIMEOUT_PROCESS:
+            __latchPduReceivedTimestamp(rxPort);
+            __decodePendingIntervalsSequentially(rxPort);
+            __flushDataBits(rxPort);
             DEBUG_CHAR_OUT('|');
 #ifdef SIMULATION
-        uint16_t value = rxPort->buffer.pointer.byteNumber;
+        uint16_t value = rxDecodingBuffer(rxPort)->pointer.byteNumber;
         DEBUG_INT16_OUT(value);
-        value = rxPort->buffer.pointer.bitMask;
-        DEBUG_INT16_OUT(rxPort->buffer.pointer.bitMask);
+        value = rxDecodingBuffer(rxPort)->pointer.bitMask;
+        DEBUG_INT16_OUT(rxDecodingBuffer(rxPort)->pointer.bitMask);
 #endif
 //            __approximateNewTxClockSpeed(rxPort);
-            rxPort->isDataBuffered = true;
             rxPort->snapshotsBuffer.decoderStates.decodingState = DECODER_STATE_TYPE_START;
+#ifdef MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+            rxPort->isDecodedPackagePending = true;
+            __handOverDecodedPackage(port, interpreterImpl);
+#else
+            rxPort->isDataBuffered = true;
             interpreterImpl(port);
+#endif
             break;
     }
 }
@@ -28,7 +28,39 @@ typedef struct ManchesterDecoderStates {
      * by increased by 2 on long intervals
      */
     uint8_t phaseState: 1;
-    uint8_t __pad : 7;
+    /**
+     * number of classified but not yet decoded intervals
+     */
+    uint8_t numberPendingIntervals : 3;
+    /**
+     * number of decoded bits not yet stored to the reception buffer
+     */
+    uint8_t numberAccumulatedBits : 3;
+    uint8_t __pad : 1;
+    /**
+     * classes of the pending intervals: bit i is set if the i-th interval is short
+     */
+    uint8_t pendingShortIntervals : 4;
+    /**
+     * edges terminating the pending intervals: bit i is set if the i-th edge is rising
+     */
+    uint8_t pendingRisingEdges : 4;
+    /**
+     * decoded bits not yet stored to the reception buffer, least significant bit first
+     */
+    uint8_t bitAccumulator;
+    /**
+     * the clock delay shift of the current reception, classified by its 1st interval
+     */
+    uint8_t clockDelayShift : 2;
+    uint8_t __pad1 : 6;
+#ifdef MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END
+    /**
+     * the number of bits of the current reception implied by its header id, 0 if the header has
+     * not been decoded yet
+     */
+    uint8_t expectedNumberBits;
+#endif
 } ManchesterDecoderStates;
 
 /**
@@ -55,6 +87,10 @@ typedef struct Snapshot {
 /**
  * The struct is used as buffer for storing timestamps of received pin change interrupts.
  * The timestamps are then decoded to bits and stored to a RxBuffer struct.
+ * The buffer is a single producer (reception ISR), single consumer (decoder) ring: the ISR writes
+ * the end index only, the decoder the start index only. Both indices run freely and are mapped
+ * to buffer positions by MANCHESTER_DECODING_RX_SNAPSHOTS_INDEX_MASK, thus the number of buffered
+ * snapshots is (uint8_t) (endIndex - startIndex).
  */
 typedef struct RxSnapshotBuffer {
     /**
@@ -70,15 +106,25 @@ typedef struct RxSnapshotBuffer {
      */
     uint16_t temporarySnapshotTimerValue;
     /**
-     * field describes the 1st buffered position
+     * timer/counter values of the last two captured snapshots, including the least significant bit:
+     * [0] the last, [1] the one before
      */
-    volatile uint8_t startIndex : 7;
-    volatile uint8_t __pad : 1;
+    volatile uint16_t lastSnapshotsTimerValue[2];
     /**
-     * describes the 1st invalid buffer position
+     * compare values of the time tracking ISR when the last two snapshots were captured: [0] the
+     * last, [1] the one before
      */
-    volatile uint8_t endIndex : 7;
+    volatile uint16_t lastSnapshotsLocalTimeInterruptCompareValue[2];
+    /**
+     * index of the 1st buffered snapshot
+     */
+    volatile uint8_t startIndex;
+    /**
+     * index after the last buffered snapshot
+     */
+    volatile uint8_t endIndex;
     volatile uint8_t isOverflowed : 1;
+    volatile uint8_t __pad : 7;
     /**
      * number of passed half cycles reflects the number of π's passed from 1st snapshot
      * until the last snapshot before timeout
@@ -24,6 +24,15 @@ void constructSnapshot(Snapshot *const o) {
 void constructManchesterDecoderState(ManchesterDecoderStates *const o) {
     o->decodingState = DECODER_STATE_TYPE_START;
     o->phaseState = 0;
+    o->numberPendingIntervals = 0;
+    o->numberAccumulatedBits = 0;
+    o->pendingShortIntervals = 0;
+    o->pendingRisingEdges = 0;
+    o->bitAccumulator = 0;
+    o->clockDelayShift = 0;
+#ifdef MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END
+    o->expectedNumberBits = 0;
+#endif
 }
 
 /**
@@ -35,6 +44,10 @@ void constructRxSnapshotBuffer(RxSnapshotBuffer *const o) {
     o->startIndex = 0;
     o->endIndex = 0;
     o->temporarySnapshotTimerValue = 0;
+    o->lastSnapshotsTimerValue[0] = 0;
+    o->lastSnapshotsTimerValue[1] = 0;
+    o->lastSnapshotsLocalTimeInterruptCompareValue[0] = 0;
+    o->lastSnapshotsLocalTimeInterruptCompareValue[1] = 0;
     o->isOverflowed = false;
     o->numberHalfCyclesPassed = 0;
 }
@@ -9,70 +9,105 @@
 #include "common/common.h"
 #include "uc-core/configuration/interrupts/TxRxTimer.h"
 #include "simulation/SimulationMacros.h"
+#include "uc-core/synchronization/Calculation.h"
 
 /**
- * Schedules the next transmission interrupt.
- * Write to TIMER_TX_RX_COMPARE_VALUE is not atomic.
- * Typically called within an ISR.
+ * Evaluates the clock delay shift the transmission of the given port is performed at.
+ * Time synchronization packages and broadcasts are transmitted at the default clock delay.
+ * @param port the transmission port
  */
-void scheduleNextTxInterrupt(void) {
-    TIMER_TX_RX_COMPARE_VALUE +=
-            ParticleAttributes.communication.timerAdjustment.transmissionClockDelayHalf;
+static uint8_t __transmissionClockDelayShift(const TxPort *const port) {
+    if (port->isDefaultClockDelayForced || ParticleAttributes.protocol.isBroadcastEnabled) {
+        return 0;
+    }
+    const LinkRates *const linkRates = &ParticleAttributes.communication.timerAdjustment.linkRates;
+    if (port == &ParticleAttributes.communication.ports.tx.north) {
+        return linkRates->north.clockDelayShift;
+    } else if (port == &ParticleAttributes.communication.ports.tx.south) {
+        return linkRates->south.clockDelayShift;
+    } else if (ParticleAttributes.protocol.isSimultaneousTransmissionEnabled) {
+        return linkRates->simultaneous.clockDelayShift;
+    }
+    return linkRates->east.clockDelayShift;
 }
 
 /**
- * Schedules the next transmission start interrupt with atomic read/write to TIMER_TX_RX_COUNTER_VALUE.
+ * Evaluates whether the port's next signal edge is due at the given timer/counter value.
+ * @param port the transmission port
+ * @param counterValue the timer/counter value to compare the deadline to
  */
-static void __scheduleStartTxInterrupt(void) {
-    const uint16_t delay = ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay * 2;
-    uint8_t sreg = SREG;
-    MEMORY_BARRIER;
-    CLI;
-    MEMORY_BARRIER;
-    TIMER_TX_RX_COMPARE_VALUE =
-            TIMER_TX_RX_COUNTER_VALUE + delay;
-//            ParticleAttributes.communication.timerAdjustment.transmissionClockDelay * 2;
-    MEMORY_BARRIER;
-    SREG = sreg;
-    MEMORY_BARRIER;
-    TIMER_TX_RX_ENABLE_COMPARE_INTERRUPT;
+static inline bool isTransmissionEdgeDue(const TxPort *const port, const uint16_t counterValue) {
+    return port->isTransmitting && (int16_t) (counterValue - port->nextEdgeDeadline) >= 0;
+}
+
+/**
+ * Evaluates the earliest deadline of all transmitting ports. On simultaneous transmission the
+ * east port's buffer is transmitted on east and south, thus the south port is not considered.
+ * @param deadline reference to the deadline to be updated
+ * @return true if any port is transmitting, false otherwise
+ */
+bool earliestTransmissionDeadline(uint16_t *const deadline) {
+    const TxPorts *const ports = &ParticleAttributes.communication.ports.tx;
+    const TxPort *const candidates[] = {&ports->north, &ports->east, &ports->south};
+    const uint8_t numberCandidates =
+            ParticleAttributes.protocol.isSimultaneousTransmissionEnabled ? 2 : 3;
+    bool isTransmitting = false;
+    for (uint8_t idx = 0; idx < numberCandidates; idx++) {
+        if (!candidates[idx]->isTransmitting) {
+            continue;
+        }
+        if (!isTransmitting || (int16_t) (candidates[idx]->nextEdgeDeadline - *deadline) < 0) {
+            *deadline = candidates[idx]->nextEdgeDeadline;
+        }
+        isTransmitting = true;
+    }
+    return isTransmitting;
 }
 
 /**
- * Activates the designated port to contribute to the next transmission until
- * there is no more data to transmit.
+ * Activates the designated port to transmit its buffer until there is no more data to transmit.
+ * Each port is clocked independently at its link rate: the port's first edge is scheduled
+ * independently of other ongoing transmissions, and the shared compare unit is re-armed if the
+ * new deadline is the earliest one.
  * @param port the designated transmission port to read the buffer and transmit from
  */
 void enableTransmission(TxPort *const port) {
-//    uint8_t sreg = SREG;
-//    MEMORY_BARRIER;
-//    CLI;
-//    MEMORY_BARRIER;
     DEBUG_CHAR_OUT('t');
-    bool startTransmission = true;
-    // on already ongoing transmission: no need to schedule a transmission start
-    if (ParticleAttributes.directionOrientedPorts.north.txPort->isTransmitting ||
-        ParticleAttributes.directionOrientedPorts.east.txPort->isTransmitting ||
-        ParticleAttributes.directionOrientedPorts.south.txPort->isTransmitting) {
-        startTransmission = false;
+    TransmissionTimerAdjustment *const timerAdjustment = &ParticleAttributes.communication.timerAdjustment;
+
+    // update new transmission baud rate: ongoing transmissions keep their clock delay
+    if (timerAdjustment->isTransmissionClockDelayUpdateable) {
+        timerAdjustment->transmissionClockDelay = calculationRound(timerAdjustment->newTransmissionClockDelay);
+        timerAdjustment->transmissionClockDelayHalf = calculationRound(timerAdjustment->newTransmissionClockDelayHalf);
+        MEMORY_BARRIER;
+        timerAdjustment->isTransmissionClockDelayUpdateable = false;
     }
+    const uint8_t clockDelayShift = __transmissionClockDelayShift(port);
+    const uint16_t startDelay =
+            ((uint16_t) calculationToInteger(timerAdjustment->newTransmissionClockDelay * 2)) >> clockDelayShift;
+
+    uint8_t sreg = SREG;
+    MEMORY_BARRIER;
+    CLI;
+    MEMORY_BARRIER;
+    uint16_t deadline = 0;
+    const bool isTransmissionOngoing = earliestTransmissionDeadline(&deadline);
+    port->clockDelayHalf = timerAdjustment->transmissionClockDelayHalf >> clockDelayShift;
+    port->nextEdgeDeadline = TIMER_TX_RX_COUNTER_VALUE + startDelay;
     port->isTxClockPhase = true;
     port->isTransmitting = true;
     port->isDataBuffered = true;
     MEMORY_BARRIER;
-    if (startTransmission) {
+    if (!isTransmissionOngoing) {
         LED_STATUS4_TOGGLE;
-        // update new transmission baud rate
-        if (ParticleAttributes.communication.timerAdjustment.isTransmissionClockDelayUpdateable) {
-            ParticleAttributes.communication.timerAdjustment.transmissionClockDelay =
-                    roundf(ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay);
-            ParticleAttributes.communication.timerAdjustment.transmissionClockDelayHalf =
-                    roundf(ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelayHalf);
-            MEMORY_BARRIER;
-            ParticleAttributes.communication.timerAdjustment.isTransmissionClockDelayUpdateable = false;
-        }
-        __scheduleStartTxInterrupt();
+        TIMER_TX_RX_COMPARE_VALUE = port->nextEdgeDeadline;
+        MEMORY_BARRIER;
+        TIMER_TX_RX_ENABLE_COMPARE_INTERRUPT;
+    } else if ((int16_t) (port->nextEdgeDeadline - deadline) < 0) {
+        // the pending compare match must not be cleared: other ports' due edges are served late
+        TIMER_TX_RX_COMPARE_VALUE = port->nextEdgeDeadline;
     }
-//    MEMORY_BARRIER;
-//    SREG = sreg;
+    MEMORY_BARRIER;
+    SREG = sreg;
+    MEMORY_BARRIER;
 }
@@ -15,6 +15,77 @@
 
 #define COMMUNICATION_PROTOCOL_RETRANSMISSION_COUNTER_MAX ((uint8_t)3)
 
+/**
+ * If defined, heat wires, heat wires range and header packages are relayed while being received:
+ * the transmission starts as soon as the header and address bytes are decoded, the remaining bytes
+ * are forwarded as they arrive. The last bit is held back until the package's parity is verified.
+ * Disabled by default: the relay state costs SRAM on each port. May be enabled by the build
+ * (i.e. -DCOMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY).
+ */
+//#define COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+
+/**
+ * If defined, payloads exceeding a package are transferred to a node as sequence of fragment
+ * packages (extended header id) and reassembled at the destination.
+ * Requires COMMUNICATION_ENABLE_TX_FRAME_QUEUE.
+ * Disabled by default: the reassembly buffer costs
+ * COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES of SRAM. May be enabled by the build
+ * (i.e. -DCOMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION).
+ */
+//#define COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+/**
+ * Size of the reassembly buffer, thus the max. number of bytes per fragmented transfer.
+ * Reasonable values are ∈ [6, 80].
+ */
+#define COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES 40
+
+/**
+ * If defined, a list of heat wires commands (heat wires batch) is forwarded as fragmented transfer
+ * from node to node. Each node schedules its own entry, splits the remaining entries into the east
+ * and south bound sub-lists and forwards each sub-list to the respective neighbour only.
+ * Requires COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION.
+ * Disabled by default: the forwarding state costs SRAM. May be enabled by the build
+ * (i.e. -DCOMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH).
+ */
+//#define COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+
+/**
+ * If defined, a heat wires command is sent to an arbitrary set of nodes (heat wires multicast)
+ * given as run-length encoded bitmap of the lattice. Each node evaluates its own bit and forwards
+ * the multicast to the east and south neighbour only if a bit of the respective subtree is set.
+ * Requires COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH.
+ * Disabled by default to save program memory. May be enabled by the build
+ * (i.e. -DCOMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_MULTICAST).
+ */
+//#define COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_MULTICAST
+
+/**
+ * If defined, packages transmitted from the transmission frame queues are secured hop by hop:
+ * a receiver answers a package failing the frame check with a negative acknowledge (NACK) package.
+ * The sender keeps the package in the port's transmission buffer and retransmits it on NACK
+ * received within the retransmission window. Meanwhile the port's next package is held back.
+ * Requires COMMUNICATION_ENABLE_TX_FRAME_QUEUE.
+ * Disabled by default: the retransmission state costs SRAM on each port. May be enabled by the
+ * build (i.e. -DCOMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION).
+ */
+//#define COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+
+/**
+ * Number of Manchester clocks at the package's link rate a transmitted package is kept for
+ * retransmission. The window must exceed the latency of the NACK's first edge, i.e. the
+ * receiver's end of package detection and interpretation plus the NACK's transmission start
+ * delay. A reception in progress at the window's end keeps the window open until interpreted.
+ * Reasonable values are ∈ [6, 12].
+ */
+#define COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_WINDOW_CLOCKS 8
+
+/**
+ * Max. number of retransmissions per package.
+ * Reasonable values are ∈ [1, 3].
+ */
+#define COMMUNICATION_PROTOCOL_HOP_RETRANSMISSION_MAX 2
+
 /**
  * When a time synchronization package is broadcasted, each mcu introduces a lag of
  * approximate 6.5µS. Thus for 8MHz osc: 0.0065*8 = ~0.052clocks.
@@ -54,9 +54,116 @@
 //#define COMMUNICATION_DEFAULT_MAX_LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO ((uint8_t) 1.12)
 #define COMMUNICATION_DEFAULT_MAX_LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO ((float) 1.25)
 
+/**
+ * If defined, neighbours negotiate the link's clock delay during enumeration: the enumerating
+ * particle probes progressively shorter clock delays (COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY >> shift)
+ * and the link settles on the shortest one whose probe samples' variance stays within budget.
+ * Time synchronization packages and broadcasts are always transmitted at the default clock delay.
+ * Disabled by default: the probe round-trips more than double the enumeration latency while
+ * broadcasts and synchronization packages do not profit. May be enabled by the build
+ * (i.e. -DCOMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION).
+ */
+//#define COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+
+/**
+ * Maximum clock delay shift to probe: the fastest link clock is 2^shift times the default one.
+ * Reasonable values are ∈ [0, 2].
+ */
+#define COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT 2
+
+#if COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT > 3
+#  error COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT must not exceed 3
+#endif
+
+/**
+ * Number of probes to be accepted per clock delay shift. The receptionist evaluates the variance
+ * of the probes' reception durations.
+ * More probes tighten the variance estimate at the cost of enumeration latency.
+ * Reasonable values are ∈ [2, 7].
+ */
+#define COMMUNICATION_LINK_RATE_NUMBER_PROBES 2
+
+/**
+ * A clock delay shift is accepted if the probes' reception duration standard deviation does not exceed
+ * the decoding margin divided by this ratio. The decoding margin is the distance of a short interval
+ * to the maximum short interval duration at the link's clock delay.
+ */
+#define COMMUNICATION_LINK_RATE_DECODING_MARGIN_TO_STD_DEVIANCE_RATIO 4
+
+/**
+ * The transmission ports share one timer compare unit which is multiplexed earliest deadline first.
+ * Signal edges due within this number of timer/counter ticks are transmitted within the same
+ * interrupt, since a compare value set to an already passed counter value matches one timer
+ * overflow late only. Must be shorter than the shortest half clock delay.
+ */
+#define COMMUNICATION_TX_DEADLINE_MIN_LEAD ((uint16_t) 32)
+
+/**
+ * If defined, relayed and originated packages are enqueued per port as frames of a fixed size
+ * pool instead of blocking the node's state machine until their transmission has finished.
+ * Disabled by default: the frame pool costs COMMUNICATION_TX_FRAME_POOL_SIZE transmission buffers
+ * of SRAM. May be enabled by the build (i.e. -DCOMMUNICATION_ENABLE_TX_FRAME_QUEUE).
+ */
+//#define COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+
+/**
+ * Number of transmission frames shared by all port queues.
+ * Reasonable values are ∈ [1, 8].
+ */
+#define COMMUNICATION_TX_FRAME_POOL_SIZE 4
+
+/**
+ * Maximum number of frames enqueued per port, must be a power of two.
+ * Reasonable values are ∈ {1, 2, 4}.
+ */
+#define COMMUNICATION_TX_FRAME_QUEUE_SIZE 4
+
+#if COMMUNICATION_TX_FRAME_POOL_SIZE > 8
+#  error COMMUNICATION_TX_FRAME_POOL_SIZE must not exceed 8
+#endif
+
+#if COMMUNICATION_TX_FRAME_QUEUE_SIZE > 4 || \
+    (COMMUNICATION_TX_FRAME_QUEUE_SIZE & (COMMUNICATION_TX_FRAME_QUEUE_SIZE - 1)) != 0
+#  error COMMUNICATION_TX_FRAME_QUEUE_SIZE must be one of 1, 2 or 4
+#endif
+
+/**
+ * If defined, each package is followed by a CRC-8 trailer instead of carrying an even parity bit
+ * in its header. The receiver updates the CRC while decoding and strips the trailer. Packages
+ * failing the frame check are discarded and counted per port, the node keeps operating.
+ */
+#define COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+
+/**
+ * If defined, packages of the types selected by COMMUNICATION_ERROR_CORRECTION_HEADER_IDS are
+ * followed by an extended Hamming trailer after the CRC-8 trailer. The receiver corrects single
+ * bit errors before the frame check, thus long relay chains lose fewer packages at the cost of
+ * one more byte per selected package. Selected packages are marked by the header's parity bit.
+ */
+//#define COMMUNICATION_ENABLE_ERROR_CORRECTION
+
+/**
+ * Bit mask of the header ids of packages to be transmitted with error correction trailer, bit n
+ * selects header id n. Synchronization, enumeration, acknowledge, link rate and NACK packages
+ * stay uncoded. Default selection: header, set network geometry, heat wires, heat wires mode
+ * and extended header (fragment) packages.
+ */
+#define COMMUNICATION_ERROR_CORRECTION_HEADER_IDS ((uint16_t) ((1 << 1) | (1 << 7) | (1 << 10) | (1 << 11) | (1 << 15)))
+
+#if defined(COMMUNICATION_ENABLE_ERROR_CORRECTION) && !defined(COMMUNICATION_ENABLE_CRC8_FRAME_CHECK)
+#  error COMMUNICATION_ENABLE_ERROR_CORRECTION requires COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+#endif
+
 /**
  * Number of buffer bytes for reception and transmission. Received snapshots are decoded to
  * the reception buffer. Data to be sent is read from the transmission buffer.
+ * The CRC-8 frame check trailer and the error correction trailer need one more byte each.
  */
-#define COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES 9
+#if defined(COMMUNICATION_ENABLE_ERROR_CORRECTION)
+#  define COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES 11
+#elif defined(COMMUNICATION_ENABLE_CRC8_FRAME_CHECK)
+#  define COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES 10
+#else
+#  define COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES 9
+#endif
 
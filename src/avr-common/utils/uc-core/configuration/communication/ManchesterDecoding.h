@@ -8,20 +8,52 @@
 
 /**
  * If defined enables merging the high bits [15:1] of the time stamp with
- * the edge direction bit to one uint8_t which uses 1/3 less memory for
+ * the edge direction bit to one uint16_t which uses 1/3 less memory for
  * decoding buffer but looses the least significant bit for timestamp accuracy.
  */
-//#define MANCHESTER_DECODING_ENABLE_MERGE_TIMESTAMP_WITH_EDGE_DIRECTION
+#define MANCHESTER_DECODING_ENABLE_MERGE_TIMESTAMP_WITH_EDGE_DIRECTION
 
 /**
- * Size of reception snapshot buffer per port.
+ * Size of reception snapshot buffer per port. Must be a power of two, at most 128.
  */
 // 88% snapshots buffer of 9 byte PDU max. events
-//#define MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS 127
+//#define MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS 128
 // 44% snapshots buffer of max. 9 byte PDU max. events
 //#define MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS 64
 // 22% snapshots buffer of 9 byte PDU max. events
-//#define MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS 32
-// 20% snapshots buffer of 9 byte PDU max. events
-#define MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS 29
+#define MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS 32
 
+#if (MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS & (MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS - 1)) != 0 || \
+    MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS > 128
+#  error MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS must be a power of two, at most 128
+#endif
+
+/**
+ * maps the free running snapshot buffer indices to buffer positions
+ */
+#define MANCHESTER_DECODING_RX_SNAPSHOTS_INDEX_MASK (MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS - 1)
+
+
+/**
+ * If defined, each reception port decodes to a second buffer while the previously received
+ * package is still buffered for interpretation. The decoded package is handed over to the
+ * interpreter as soon as the reception buffer is released.
+ * Disabled by default: the second buffer costs SRAM on each port. May be enabled by the build
+ * (i.e. -DMANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION).
+ */
+//#define MANCHESTER_DECODING_ENABLE_DOUBLE_BUFFERED_RECEPTION
+
+/**
+ * Number of buffered snapshots at which a decoded package still waiting for the reception
+ * buffer is dropped in favour of the subsequent reception, before the snapshot buffer overflows.
+ */
+#define MANCHESTER_DECODING_RX_DROP_PACKAGE_NUMBER_SNAPSHOTS ((MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS * 3) / 4)
+
+/**
+ * If defined, a reception ends as soon as the number of bits implied by its header id has been
+ * decoded instead of after two clocks without edge. Receptions of variable length and receptions
+ * measured for synchronization or link rate negotiation still end by the timeout.
+ * Disabled by default: the expected length is tracked on each port. May be enabled by the build
+ * (i.e. -DMANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END).
+ */
+//#define MANCHESTER_DECODING_ENABLE_EXPECTED_LENGTH_FRAME_END
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "uc-core/configuration/communication/Communication.h"
+
 /**
  * The difference of measured synchronization package durations are shifted by the synthetic offset UINT16_MAX/2=0x7fff
  * to overcome the need of signed data types.
@@ -20,14 +22,28 @@
 #define SYNCHRONIZATION_TIME_PACKAGE_DURATION_COUNTING_FIRST_TO_LAST_BIT_EDGE
 
 /**
- * Mean calculation on-line vs off-line.
- * Uses more flash memory, may speed up the synchronization approximation slightly.
+ * Synchronization arithmetic. The fixed-point calculation (see synchronization/Calculation.h) avoids
+ * software emulated floating point operations and libm on the MCU. The floating point calculation
+ * may be selected by the build (i.e. -DSYNCHRONIZATION_ENABLE_FLOAT_CALCULATION).
  */
-//#define SYNCHRONIZATION_STRATEGY_MEAN_ENABLE_ONLINE_CALCULATION
+#if !defined(SYNCHRONIZATION_ENABLE_FLOAT_CALCULATION)
+#define SYNCHRONIZATION_ENABLE_FIXED_POINT_CALCULATION
+#endif
 
 /**
- * Synchronization strategy.
+ * Synchronization strategy. A strategy may also be selected by the build (i.e. -DSYNCHRONIZATION_STRATEGY_MEAN),
+ * then the default below is not applied.
  */
+#if !defined(SYNCHRONIZATION_STRATEGY_RAW_OBSERVATION) \
+ && !defined(SYNCHRONIZATION_STRATEGY_MEAN) \
+ && !defined(SYNCHRONIZATION_STRATEGY_PROGRESSIVE_MEAN) \
+ && !defined(SYNCHRONIZATION_STRATEGY_MEAN_WITHOUT_OUTLIER) \
+ && !defined(SYNCHRONIZATION_STRATEGY_MEAN_WITHOUT_MARKED_OUTLIER) \
+ && !defined(SYNCHRONIZATION_ENABLE_ADAPTIVE_MARKED_OUTLIER_REJECTION) \
+ && !defined(SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING) \
+ && !defined(SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE) \
+ && !defined(SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN) \
+ && !defined(SYNCHRONIZATION_STRATEGY_MEDIAN)
 //#define SYNCHRONIZATION_STRATEGY_RAW_OBSERVATION
 #define SYNCHRONIZATION_STRATEGY_MEAN
 //#define SYNCHRONIZATION_STRATEGY_PROGRESSIVE_MEAN
@@ -35,15 +51,45 @@
 //#define SYNCHRONIZATION_STRATEGY_MEAN_WITHOUT_MARKED_OUTLIER
 //#define SYNCHRONIZATION_ENABLE_ADAPTIVE_MARKED_OUTLIER_REJECTION
 //#define SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING
+//#define SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+//#define SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN
+//#define SYNCHRONIZATION_STRATEGY_MEDIAN
+#endif
+
+/**
+ * The strategies evaluating the FiFo's mean or deviation track the FiFo's statistics on-line: each
+ * sample entering and leaving the FiFo updates them in constant time (see synchronization/SamplesFifo.h).
+ */
+#if defined(SYNCHRONIZATION_STRATEGY_MEAN) \
+ || defined(SYNCHRONIZATION_STRATEGY_MEAN_WITHOUT_OUTLIER) \
+ || defined(SYNCHRONIZATION_STRATEGY_MEAN_WITHOUT_MARKED_OUTLIER) \
+ || defined(SYNCHRONIZATION_ENABLE_ADAPTIVE_MARKED_OUTLIER_REJECTION)
+#  define __SYNCHRONIZATION_ENABLE_SAMPLE_STATISTICS
+#endif
+
+/**
+ * The strategies evaluating order statistics keep the FiFo's samples sorted (see synchronization/SortedSamples.h).
+ */
+#if defined(SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN) \
+ || defined(SYNCHRONIZATION_STRATEGY_MEDIAN)
+#  define __SYNCHRONIZATION_ENABLE_SORTED_SAMPLES
+#endif
 
 /**
  * Defines the factor f for outlier detection. Samples having values not within
  * [µ - f * σ, µ + f * σ] are rejected.
  */
-//#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((CalculationType) 3.0)
-//#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((CalculationType) 2.8)
-#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((CalculationType) 2.0)
-//#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((CalculationType) 1.0)
+//#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((float) 3.0)
+//#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((float) 2.8)
+#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((float) 2.0)
+//#define SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR ((float) 1.0)
+
+/**
+ * Defines the number of the smallest and of the largest FiFo samples each, the trimmed mean excludes.
+ * Trimming a quarter on both sides yields the interquartile mean, which is robust against bursts
+ * of up to a quarter of the FiFo's samples being outlier.
+ */
+#define SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS / 4)
 
 /**
  * Defines the number of manchester clocks in the reference time PDU. Instead measuring the whole package
@@ -68,12 +114,24 @@
 #define __SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL_FIRST_FALLING_TO_LAST_EDGE_640 ((float) 64.0)
 
 
+/**
+ * Defines the number of manchester clocks the frame check trailer extends the time PDU by.
+ * The time package's stuffing is chosen such that the trailer's last bit is cleared.
+ */
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+#  define __SYNCHRONIZATION_PDU_NUMBER_FRAME_CHECK_CLOCKS ((float) 8.0)
+#else
+#  define __SYNCHRONIZATION_PDU_NUMBER_FRAME_CHECK_CLOCKS ((float) 0.0)
+#endif
+
 #ifdef SYNCHRONIZATION_TIME_PACKAGE_DURATION_COUNTING_FIRST_TO_LAST_BIT_EDGE
 #  define SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL \
-    __SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL_FIRST_RISING_TO_LAST_FALLING_EDGE_630
+    (__SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL_FIRST_RISING_TO_LAST_FALLING_EDGE_630 + \
+     __SYNCHRONIZATION_PDU_NUMBER_FRAME_CHECK_CLOCKS)
 #else
 #  define SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL \
-    __SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL_FIRST_FALLING_TO_LAST_EDGE_640
+    (__SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL_FIRST_FALLING_TO_LAST_EDGE_640 + \
+     __SYNCHRONIZATION_PDU_NUMBER_FRAME_CHECK_CLOCKS)
 #endif
 
 
@@ -89,3 +147,26 @@
 #define SYNCHRONIZATION_STRATEGY_MEAN_OLD_VALUE_WEIGHT __SYNCHRONIZATION_STRATEGY_MEAN_OLD_VALUE_WEIGHT
 #define SYNCHRONIZATION_STRATEGY_MEAN_NEW_VALUE_WEIGHT __SYNCHRONIZATION_STRATEGY_MEAN_NEW_VALUE_WEIGHT
 #endif
+
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+/**
+ * Steady state gains of the skew filter's states: the observed PDU duration and its drift per sample.
+ * The drift gain is chosen for critical damping: drift gain = duration gain² / (2 - duration gain).
+ */
+#define SYNCHRONIZATION_CLOCK_DISCIPLINE_DURATION_GAIN ((float) 0.25)
+#define SYNCHRONIZATION_CLOCK_DISCIPLINE_DRIFT_GAIN ((float) 0.03125)
+/**
+ * Proportional gain of the phase offset: the fraction of the observed phase offset the local time
+ * tracking ISR is shifted by.
+ */
+#define SYNCHRONIZATION_CLOCK_DISCIPLINE_PHASE_GAIN ((float) 0.5)
+/**
+ * Integral gain of the phase offset: the fraction of the observed phase offset the local time tracking
+ * ISR delay is trimmed by. The trim compensates the skew the PDU duration observation is biased by.
+ */
+#define SYNCHRONIZATION_CLOCK_DISCIPLINE_PHASE_INTEGRAL_GAIN ((float) 0.0625)
+/**
+ * Limits the local time tracking ISR delay trim in clocks.
+ */
+#define SYNCHRONIZATION_CLOCK_DISCIPLINE_MAX_PERIOD_TRIM ((int16_t) 512)
+#endif
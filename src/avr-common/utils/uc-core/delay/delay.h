@@ -9,17 +9,26 @@
 
 #include <stdint.h>
 
+#ifndef __AVR__
+#  include <util/delay_basic.h>
+#endif
+
 extern inline void __delay_loop_2(uint16_t __count);
 /**
  * non static inline delay loop to be used in non static inline functions
  */
 inline void __delay_loop_2(uint16_t __count) {
+#ifdef __AVR__
     __asm__ volatile (
     "1: sbiw %0,1" "\n\t"
             "brne 1b"
     : "=w" (__count)
     : "0" (__count)
     );
+#else
+    // accounted to the virtual MCU instead of busy waiting on the build host
+    _delay_loop_2(__count);
+#endif
 }
 
 #define DELAY_US_5 \
@@ -155,31 +155,62 @@ static bool __incrementAndSetNextHeatWiresAddress(void) {
 }
 
 /**
- * triggers the sending of the next actuation (heat wires) command
+ * Restarts the address traversal and enables the cyclic sync. pkg. once all nodes have been actuated.
+ */
+static void __finishHeatWiresTraversal(SchedulerTask *const task) {
+    ParticleAttributes.evaluation.nextHeatWiresAddress.row = 1;
+    ParticleAttributes.evaluation.nextHeatWiresAddress.column = 1;
+
+    addCyclicTask(SCHEDULER_TASK_ID_SYNC_PACKAGE, sendNextSyncTimePackageTask, task->startTimestamp + 100,
+                  100);
+    taskEnableNodeTypeLimit(SCHEDULER_TASK_ID_SYNC_PACKAGE, NODE_TYPE_ORIGIN);
+    taskEnableCountLimit(SCHEDULER_TASK_ID_SYNC_PACKAGE, 20);
+    taskEnable(SCHEDULER_TASK_ID_SYNC_PACKAGE);
+    taskDisable(SCHEDULER_TASK_ID_HEAT_WIRES);
+}
+
+/**
+ * triggers the sending of the next actuation (heat wires) command, or of the next batch of
+ * actuation commands if heat wires batches are enabled
  */
 void heatWiresTask(SchedulerTask *const task) {
+    Actuators actuators;
+    actuators.northLeft = true;
+    actuators.northRight = true;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+    if (!isHeatWiresTransferSendable()) {
+        // on last batch still being forwarded: retry on next call
+        return;
+    }
+    HeatWiresBatchEntry entries[HEAT_WIRES_BATCH_MAX_NUMBER_ENTRIES];
+    uint8_t numberEntries = 0;
+    while (numberEntries < HEAT_WIRES_BATCH_MAX_NUMBER_ENTRIES && __incrementAndSetNextHeatWiresAddress()) {
+        NodeAddress nodeAddress;
+        nodeAddress.row = ParticleAttributes.evaluation.nextHeatWiresAddress.row;
+        nodeAddress.column = ParticleAttributes.evaluation.nextHeatWiresAddress.column;
+        constructHeatWiresBatchEntry(&entries[numberEntries], &nodeAddress, &actuators,
+                                     task->startTimestamp + 50, 100);
+        numberEntries++;
+    }
+    if (numberEntries > 0) {
+        // on having new addresses to traverse
+        sendHeatWiresBatch(entries, numberEntries);
+    } else {
+        // on no more address to traverse
+        __finishHeatWiresTraversal(task);
+    }
+#else
     if (__incrementAndSetNextHeatWiresAddress()) {
         // on having new address to traverse
-        Actuators actuators;
-        actuators.northLeft = true;
-        actuators.northRight = true;
         NodeAddress nodeAddress;
         nodeAddress.row = ParticleAttributes.evaluation.nextHeatWiresAddress.row;
         nodeAddress.column = ParticleAttributes.evaluation.nextHeatWiresAddress.column;
         sendHeatWires(&nodeAddress, &actuators, task->startTimestamp + 50, 100);
+    } else {
+        // on no more address to traverse
+        __finishHeatWiresTraversal(task);
     }
-    else {
-        // on no more address to traverse: enable cyclic sync. pkg.
-        ParticleAttributes.evaluation.nextHeatWiresAddress.row = 1;
-        ParticleAttributes.evaluation.nextHeatWiresAddress.column = 1;
-
-        addCyclicTask(SCHEDULER_TASK_ID_SYNC_PACKAGE, sendNextSyncTimePackageTask, task->startTimestamp + 100,
-                      100);
-        taskEnableNodeTypeLimit(SCHEDULER_TASK_ID_SYNC_PACKAGE, NODE_TYPE_ORIGIN);
-        taskEnableCountLimit(SCHEDULER_TASK_ID_SYNC_PACKAGE, 20);
-        taskEnable(SCHEDULER_TASK_ID_SYNC_PACKAGE);
-        taskDisable(SCHEDULER_TASK_ID_HEAT_WIRES);
-    }
+#endif
 }
 #endif
 
@@ -0,0 +1,62 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * CRC-8 related implementation: reflected polynomial 0x8C, initial value 0 (CRC-8/MAXIM).
+ * Bits are processed least significant bit first as they are transmitted. Bytes are processed
+ * nibble wise by table lookup, which needs 16 instead of 256 bytes of flash.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+/**
+ * The reflected CRC-8 polynomial x^8 + x^5 + x^4 + 1.
+ */
+#define CRC8_REFLECTED_POLYNOMIAL 0x8C
+
+/**
+ * Initial CRC-8 register value.
+ */
+#define CRC8_INITIAL_VALUE 0
+
+/**
+ * Register values after shifting the register's lower nibble out, indexed by the nibble.
+ */
+const uint8_t crc8NibbleTable[16] PROGMEM = {
+        0x00, 0x9d, 0x23, 0xbe, 0x46, 0xdb, 0x65, 0xf8,
+        0x8c, 0x11, 0xaf, 0x32, 0xca, 0x57, 0xe9, 0x74,
+};
+
+/**
+ * Updates the CRC by one byte.
+ * @param crc the current CRC register value
+ * @param byte the byte to process, least significant bit first
+ * @return the updated CRC register value
+ */
+uint8_t crc8UpdateByte(uint8_t crc, const uint8_t byte) {
+    crc ^= byte;
+    crc = (crc >> 4) ^ pgm_read_byte(&crc8NibbleTable[crc & 0x0f]);
+    return (crc >> 4) ^ pgm_read_byte(&crc8NibbleTable[crc & 0x0f]);
+}
+
+/**
+ * Updates the CRC by the lower bits of one byte.
+ * @param crc the current CRC register value
+ * @param bits the bits to process, 1st bit at the least significant position
+ * @param numberBits the number of bits to process ∈ [0, 8]
+ * @return the updated CRC register value
+ */
+uint8_t crc8UpdateBits(uint8_t crc, uint8_t bits, uint8_t numberBits) {
+    for (; numberBits > 0; numberBits--) {
+        crc ^= bits & 1;
+        if (crc & 1) {
+            crc = (crc >> 1) ^ CRC8_REFLECTED_POLYNOMIAL;
+        } else {
+            crc >>= 1;
+        }
+        bits >>= 1;
+    }
+    return crc;
+}
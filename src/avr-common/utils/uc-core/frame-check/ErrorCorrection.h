@@ -0,0 +1,130 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Forward error correction related implementation, see COMMUNICATION_ENABLE_ERROR_CORRECTION.
+ * The bits of a package and its CRC-8 trailer are protected by an extended Hamming (SECDED)
+ * trailer byte. The data bit of index i is assigned to the i-th codeword position being no
+ * power of two, starting at position 3. The trailer's lower seven bits hold the XOR of the
+ * positions of all set data bits, its most significant bit completes an even overall parity.
+ * A single bit error is located by the syndrome and corrected, double bit errors are detected
+ * but left to the frame check. The receiver evaluates the trailer if the header's flag agrees
+ * with the header id's selection only, see particle-error-correction-host-test.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uc-core/communication/CommunicationTypes.h"
+#include "FrameCheckTrailer.h"
+
+/**
+ * The error correction trailer's type.
+ */
+typedef uint8_t ErrorCorrectionType;
+
+/**
+ * The header's parity bit marks packages followed by an error correction trailer.
+ */
+#define ERROR_CORRECTION_HEADER_FLAG_BIT (1 << 6)
+
+/**
+ * Evaluates to the header id of the package's first byte, see HeaderPackage.
+ * @param headerByte the package's first byte
+ */
+#define errorCorrectionHeaderId(headerByte) \
+    (((headerByte) >> 1) & 0x0f)
+
+/**
+ * Evaluates to true if packages of the given header id are transmitted with error correction
+ * trailer, to false otherwise.
+ * @param headerId the package's header id
+ */
+#define isErrorCorrectionSelected(headerId) \
+    ((COMMUNICATION_ERROR_CORRECTION_HEADER_IDS >> (headerId)) & 1)
+
+/**
+ * @param byte the byte to evaluate
+ * @return 1 on odd number of set bits, 0 otherwise
+ */
+static uint8_t __errorCorrectionByteParity(uint8_t byte) {
+    byte ^= byte >> 4;
+    byte ^= byte >> 2;
+    byte ^= byte >> 1;
+    return byte & 1;
+}
+
+/**
+ * Evaluates the XOR of the codeword positions of all set bits and the bits' parity.
+ * @param bytes the buffer
+ * @param numberBits the number of data bits in between buffer start and the trailer
+ * @param parity the parity of the data bits
+ * @return the check bits
+ */
+static uint8_t __errorCorrectionCheckBits(const volatile uint8_t *const bytes, const uint8_t numberBits,
+                                          uint8_t *const parity) {
+    uint8_t checkBits = 0;
+    uint8_t ones = 0;
+    uint8_t position = 3;
+    for (uint8_t idx = 0; idx < numberBits; idx++) {
+        if ((bytes[idx >> 3] >> (idx & 0x07)) & 1) {
+            checkBits ^= position;
+            ones ^= 1;
+        }
+        position++;
+        if ((position & (position - 1)) == 0) {
+            // powers of two are check bit positions
+            position++;
+        }
+    }
+    *parity = ones;
+    return checkBits;
+}
+
+/**
+ * Evaluates the error correction trailer of the bits in between buffer start and the given position.
+ * @param bytes the buffer
+ * @param dataEndPos the position one bit beyond the last bit
+ * @return the trailer
+ */
+ErrorCorrectionType computeErrorCorrection(const volatile uint8_t *const bytes,
+                                           const volatile BufferBitPointer *const dataEndPos) {
+    uint8_t parity;
+    const uint8_t checkBits = __errorCorrectionCheckBits(bytes, bufferBitPointerToNumberBits(dataEndPos), &parity);
+    return checkBits | ((parity ^ __errorCorrectionByteParity(checkBits)) << 7);
+}
+
+/**
+ * Corrects a single bit error of the codeword in place. The trailer is rewritten, thus a relayed
+ * package carries a valid codeword again.
+ * @param bytes the buffer
+ * @param dataEndPos the position of the trailer's first bit
+ * @return true if a bit has been corrected, false otherwise
+ */
+bool correctSingleBitError(volatile uint8_t *const bytes, const volatile BufferBitPointer *const dataEndPos) {
+    const uint8_t numberBits = bufferBitPointerToNumberBits(dataEndPos);
+    const ErrorCorrectionType trailer = readTrailerByte(bytes, dataEndPos);
+    uint8_t parity;
+    const uint8_t syndrome = (__errorCorrectionCheckBits(bytes, numberBits, &parity) ^ trailer) & 0x7f;
+
+    if ((parity ^ __errorCorrectionByteParity(trailer)) == 0) {
+        // on intact codeword or double bit error
+        return false;
+    }
+
+    if ((syndrome & (syndrome - 1)) != 0) {
+        // on data bit error: the position is no power of two
+        uint8_t log2Syndrome = 0;
+        for (uint8_t remainder = syndrome; remainder > 1; remainder >>= 1) {
+            log2Syndrome++;
+        }
+        const uint8_t idx = syndrome - 2 - log2Syndrome;
+        if (idx >= numberBits) {
+            // on more than two bit errors
+            return false;
+        }
+        bytes[idx >> 3] ^= 1 << (idx & 0x07);
+    }
+    writeTrailerByte(bytes, dataEndPos, computeErrorCorrection(bytes, dataEndPos));
+    return true;
+}
@@ -0,0 +1,94 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Frame check related implementation. With COMMUNICATION_ENABLE_CRC8_FRAME_CHECK each package is
+ * followed by a trailer holding the CRC-8 of the package's bits, transmitted least significant
+ * bit first. The receiver updates the CRC while decoding, including the trailer, thus an intact
+ * package leaves a zero residue. Otherwise the package's even parity bit is evaluated.
+ * A package failing the check is counted and discarded by the interpreter.
+ * With COMMUNICATION_ENABLE_ERROR_CORRECTION selected packages are marked by the header's parity
+ * bit and followed by an error correction trailer after the CRC-8 trailer.
+ */
+
+#pragma once
+
+#include "uc-core/configuration/communication/Communication.h"
+#include "uc-core/communication/CommunicationTypes.h"
+#include "simulation/SimulationMacros.h"
+
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+
+#  include "FrameCheckTrailer.h"
+
+#  ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+
+#    include "ErrorCorrection.h"
+
+#  endif
+
+#else
+
+#  include "uc-core/parity/Parity.h"
+
+#endif
+
+/**
+ * Stores the frame check of the TxPort's buffer to the same buffer.
+ * With CRC-8 frame check the trailer is appended at the data end position, which is advanced
+ * beyond the trailer, otherwise the even parity bit is set. With error correction the
+ * correction trailer is appended to packages of selected types too.
+ * The port data and data end position must be set up correctly.
+ * @param txPort the port the package is buffered at
+ */
+void setFrameCheck(TxPort *const txPort) {
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    HeaderPackage *const header = &((Package *) txPort->buffer.bytes)->asHeader;
+#  ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    header->parityBit = isErrorCorrectionSelected(header->id);
+#  else
+    header->parityBit = 0;
+#  endif
+    const FrameCheckType frameCheck = computeFrameCheck(txPort->buffer.bytes, &txPort->dataEndPos);
+    writeTrailerByte(txPort->buffer.bytes, &txPort->dataEndPos, frameCheck);
+    txPort->dataEndPos.byteNumber += sizeof(FrameCheckType);
+#  ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    if (header->parityBit) {
+        const ErrorCorrectionType errorCorrection = computeErrorCorrection(txPort->buffer.bytes,
+                                                                           &txPort->dataEndPos);
+        writeTrailerByte(txPort->buffer.bytes, &txPort->dataEndPos, errorCorrection);
+        txPort->dataEndPos.byteNumber += sizeof(ErrorCorrectionType);
+    }
+#  endif
+#else
+    setEvenParityBit(txPort);
+#endif
+}
+
+/**
+ * Evaluates the frame check of the received package. A failed check is counted at the port but
+ * does not affect the node's operation. Receptions shorter than a header are no frames, i.e. the
+ * discovery pulses of a neighbour not enumerated yet, they are discarded without being counted.
+ * @param rxPort the port the package has been received at
+ * @return true if the package is intact, false otherwise
+ */
+bool isFrameCheckValid(RxPort *const rxPort) {
+    if (rxPort->buffer.pointer.byteNumber == 0) {
+        return false;
+    }
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    if (rxPort->frameCheck == 0) {
+        return true;
+    }
+#else
+    if (isEvenParity(rxPort)) {
+        return true;
+    }
+#endif
+#ifdef SIMULATION
+    DEBUG_CHAR_OUT('9');
+#endif
+    if (rxPort->numberFrameCheckErrors < UINT16_MAX) {
+        rxPort->numberFrameCheckErrors++;
+    }
+    return false;
+}
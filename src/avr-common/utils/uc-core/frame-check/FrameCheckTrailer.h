@@ -0,0 +1,79 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Frame check trailer related implementation. Trailers follow the package's last bit, thus
+ * they are not necessarily byte aligned in the buffer. The functions depend on the buffer
+ * layout only, not on package types, and are shared by the coding and the decoding side.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "uc-core/communication/CommunicationTypes.h"
+#include "Crc8.h"
+
+/**
+ * Evaluates the number of bits in between buffer start and the given position.
+ * @param pointer the position one bit beyond the last bit
+ * @return the number of bits
+ */
+uint8_t bufferBitPointerToNumberBits(const volatile BufferBitPointer *const pointer) {
+    uint8_t numberBits = pointer->byteNumber * 8;
+    for (uint8_t bitMask = pointer->bitMask; bitMask > 1; bitMask >>= 1) {
+        numberBits++;
+    }
+    return numberBits;
+}
+
+/**
+ * Reads the trailer byte starting at the given position.
+ * @param bytes the buffer
+ * @param pointer the position of the trailer's first bit
+ * @return the trailer byte
+ */
+uint8_t readTrailerByte(const volatile uint8_t *const bytes, const volatile BufferBitPointer *const pointer) {
+    const uint8_t shift = bufferBitPointerToNumberBits(pointer) & 0x07;
+    if (shift == 0) {
+        return bytes[pointer->byteNumber];
+    }
+    return (bytes[pointer->byteNumber] >> shift) | (uint8_t) (bytes[pointer->byteNumber + 1] << (8 - shift));
+}
+
+/**
+ * Writes the trailer byte starting at the given position, bits preceding the position are kept.
+ * @param bytes the buffer
+ * @param pointer the position of the trailer's first bit
+ * @param trailer the trailer byte
+ */
+void writeTrailerByte(volatile uint8_t *const bytes, const volatile BufferBitPointer *const pointer,
+                      const uint8_t trailer) {
+    const uint8_t byteNumber = pointer->byteNumber;
+    const uint8_t bitMask = pointer->bitMask;
+    const uint8_t shift = bufferBitPointerToNumberBits(pointer) & 0x07;
+    if (shift == 0) {
+        bytes[byteNumber] = trailer;
+    } else {
+        bytes[byteNumber] = (bytes[byteNumber] & (bitMask - 1)) | (uint8_t) (trailer << shift);
+        bytes[byteNumber + 1] = trailer >> (8 - shift);
+    }
+}
+
+/**
+ * Evaluates the CRC-8 of the bits in between buffer start and the given data end position.
+ * @param bytes the buffer
+ * @param dataEndPos the position one bit beyond the last bit
+ * @return the CRC-8 register value
+ */
+FrameCheckType computeFrameCheck(const volatile uint8_t *const bytes,
+                                 const volatile BufferBitPointer *const dataEndPos) {
+    FrameCheckType frameCheck = CRC8_INITIAL_VALUE;
+    for (uint8_t byte = 0; byte < dataEndPos->byteNumber; byte++) {
+        frameCheck = crc8UpdateByte(frameCheck, bytes[byte]);
+    }
+
+    const uint8_t numberBits = bufferBitPointerToNumberBits(dataEndPos) & 0x07;
+    if (numberBits > 0) {
+        frameCheck = crc8UpdateBits(frameCheck, bytes[dataEndPos->byteNumber], numberBits);
+    }
+    return frameCheck;
+}
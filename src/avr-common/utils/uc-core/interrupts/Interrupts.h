@@ -48,14 +48,40 @@ static inline void __handleInputInterrupt(DirectionOrientedPort *const port,
 }
 
 /**
- * Schedules the next transmission interrupt if transmission data is buffered.
+ * Transmits the port's next signal edge if it is due and advances the port's deadline.
+ * @param port the designated port
+ * @param counterValue the timer/counter value deadlines are compared to
+ */
+static void __transmitOnDeadline(DirectionOrientedPort *const port, const uint16_t counterValue) {
+    if (isTransmissionEdgeDue(port->txPort, counterValue)) {
+        transmit(port);
+        port->txPort->nextEdgeDeadline += port->txPort->clockDelayHalf;
+    }
+}
+
+/**
+ * Transmits all due signal edges earliest deadline first and re-arms the compare unit to the
+ * earliest pending deadline if transmission data is buffered.
+ * Edges due within COMMUNICATION_TX_DEADLINE_MIN_LEAD are transmitted without returning from the ISR.
  */
+static void __transmitAndScheduleNextTransmission(void) {
+    uint16_t deadline = 0;
+    bool isTransmitting;
+    do {
+        const uint16_t counterValue = TIMER_TX_RX_COUNTER_VALUE + COMMUNICATION_TX_DEADLINE_MIN_LEAD;
+        __transmitOnDeadline(&ParticleAttributes.directionOrientedPorts.north, counterValue);
+        if (ParticleAttributes.protocol.isSimultaneousTransmissionEnabled) {
+            __transmitOnDeadline(&ParticleAttributes.directionOrientedPorts.simultaneous, counterValue);
+        } else {
+            __transmitOnDeadline(&ParticleAttributes.directionOrientedPorts.east, counterValue);
+            __transmitOnDeadline(&ParticleAttributes.directionOrientedPorts.south, counterValue);
+        }
+        isTransmitting = earliestTransmissionDeadline(&deadline);
+    } while (isTransmitting &&
+             (int16_t) (TIMER_TX_RX_COUNTER_VALUE + COMMUNICATION_TX_DEADLINE_MIN_LEAD - deadline) >= 0);
 
-static void __scheduleNextTransmission(void) {
-    if (ParticleAttributes.communication.ports.tx.north.isTransmitting ||
-        ParticleAttributes.communication.ports.tx.east.isTransmitting ||
-        ParticleAttributes.communication.ports.tx.south.isTransmitting) {
-        scheduleNextTxInterrupt();
+    if (isTransmitting) {
+        TIMER_TX_RX_COMPARE_VALUE = deadline;
     } else {
         TIMER_TX_RX_DISABLE_COMPARE_INTERRUPT;
         DEBUG_CHAR_OUT('U');
@@ -133,14 +159,7 @@ ISR(TX_TIMER_INTERRUPT_VECT) {
 
         default:
             // otherwise process transmission
-            if (ParticleAttributes.protocol.isSimultaneousTransmissionEnabled) {
-                transmit(&ParticleAttributes.directionOrientedPorts.simultaneous);
-            } else {
-                transmit(&ParticleAttributes.directionOrientedPorts.north);
-                transmit(&ParticleAttributes.directionOrientedPorts.east);
-                transmit(&ParticleAttributes.directionOrientedPorts.south);
-            }
-            __scheduleNextTransmission();
+            __transmitAndScheduleNextTransmission();
             break;
     }
 }
@@ -158,6 +177,10 @@ ISR(LOCAL_TIME_INTERRUPT_VECT) {
     if (ParticleAttributes.localTime.isTimePeriodInterruptDelayUpdateable) {
         ParticleAttributes.localTime.timePeriodInterruptDelay =
                 ParticleAttributes.localTime.newTimePeriodInterruptDelay;
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+        ParticleAttributes.localTime.timePeriodInterruptDelayFraction =
+                ParticleAttributes.localTime.newTimePeriodInterruptDelayFraction;
+#endif
         ParticleAttributes.localTime.isTimePeriodInterruptDelayUpdateable = false;
     }
 
@@ -169,6 +192,15 @@ ISR(LOCAL_TIME_INTERRUPT_VECT) {
     }
 
     LOCAL_TIME_INTERRUPT_COMPARE_VALUE += ParticleAttributes.localTime.timePeriodInterruptDelay;
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+    // accumulate the delay's fraction, on overflow extend the delay by one clock
+    const uint8_t fractionAccumulator = ParticleAttributes.localTime.__timePeriodInterruptDelayFractionAccumulator +
+                                        ParticleAttributes.localTime.timePeriodInterruptDelayFraction;
+    if (fractionAccumulator < ParticleAttributes.localTime.__timePeriodInterruptDelayFractionAccumulator) {
+        LOCAL_TIME_INTERRUPT_COMPARE_VALUE += 1;
+    }
+    ParticleAttributes.localTime.__timePeriodInterruptDelayFractionAccumulator = fractionAccumulator;
+#endif
 
 #ifdef LOCAL_TIME_IN_PHASE_SHIFTING_ON_LOCAL_TIME_UPDATE
     // consider new clock shift to be considered
@@ -52,13 +52,5 @@ void setEvenParityBit(TxPort *const txPort) {
  * Tests received buffer for even parity.
  */
 bool isEvenParity(const RxPort *const rxPort) {
-    // on even parity
-    if (rxPort->parityBitCounter == 0) {
-        return true;
-    }
-#ifdef SIMULATION
-    DEBUG_CHAR_OUT('9');
-#endif
-    blinkParityErrorForever(rxPort->parityBitCounter);
-    return false;
-}
\ No newline at end of file
+    return rxPort->parityBitCounter == 0;
+}
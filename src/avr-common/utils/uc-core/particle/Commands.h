@@ -9,6 +9,12 @@
 #include "Globals.h"
 #include "uc-core/communication-protocol/Commands.h"
 
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+
+#  include "uc-core/communication-protocol/LinkRateNegotiation.h"
+
+#endif
+
 /**
  * Transmits a new network geometry to the network. Particles outside the new boundary
  * switch to sleep mode.
@@ -47,6 +53,14 @@ void handleEnumerateNeighbour(DirectionOrientedPort *const port,
     // TODO: move function to ParticleCore.h
     CommunicationProtocolPortState *commPortState = port->protocol;
 
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+    if (commPortState->stateTimeoutCounter == 0 &&
+        commPortState->initiatorState == COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE) {
+        // on probe response timeout: settle on the last confirmed rate
+        commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED;
+        commPortState->stateTimeoutCounter = COMMUNICATION_PROTOCOL_TIMEOUT_COUNTER_MAX;
+    }
+#endif
 
     if (commPortState->stateTimeoutCounter == 0 &&
         commPortState->initiatorState != COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT &&
@@ -95,7 +109,64 @@ void handleEnumerateNeighbour(DirectionOrientedPort *const port,
             port->receivePimpl();
             break;
 
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+            // transmit probe at the probed rate
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE: {
+            LinkRateNegotiation *const negotiation = &ParticleAttributes.protocol.linkRateNegotiation;
+            if (negotiation->numberProbes >= COMMUNICATION_LINK_RATE_NUMBER_PROBES) {
+                // on all probes accepted: confirm and probe the next rate
+                negotiation->confirmedClockDelayShift = negotiation->clockDelayShift;
+                if (negotiation->clockDelayShift >= COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT) {
+                    commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED;
+                    goto __COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED;
+                }
+                negotiation->clockDelayShift++;
+                negotiation->numberProbes = 0;
+            }
+            port->linkRate->clockDelayShift = negotiation->clockDelayShift;
+            port->linkRate->maxReceptionClockDelayShift = COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT;
+            constructLinkRatePackage(txPort, negotiation->clockDelayShift, false);
+            enableTransmission(txPort);
+            commPortState->initiatorState =
+                    COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED;
+        }
+            break;
+
+            // wait for tx finished
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED:
+            if (txPort->isTransmitting) {
+                break;
+            }
+            commPortState->stateTimeoutCounter = COMMUNICATION_PROTOCOL_TIMEOUT_COUNTER_MAX;
+            commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE;
+            break;
+
+            // wait for probe response
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+            port->receivePimpl();
+            break;
+
+            // settle on the fastest confirmed rate, the ack is transmitted at this rate
+        __COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
+            port->linkRate->clockDelayShift = ParticleAttributes.protocol.linkRateNegotiation.confirmedClockDelayShift;
+            port->linkRate->maxReceptionClockDelayShift = port->linkRate->clockDelayShift;
+            updateSimultaneousLinkRate();
+            commPortState->initiatorState = COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK;
+            goto __COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK;
+            break;
+#else
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
+            break;
+#endif
+
             // send ack back
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+        __COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK:
+#endif
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK:
             clearTransmissionPortBuffer(txPort);
             constructEnumerationACKPackage(txPort);
@@ -127,6 +198,12 @@ void handleEnumerateNeighbour(DirectionOrientedPort *const port,
  * @param heatingPowerLevel the new power level to set up
  */
 void sendHeatWiresModePackage(HeatingLevelType heatingPowerLevel) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    if (isTxFramePoolExhausted()) {
+        // on back-pressure: skip request
+        return;
+    }
+#endif
     TxPort temporaryPackagePort;
     constructHeatWiresModePackage(&temporaryPackagePort, heatingPowerLevel);
     // interpret the constructed package
@@ -148,6 +225,12 @@ void sendHeatWiresModePackage(HeatingLevelType heatingPowerLevel) {
 void sendHeatWires(const NodeAddress *const nodeAddress, const Actuators *const wires,
                    const uint16_t timeStamp,
                    uint16_t duration) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    if (isTxFramePoolExhausted()) {
+        // on back-pressure: skip request
+        return;
+    }
+#endif
     if (ParticleAttributes.node.address.row > nodeAddress->row &&
         ParticleAttributes.node.address.column > nodeAddress->column) {
         // illegal address
@@ -178,6 +261,12 @@ void sendHeatWiresRange(const NodeAddress *const nodeAddressTopLeft,
                         const NodeAddress *const nodeAddressBottomRight,
                         const Actuators *const wires, const uint16_t timeStamp,
                         const uint16_t duration) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    if (isTxFramePoolExhausted()) {
+        // on back-pressure: skip request
+        return;
+    }
+#endif
 
     if (nodeAddressBottomRight->row < nodeAddressTopLeft->row ||
         nodeAddressBottomRight->column < nodeAddressTopLeft->column) {
@@ -214,15 +303,227 @@ void sendHeatWiresRange(const NodeAddress *const nodeAddressTopLeft,
 }
 
 /**
- * Sends a header package to adjacent neighbours.
+ * Sends a header package to adjacent neighbours. The package is built from the given header's id
+ * and broadcast flag, thus it is followed by its frame check as any other package.
  * @param package the package to send
  */
-void sendHeaderPackage(HeaderPackage *const package) {
-    package->startBit = 1;
-    // interpret the package
-    executeHeaderPackage(package);
+void sendHeaderPackage(const HeaderPackage *const package) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    if (isTxFramePoolExhausted()) {
+        // on back-pressure: skip request
+        return;
+    }
+#endif
+    TxPort temporaryPackagePort;
+    constructHeaderPackage(&temporaryPackagePort, package->id, package->enableBroadcast);
+    // interpret the constructed package
+    executeHeaderPackage((HeaderPackage *) temporaryPackagePort.buffer.bytes);
 }
 
 void sendSyncPackage(void) {
     ParticleAttributes.node.state = STATE_TYPE_RESYNC_NEIGHBOUR;
-}
\ No newline at end of file
+}
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+/**
+ * Sends the next fragment of the ongoing fragmented transfer if a transmission frame is available.
+ * Called once per main loop iteration in idle state.
+ */
+void sendNextFragment(void) {
+    FragmentedTransfer *const transfer = &ParticleAttributes.protocol.fragmentedTransfer;
+    if (!transfer->isActive || isTxFramePoolExhausted()) {
+        return;
+    }
+
+    uint8_t numberPayloadBytes = transfer->numberBytes - transfer->numberSentBytes;
+    if (numberPayloadBytes > FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES) {
+        numberPayloadBytes = FRAGMENT_PACKAGE_MAX_PAYLOAD_BYTES;
+    }
+    const bool isLastFragment = transfer->numberSentBytes + numberPayloadBytes == transfer->numberBytes;
+    NodeAddress nodeAddress;
+    nodeAddress.row = transfer->addressRow;
+    nodeAddress.column = transfer->addressColumn;
+
+    TxPort temporaryPackagePort;
+    constructFragmentPackage(&temporaryPackagePort, &nodeAddress, transfer->transferId, transfer->sequenceNumber,
+                             isLastFragment, (FragmentedTransferContentType) transfer->contentType,
+                             &transfer->payload[transfer->numberSentBytes], numberPayloadBytes);
+    // interpret the constructed package
+    executeFragmentPackage((FragmentPackage *) temporaryPackagePort.buffer.bytes, numberPayloadBytes);
+
+    transfer->numberSentBytes += numberPayloadBytes;
+    transfer->sequenceNumber++;
+    transfer->isActive = !isLastFragment;
+}
+
+/**
+ * Registers the transfer and sends the 1st fragment.
+ * @param addressRow the destination node's row
+ * @param addressColumn the destination node's column
+ * @param payload the payload, must not be modified until the transfer is finished
+ * @param numberBytes the number of payload bytes
+ * @param contentType the payload's content, see {@link FragmentedTransferContentType}
+ */
+static void __startFragmentedTransfer(const uint8_t addressRow, const uint8_t addressColumn,
+                                      const uint8_t *const payload, const uint8_t numberBytes,
+                                      const FragmentedTransferContentType contentType) {
+    FragmentedTransfer *const transfer = &ParticleAttributes.protocol.fragmentedTransfer;
+    transfer->payload = payload;
+    transfer->addressRow = addressRow;
+    transfer->addressColumn = addressColumn;
+    transfer->numberBytes = numberBytes;
+    transfer->numberSentBytes = 0;
+    transfer->transferId++;
+    transfer->sequenceNumber = 0;
+    transfer->contentType = contentType;
+    transfer->isActive = true;
+    sendNextFragment();
+}
+
+/**
+ * Starts a fragmented transfer of the payload to the given node. The fragments are sent one per
+ * main loop iteration as transmission frames become available, see {@link sendNextFragment()}.
+ * The destination address must be route-able from this node on (see {@link sendHeatWires()}),
+ * the payload must not exceed COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES and no other
+ * transfer may be ongoing. Otherwise the request is skipped.
+ * @param nodeAddress the destination node address
+ * @param payload the payload, must not be modified until the transfer is finished
+ * @param numberBytes the number of payload bytes
+ */
+void sendFragmentedTransfer(const NodeAddress *const nodeAddress, const uint8_t *const payload,
+                            const uint8_t numberBytes) {
+    FragmentedTransfer *const transfer = &ParticleAttributes.protocol.fragmentedTransfer;
+    if (transfer->isActive || numberBytes == 0 ||
+        numberBytes > COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES) {
+        return;
+    }
+    if (ParticleAttributes.node.address.row > nodeAddress->row &&
+        ParticleAttributes.node.address.column > nodeAddress->column) {
+        // illegal address
+        return;
+    }
+
+    __startFragmentedTransfer(nodeAddress->row, nodeAddress->column, payload, numberBytes,
+                              FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION);
+}
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+
+/**
+ * Max. number of entries per heat wires batch as limited by the reassembly buffer.
+ */
+#define HEAT_WIRES_BATCH_MAX_NUMBER_ENTRIES \
+    (COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES / sizeof(HeatWiresBatchEntry))
+
+/**
+ * Forwards the executed heat wires batch or multicast: first the east bound bytes to the east
+ * neighbour, then the south bound bytes to the south neighbour, each as soon as no other
+ * fragmented transfer is ongoing. Releases the reassembly buffer afterwards.
+ * Called once per main loop iteration in idle state.
+ */
+void relayHeatWiresTransfer(void) {
+    HeatWiresTransferRelay *const relay = &ParticleAttributes.protocol.heatWiresTransferRelay;
+    if (!relay->isActive || ParticleAttributes.protocol.fragmentedTransfer.isActive) {
+        return;
+    }
+
+    const uint8_t *const bytes = ParticleAttributes.protocol.fragmentReassembly.bytes;
+    if (relay->isEastPending) {
+        relay->isEastPending = false;
+        __startFragmentedTransfer(ParticleAttributes.node.address.row, ParticleAttributes.node.address.column + 1,
+                                  bytes, relay->numberEastBytes, (FragmentedTransferContentType) relay->contentType);
+    } else if (relay->isSouthPending) {
+        relay->isSouthPending = false;
+        __startFragmentedTransfer(ParticleAttributes.node.address.row + 1, ParticleAttributes.node.address.column,
+                                  &bytes[relay->southBytesOffset], relay->numberSouthBytes,
+                                  (FragmentedTransferContentType) relay->contentType);
+    } else {
+        relay->isActive = false;
+        ParticleAttributes.protocol.fragmentReassembly.contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_APPLICATION;
+        releaseFragmentedTransfer();
+    }
+}
+
+/**
+ * @return true if the reassembly buffer is available for a new heat wires batch or multicast,
+ * false otherwise
+ */
+bool isHeatWiresTransferSendable(void) {
+    return !ParticleAttributes.protocol.fragmentReassembly.isReceiving &&
+           !ParticleAttributes.protocol.fragmentReassembly.isComplete;
+}
+
+/**
+ * Sends a heat wires batch: a list of heat wires commands which is split at each node on the
+ * way into the sub-lists of the east and south bound entries. Thus each sub-list travels towards
+ * its destinations only, and the batch costs one transfer per branch instead of one package per
+ * node. The entries are copied to the reassembly buffer, thus the request is skipped if the buffer
+ * is not available (see {@link isHeatWiresTransferSendable()}) or the entries exceed the buffer.
+ * Entries not route-able from this node on (see {@link sendHeatWires()}) are dropped.
+ * @param entries the batch entries, see {@link constructHeatWiresBatchEntry()}
+ * @param numberEntries the number of entries
+ */
+void sendHeatWiresBatch(const HeatWiresBatchEntry *const entries, const uint8_t numberEntries) {
+    FragmentReassembly *const reassembly = &ParticleAttributes.protocol.fragmentReassembly;
+    if (!isHeatWiresTransferSendable() || numberEntries == 0 ||
+        numberEntries > HEAT_WIRES_BATCH_MAX_NUMBER_ENTRIES) {
+        return;
+    }
+
+    const uint8_t *const bytes = (const uint8_t *) entries;
+    reassembly->numberBytes = numberEntries * sizeof(HeatWiresBatchEntry);
+    for (uint8_t idx = 0; idx < reassembly->numberBytes; idx++) {
+        reassembly->bytes[idx] = bytes[idx];
+    }
+    reassembly->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_BATCH;
+    reassembly->isComplete = true;
+    executeHeatWiresBatch(reassembly);
+    relayHeatWiresTransfer();
+}
+
+#endif
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_MULTICAST
+
+/**
+ * Sends a heat wires multicast: one heat wires command for an arbitrary set of nodes given as
+ * bitmap. The bitmap is run-length encoded into the reassembly buffer, thus the request is skipped
+ * if the buffer is not available (see {@link isHeatWiresTransferSendable()}) or the encoded bitmap
+ * exceeds the buffer. Must be sent from the origin.
+ * For more details about time stamp and duration see {@link constructHeatWiresPackage()}.
+ * @param bitmap the bitmap of addressed nodes in column major order,
+ * see {@link HeatWiresMulticastHeader} and {@link encodeHeatWiresMulticastBitmap()}
+ * @param rows the bitmap's number of rows
+ * @param columns the bitmap's number of columns
+ * @param wires affected actuator flags
+ * @param timeStamp the time stamp when the actuation should start
+ * @param duration 10bit actuation duration
+ */
+void sendHeatWiresMulticast(const uint8_t *const bitmap, const uint8_t rows, const uint8_t columns,
+                            const Actuators *const wires, const uint16_t timeStamp, const uint16_t duration) {
+    FragmentReassembly *const reassembly = &ParticleAttributes.protocol.fragmentReassembly;
+    if (!isHeatWiresTransferSendable() || ParticleAttributes.node.type != NODE_TYPE_ORIGIN) {
+        return;
+    }
+
+    uint8_t numberRuns;
+    if (!encodeHeatWiresMulticastBitmap(bitmap, (uint16_t) rows * columns,
+                                        &reassembly->bytes[sizeof(HeatWiresMulticastHeader)],
+                                        COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES -
+                                        sizeof(HeatWiresMulticastHeader),
+                                        &numberRuns)) {
+        // on exceeded buffer
+        return;
+    }
+    constructHeatWiresMulticastHeader((HeatWiresMulticastHeader *) reassembly->bytes, rows, columns, wires,
+                                      timeStamp, duration);
+    reassembly->numberBytes = sizeof(HeatWiresMulticastHeader) + numberRuns;
+    reassembly->contentType = FRAGMENTED_TRANSFER_CONTENT_TYPE_HEAT_WIRES_MULTICAST;
+    reassembly->isComplete = true;
+    executeHeatWiresMulticast(reassembly);
+    relayHeatWiresTransfer();
+}
+
+#endif
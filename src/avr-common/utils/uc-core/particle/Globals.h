@@ -10,10 +10,20 @@
 
 #include "uc-core/particle/types/ParticleTypes.h"
 
+#ifdef __AVR__
 /**
  * The global particle state structure containing attributes, buffers and alike.
  */
 Particle ParticleAttributes __attribute__ ((section (".noinit")));
+#else
+/**
+ * On the build host several particles may be simulated in one process (see host/lattice).
+ * The firmware then refers to the particle selected in the calling thread.
+ */
+Particle DefaultParticle;
+__thread Particle *CurrentParticle = &DefaultParticle;
+#  define ParticleAttributes (*CurrentParticle)
+#endif
 
 // Further globals can be safely declared here:
 // FooType YourGlobalVariable
@@ -75,7 +75,6 @@ static void __enableDiscoveryPulsing(void) {
 
 static void __enableAlerts(SchedulerTask *const task) {
     ParticleAttributes.alerts.isRxBufferOverflowEnabled = true;
-    ParticleAttributes.alerts.isRxParityErrorEnabled = true;
     ParticleAttributes.alerts.isGenericErrorEnabled = true;
     // to remove compiler warning, clearing this flag is redundant
     task->isEnabled = false;
@@ -285,7 +284,10 @@ static void __handleWaitForBeingEnumerated(void) {
     if (commPortState->stateTimeoutCounter == 0 &&
         commPortState->receptionistState != COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_ACK &&
         commPortState->receptionistState !=
-        COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_ACK_WAIT_TX_FINISHED) {
+        COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_ACK_WAIT_TX_FINISHED &&
+        commPortState->receptionistState != COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE &&
+        commPortState->receptionistState !=
+        COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE_WAIT_TX_FINISHED) {
         // on timeout: fall back to start state
         DEBUG_CHAR_OUT('r');
         commPortState->receptionistState = COMMUNICATION_RECEPTIONIST_STATE_TYPE_RECEIVE;
@@ -321,6 +323,12 @@ static void __handleWaitForBeingEnumerated(void) {
             }
             clearReceptionPortBuffer(&ParticleAttributes.communication.ports.rx.north);
             DEBUG_CHAR_OUT('h');
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+            // the enumerating particle may probe faster link rates before acknowledging
+            resetLinkRateNegotiationSamples();
+            ParticleAttributes.directionOrientedPorts.north.linkRate->maxReceptionClockDelayShift =
+                    COMMUNICATION_LINK_RATE_MAX_CLOCK_DELAY_SHIFT;
+#endif
             commPortState->receptionistState = COMMUNICATION_RECEPTIONIST_STATE_TYPE_WAIT_FOR_RESPONSE;
             break;
             // wait for response
@@ -328,6 +336,32 @@ static void __handleWaitForBeingEnumerated(void) {
             ParticleAttributes.directionOrientedPorts.north.receivePimpl();
             break;
 
+#ifdef COMMUNICATION_ENABLE_LINK_RATE_NEGOTIATION
+            // respond at the probed rate on accepted probes, at the default rate otherwise
+        case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE: {
+            const LinkRateNegotiation *const negotiation = &ParticleAttributes.protocol.linkRateNegotiation;
+            ParticleAttributes.directionOrientedPorts.north.linkRate->clockDelayShift =
+                    negotiation->isAccepted ? negotiation->clockDelayShift : 0;
+            constructLinkRatePackage(&ParticleAttributes.communication.ports.tx.north,
+                                     negotiation->clockDelayShift, negotiation->isAccepted);
+            enableTransmission(&ParticleAttributes.communication.ports.tx.north);
+            commPortState->receptionistState =
+                    COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE_WAIT_TX_FINISHED;
+        }
+            break;
+            // wait for tx finished
+        case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE_WAIT_TX_FINISHED:
+            if (ParticleAttributes.communication.ports.tx.north.isTransmitting) {
+                break;
+            }
+            commPortState->receptionistState = COMMUNICATION_RECEPTIONIST_STATE_TYPE_WAIT_FOR_RESPONSE;
+            break;
+#else
+        case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE:
+        case COMMUNICATION_RECEPTIONIST_STATE_TYPE_TRANSMIT_LINK_RATE_RESPONSE_WAIT_TX_FINISHED:
+            break;
+#endif
+
         case COMMUNICATION_RECEPTIONIST_STATE_TYPE_IDLE:
             break;
     }
@@ -361,6 +395,10 @@ static void __handleSynchronizeNeighbour(const StateType endState) {
         case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_RESPONSE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
         __COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
             ParticleAttributes.node.state = endState;
@@ -416,6 +454,49 @@ static void __handleSynchronizeNeighbourDoneOrRunTest(const StateType endState)
         sendHeatWiresModePackage(HEATING_LEVEL_TYPE_STRONG);
         return;
     }
+#elif defined(SIMULATION_FRAGMENTED_TRANSFER_TEST)
+    if (ParticleAttributes.node.type == NODE_TYPE_ORIGIN) {
+        static uint8_t payload[COMMUNICATION_PROTOCOL_FRAGMENTATION_MAX_TRANSFER_BYTES];
+        for (uint8_t idx = 0; idx < sizeof(payload); idx++) {
+            payload[idx] = idx;
+        }
+        NodeAddress nodeAddress;
+        nodeAddress.row = 2;
+        nodeAddress.column = 2;
+        DELAY_MS_1;
+        sendFragmentedTransfer(&nodeAddress, payload, sizeof(payload));
+        return;
+    }
+#elif defined(SIMULATION_HEAT_WIRES_BATCH_TEST)
+    if (ParticleAttributes.node.type == NODE_TYPE_ORIGIN) {
+        static const uint8_t addresses[][2] = {{1, 3}, {2, 2}, {3, 1}, {3, 3}, {4, 2}, {4, 4}};
+        HeatWiresBatchEntry entries[sizeof(addresses) / sizeof(addresses[0])];
+        Actuators actuators;
+        actuators.northLeft = true;
+        actuators.northRight = true;
+        // start after the batch has been forwarded, actuation occupies the ports
+        const uint16_t startTimeStamp = ParticleAttributes.localTime.numTimePeriodsPassed + 20;
+        for (uint8_t idx = 0; idx < sizeof(addresses) / sizeof(addresses[0]); idx++) {
+            NodeAddress nodeAddress;
+            nodeAddress.row = addresses[idx][0];
+            nodeAddress.column = addresses[idx][1];
+            constructHeatWiresBatchEntry(&entries[idx], &nodeAddress, &actuators, startTimeStamp, 2);
+        }
+        DELAY_MS_1;
+        sendHeatWiresBatch(entries, sizeof(addresses) / sizeof(addresses[0]));
+        return;
+    }
+#elif defined(SIMULATION_HEAT_WIRES_MULTICAST_TEST)
+    if (ParticleAttributes.node.type == NODE_TYPE_ORIGIN) {
+        // column major 4x4 bitmap addressing (4,1), (2,2), (1,3), (3,3) and (4,4)
+        static const uint8_t bitmap[] = {0x28, 0x85};
+        Actuators actuators;
+        actuators.northLeft = true;
+        actuators.northRight = true;
+        DELAY_MS_1;
+        sendHeatWiresMulticast(bitmap, 4, 4, &actuators, ParticleAttributes.localTime.numTimePeriodsPassed + 20, 2);
+        return;
+    }
 #elif defined(SIMULATION_SEND_HEADER_TEST)
     if (ParticleAttributes.node.type == NODE_TYPE_ORIGIN) {
         HeaderPackage package;
@@ -453,6 +534,10 @@ static void __handleRelayAnnounceNetworkGeometry(const StateType endState) {
         case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_RESPONSE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
         __COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
             ParticleAttributes.node.state = endState;
@@ -489,6 +574,10 @@ static void __handleSendAnnounceNetworkGeometry(const StateType endState) {
         case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_RESPONSE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
         __COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
             ParticleAttributes.node.state = endState;
@@ -649,6 +738,10 @@ static void __handleSendPackage(DirectionOrientedPort *const port, const StateTy
         case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_RESPONSE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK:
         case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_ACK_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_TRANSMIT_LINK_RATE_PROBE_WAIT_FOR_TX_FINISHED:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_WAIT_FOR_LINK_RATE_RESPONSE:
+        case COMMUNICATION_INITIATOR_STATE_TYPE_LINK_RATE_NEGOTIATED:
         __COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
         case COMMUNICATION_INITIATOR_STATE_TYPE_IDLE:
             ParticleAttributes.node.state = endState;
@@ -684,6 +777,13 @@ static void __handleIsActuationCommandPeriod(void) {
  */
 static inline void process(void) {
     // DEBUG_CHAR_OUT('P');
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+    processTxFrameQueues();
+    if (ParticleAttributes.node.state != STATE_TYPE_IDLE && hasPendingTxFrames()) {
+        // states other than idle access the transmission ports directly
+        return;
+    }
+#endif
     // ---------------- init states ----------------
 
     switch (ParticleAttributes.node.state) {
@@ -907,6 +1007,12 @@ static inline void process(void) {
             ParticleAttributes.directionOrientedPorts.north.receivePimpl();
             ParticleAttributes.directionOrientedPorts.east.receivePimpl();
             ParticleAttributes.directionOrientedPorts.south.receivePimpl();
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HEAT_WIRES_BATCH
+            relayHeatWiresTransfer();
+#endif
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+            sendNextFragment();
+#endif
             __handleIsActuationCommandPeriod();
 
             // future time stamp dependent execution should be better placed in the scheduler
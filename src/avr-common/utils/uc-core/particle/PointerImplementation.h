@@ -14,8 +14,14 @@
  */
 void receiveNorth(void) {
     if (ParticleAttributes.discoveryPulseCounters.north.isConnected) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+        interpretDeferredRxBuffer(&ParticleAttributes.directionOrientedPorts.north);
+#endif
         manchesterDecodeBuffer(&ParticleAttributes.directionOrientedPorts.north,
                                interpretRxBuffer);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+        handleCutThroughRelay(&ParticleAttributes.directionOrientedPorts.north);
+#endif
     }
 }
 
@@ -24,8 +30,14 @@ void receiveNorth(void) {
  */
 void receiveEast(void) {
     if (ParticleAttributes.discoveryPulseCounters.east.isConnected) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+        interpretDeferredRxBuffer(&ParticleAttributes.directionOrientedPorts.east);
+#endif
         manchesterDecodeBuffer(&ParticleAttributes.directionOrientedPorts.east,
                                interpretRxBuffer);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+        handleCutThroughRelay(&ParticleAttributes.directionOrientedPorts.east);
+#endif
     }
 }
 
@@ -34,7 +46,13 @@ void receiveEast(void) {
  */
 void receiveSouth(void) {
     if (ParticleAttributes.discoveryPulseCounters.south.isConnected) {
+#ifdef COMMUNICATION_ENABLE_TX_FRAME_QUEUE
+        interpretDeferredRxBuffer(&ParticleAttributes.directionOrientedPorts.south);
+#endif
         manchesterDecodeBuffer(&ParticleAttributes.directionOrientedPorts.south,
                                interpretRxBuffer);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_CUT_THROUGH_RELAY
+        handleCutThroughRelay(&ParticleAttributes.directionOrientedPorts.south);
+#endif
     }
 }
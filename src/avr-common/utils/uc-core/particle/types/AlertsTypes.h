@@ -13,7 +13,6 @@
  */
 typedef struct Alerts {
     uint8_t isRxBufferOverflowEnabled : 1;
-    uint8_t isRxParityErrorEnabled : 1;
     uint8_t isGenericErrorEnabled : 1;
-    uint8_t __pad  : 5;
+    uint8_t __pad  : 6;
 } Alerts;
\ No newline at end of file
@@ -14,6 +14,5 @@
  */
 void constructAlerts(Alerts *const o) {
     o->isRxBufferOverflowEnabled = false;
-    o->isRxParityErrorEnabled = false;
     o->isGenericErrorEnabled = false;
 }
\ No newline at end of file
@@ -26,6 +26,10 @@ typedef struct DirectionOrientedPort {
      * communication related
      */
     RxPort *rxPort;
+    /**
+     * communication related: the link's negotiated rate
+     */
+    LinkRate *linkRate;
 
     /**
      * pointer implementation: decode and interpret reception
@@ -18,6 +18,7 @@ void constructDirectionOrientedPort(DirectionOrientedPort *const o,
                                     DiscoveryPulseCounter *const discoveryPulseCounter,
                                     TxPort *const txPort,
                                     RxPort *const rxPort,
+                                    LinkRate *const linkRate,
                                     void (*const receivePimpl)(void),
                                     void (*const txHighPimpl)(void),
                                     void (*const txLowPimpl)(void),
@@ -25,6 +26,7 @@ void constructDirectionOrientedPort(DirectionOrientedPort *const o,
     o->discoveryPulseCounter = discoveryPulseCounter;
     o->rxPort = rxPort;
     o->txPort = txPort;
+    o->linkRate = linkRate;
     o->receivePimpl = receivePimpl;
     o->txHighPimpl = txHighPimpl;
     o->txLowPimpl = txLowPimpl;
@@ -40,6 +42,7 @@ void constructDirectionOrientedPorts(DirectionOrientedPorts *const o) {
                                    &ParticleAttributes.discoveryPulseCounters.north,
                                    &ParticleAttributes.communication.ports.tx.north,
                                    &ParticleAttributes.communication.ports.rx.north,
+                                   &ParticleAttributes.communication.timerAdjustment.linkRates.north,
                                    receiveNorth,
                                    northTxHiImpl,
                                    northTxLoImpl,
@@ -48,6 +51,7 @@ void constructDirectionOrientedPorts(DirectionOrientedPorts *const o) {
                                    &ParticleAttributes.discoveryPulseCounters.east,
                                    &ParticleAttributes.communication.ports.tx.east,
                                    &ParticleAttributes.communication.ports.rx.east,
+                                   &ParticleAttributes.communication.timerAdjustment.linkRates.east,
                                    receiveEast,
                                    eastTxHiImpl,
                                    eastTxLoImpl,
@@ -56,6 +60,7 @@ void constructDirectionOrientedPorts(DirectionOrientedPorts *const o) {
                                    &ParticleAttributes.discoveryPulseCounters.south,
                                    &ParticleAttributes.communication.ports.tx.south,
                                    &ParticleAttributes.communication.ports.rx.south,
+                                   &ParticleAttributes.communication.timerAdjustment.linkRates.south,
                                    receiveSouth,
                                    southTxHiImpl,
                                    southTxLoImpl,
@@ -64,6 +69,7 @@ void constructDirectionOrientedPorts(DirectionOrientedPorts *const o) {
                                    &ParticleAttributes.discoveryPulseCounters.east,
                                    &ParticleAttributes.communication.ports.tx.east,
                                    &ParticleAttributes.communication.ports.rx.east,
+                                   &ParticleAttributes.communication.timerAdjustment.linkRates.simultaneous,
                                    receiveEast,
                                    simultaneousTxHiImpl,
                                    simultaneousTxLoImpl,
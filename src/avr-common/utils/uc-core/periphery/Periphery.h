@@ -232,50 +232,6 @@ void blinkInterruptErrorForever(void) {
     }
 }
 
-/**
- * Blink LEDs to indicate a parity error state.
- * Sequence on parityBit == true: led 1, led2, led3
- * otherwise: led 3, led 2, led 1.
- * This function never returns.
- */
-void blinkParityErrorForever(bool parityBit) {
-    if (ParticleAttributes.alerts.isRxParityErrorEnabled == false) {
-        __ledsOff();
-        LED_STATUS1_ON;
-        LED_STATUS2_ON;
-        return;
-    }
-
-    __disableInterruptsForBlockingBlinking();
-    __ledsOff();
-
-    if (parityBit == true) {
-        forever {
-            LED_STATUS1_ON;
-            DELAY_MS_500;
-            LED_STATUS1_OFF;
-            LED_STATUS2_ON;
-            DELAY_MS_500;
-            LED_STATUS2_OFF;
-            LED_STATUS3_ON;
-            DELAY_MS_500;
-            LED_STATUS3_OFF;
-        }
-    } else {
-        forever {
-            LED_STATUS3_ON;
-            DELAY_MS_500;
-            LED_STATUS3_OFF;
-            LED_STATUS2_ON;
-            DELAY_MS_500;
-            LED_STATUS2_OFF;
-            LED_STATUS1_ON;
-            DELAY_MS_500;
-            LED_STATUS1_OFF;
-        }
-    }
-}
-
 void ledsOnForever(void) {
     __disableInterruptsForBlockingBlinking();
     __ledsOn();
@@ -540,7 +496,6 @@ void heartBeatToggle(SchedulerTask *task) {
 #define blinkLed3Forever(...)
 #define blinkLed4Forever(...)
 #define blinkInterruptErrorForever(...)
-#define blinkParityErrorForever(...)
 #define ledsOnForever(...)
 #define blinkTimeIntervalNonblocking(...)
 #define blinkAddressNonblocking(...)
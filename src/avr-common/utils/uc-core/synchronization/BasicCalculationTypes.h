@@ -1,21 +1,35 @@
 /**
  * @author Raoul Rubien 02.10.2016
  *
- * Calculation related types.
+ * Calculation related types. With SYNCHRONIZATION_ENABLE_FIXED_POINT_CALCULATION the calculation type
+ * is a signed fixed-point number, see Calculation.h.
  */
 
 #pragma once
 
 #include <stdint.h>
+#include "uc-core/configuration/synchronization/Synchronization.h"
 
 #ifdef C_STRUCTS_TO_JSON_PARSER_TYPEDEF_NOT_SUPPORTED_SUPPRESS_REGULAR_TYPEDEFS
 #  define CumulationType  uint32_t
 #  define SampleValueType uint16_t
-#  define CalculationType float
+#  ifdef SYNCHRONIZATION_ENABLE_FIXED_POINT_CALCULATION
+#    define CalculationType int32_t
+#    define SquareCumulationType uint64_t
+#  else
+#    define CalculationType float
+#    define SquareCumulationType float
+#  endif
 #  define IndexType uint8_t
 #else
 typedef uint32_t CumulationType;
 typedef uint16_t SampleValueType;
+#  ifdef SYNCHRONIZATION_ENABLE_FIXED_POINT_CALCULATION
+typedef int32_t CalculationType;
+typedef uint64_t SquareCumulationType;
+#  else
 typedef float CalculationType;
+typedef float SquareCumulationType;
+#  endif
 typedef uint8_t IndexType;
 #endif
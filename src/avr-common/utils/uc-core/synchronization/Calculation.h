@@ -0,0 +1,318 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Calculation related implementation. The synchronization strategies operate on CalculationType
+ * values by the operations below only, thus the arithmetic is selectable:
+ * With SYNCHRONIZATION_ENABLE_FIXED_POINT_CALCULATION values are signed 32 bit fixed-point numbers
+ * having CALCULATION_FRACTION_BITS fractional bits. Observed PDU durations exceed 16 integer bits,
+ * thus the format is Q23.8 rather than Q16.16, its 8 fractional bits equal the resolution of Q8.8
+ * factors. Operations saturate instead of overflowing, the division by the PDU's number of clocks
+ * is a multiplication by the reciprocal and the square root is evaluated on integers. Squares are
+ * cumulated in the wide SquareCumulationType. Sums of squared samples are exact 64 bit integers in
+ * both arithmetics.
+ * Otherwise values are floats and libm is used.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "uc-core/configuration/synchronization/Synchronization.h"
+#include "BasicCalculationTypes.h"
+
+#ifdef SYNCHRONIZATION_ENABLE_FIXED_POINT_CALCULATION
+
+/**
+ * Number of fractional bits of the fixed-point representation.
+ */
+#  define CALCULATION_FRACTION_BITS 8
+/**
+ * Fixed-point representation of 1.0.
+ */
+#  define CALCULATION_ONE ((CalculationType) 1 << CALCULATION_FRACTION_BITS)
+#  define CALCULATION_MAX ((CalculationType) INT32_MAX)
+#  define CALCULATION_MIN ((CalculationType) INT32_MIN)
+/**
+ * round(2^32 / SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL), evaluated at compile time
+ */
+#  define CALCULATION_PDU_NUMBER_CLOCKS_RECIPROCAL \
+    ((int64_t) (4294967296.0 / SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL + 0.5))
+
+/**
+ * Converts an integer to the calculation type.
+ * @param integer the integer value
+ */
+#  define calculationFromInteger(integer) ((CalculationType) (integer) * CALCULATION_ONE)
+
+/**
+ * Converts a floating point constant to the calculation type at compile time.
+ * @param constant the constant expression
+ */
+#  define calculationFromConstant(constant) \
+    ((CalculationType) ((constant) * CALCULATION_ONE + (((constant) < 0) ? -0.5 : 0.5)))
+
+/**
+ * Converts the calculation type to float, used for evaluation output only.
+ * @param value the value to convert
+ */
+#  define calculationToFloat(value) ((float) (value) / (float) CALCULATION_ONE)
+
+/**
+ * Truncates the value to an integer.
+ * @param value the value to truncate
+ */
+#  define calculationToInteger(value) ((value) >> CALCULATION_FRACTION_BITS)
+
+/**
+ * Halves the value.
+ * @param value the value to halve
+ */
+#  define calculationHalf(value) ((value) / 2)
+
+/**
+ * Limits a wide intermediate result to the range of the calculation type.
+ * @param value the intermediate result
+ * @return the saturated value
+ */
+CalculationType calculationSaturate(const int64_t value) {
+    if (value > CALCULATION_MAX) {
+        return CALCULATION_MAX;
+    }
+    if (value < CALCULATION_MIN) {
+        return CALCULATION_MIN;
+    }
+    return (CalculationType) value;
+}
+
+/**
+ * @return the saturated sum a + b
+ */
+CalculationType calculationAdd(const CalculationType a, const CalculationType b) {
+    return calculationSaturate((int64_t) a + b);
+}
+
+/**
+ * @return the saturated difference a - b
+ */
+CalculationType calculationSubtract(const CalculationType a, const CalculationType b) {
+    return calculationSaturate((int64_t) a - b);
+}
+
+/**
+ * @return the rounded and saturated product a * b
+ */
+CalculationType calculationMultiply(const CalculationType a, const CalculationType b) {
+    return calculationSaturate(((int64_t) a * b + (CALCULATION_ONE / 2)) >> CALCULATION_FRACTION_BITS);
+}
+
+/**
+ * @param value the dividend
+ * @param divisor the integer divisor, must not be 0
+ * @return the quotient rounded half away from zero
+ */
+CalculationType calculationDivideByInteger(const CalculationType value, const uint16_t divisor) {
+    if (value < 0) {
+        return -((-value + (divisor / 2)) / divisor);
+    }
+    return (value + (divisor / 2)) / divisor;
+}
+
+/**
+ * Evaluates the mean of cumulated integer samples.
+ * @param cumulation the sum of samples
+ * @param numberValues the number of cumulated samples
+ * @return the rounded and saturated quotient, 0 if no samples were cumulated
+ */
+CalculationType calculationRatio(const CumulationType cumulation, const uint16_t numberValues) {
+    if (numberValues == 0) {
+        return 0;
+    }
+    if (cumulation >= ((CumulationType) 1 << (32 - CALCULATION_FRACTION_BITS - 1))) {
+        return calculationSaturate(((int64_t) cumulation * CALCULATION_ONE + (numberValues / 2)) / numberValues);
+    }
+    return ((cumulation << CALCULATION_FRACTION_BITS) + (numberValues / 2)) / numberValues;
+}
+
+/**
+ * Evaluates the ratio of signed integers, i.e. of regression sums.
+ * @param numerator the signed integer numerator
+ * @param denominator the integer denominator, must not be 0
+ * @return the quotient rounded half away from zero and saturated
+ */
+CalculationType calculationSignedRatio(const int64_t numerator, const uint32_t denominator) {
+    if (numerator < 0) {
+        return calculationSaturate(-((-numerator * CALCULATION_ONE + (denominator / 2)) / denominator));
+    }
+    return calculationSaturate((numerator * CALCULATION_ONE + (denominator / 2)) / denominator);
+}
+
+/**
+ * Divides by SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL by multiplying the reciprocal.
+ * @param value the dividend
+ * @return the quotient
+ */
+CalculationType calculationDivideByPduNumberClocks(const CalculationType value) {
+    return (CalculationType) (((int64_t) value * CALCULATION_PDU_NUMBER_CLOCKS_RECIPROCAL +
+                               ((int64_t) 1 << 31)) >> 32);
+}
+
+/**
+ * Rounds half away from zero to the nearest integer as roundf() does.
+ * @param value the value to round
+ */
+int32_t calculationRound(const CalculationType value) {
+    if (value < 0) {
+        return -(int32_t) ((-(int64_t) value + (CALCULATION_ONE / 2)) >> CALCULATION_FRACTION_BITS);
+    }
+    return (int32_t) (((int64_t) value + (CALCULATION_ONE / 2)) >> CALCULATION_FRACTION_BITS);
+}
+
+/**
+ * @param value the value, must not be negative
+ * @return the fractional part in units of 1/256
+ */
+#  define calculationFraction(value) ((uint8_t) ((value) & (CALCULATION_ONE - 1)))
+
+/**
+ * Integer square root by digit-by-digit evaluation.
+ * @param value the radicand
+ * @return floor(sqrt(value))
+ */
+static uint32_t __calculationIntegerSqrt(uint32_t value) {
+    uint32_t result = 0;
+    uint32_t bit = (uint32_t) 1 << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= result + bit) {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+/**
+ * Squares the value. Squares exceed the calculation type's range, thus they are kept at twice the
+ * fractional bits in a wide type.
+ * @param value the value to square
+ */
+#  define calculationSquare(value) ((SquareCumulationType) ((int64_t) (value) * (value)))
+
+/**
+ * @param cumulation the sum of squares
+ * @param numberValues the number of cumulated squares, must not be 0
+ * @return the rounded mean of squares
+ */
+#  define calculationSquareMean(cumulation, numberValues) \
+    (((cumulation) + ((numberValues) / 2)) / (numberValues))
+
+/**
+ * Evaluates the variance of integer samples from their exact sums.
+ * @param cumulation the sum of samples Σy
+ * @param squareCumulation the sum of squared samples Σy²
+ * @param numberValues the number of cumulated samples, must not be 0
+ * @return the rounded variance (NΣy² - (Σy)²) / N² as square
+ */
+SquareCumulationType calculationVarianceOfSums(const CumulationType cumulation, const uint64_t squareCumulation,
+                                               const uint8_t numberValues) {
+    const uint64_t numberValuesSquare = (uint64_t) numberValues * numberValues;
+    const uint64_t unnormalizedVariance = numberValues * squareCumulation - (uint64_t) cumulation * cumulation;
+    return ((unnormalizedVariance << (2 * CALCULATION_FRACTION_BITS)) + (numberValuesSquare / 2)) /
+           numberValuesSquare;
+}
+
+/**
+ * Converts a square to the calculation type, i.e. for storing a variance.
+ * @param square the square
+ * @return the saturated value
+ */
+CalculationType calculationFromSquare(const SquareCumulationType square) {
+    const SquareCumulationType value = square >> CALCULATION_FRACTION_BITS;
+    if (value > CALCULATION_MAX) {
+        return CALCULATION_MAX;
+    }
+    return (CalculationType) value;
+}
+
+/**
+ * Evaluates the square root of a square, i.e. the standard deviation of a variance. Radicands
+ * exceeding 32 bit are scaled down by powers of four beforehand.
+ * @param square the radicand
+ * @return the square root
+ */
+CalculationType calculationSqrtOfSquare(SquareCumulationType square) {
+    uint8_t shift = 0;
+    while ((square >> 32) != 0) {
+        square >>= 2;
+        shift++;
+    }
+    return calculationSaturate((int64_t) __calculationIntegerSqrt((uint32_t) square) << shift);
+}
+
+#else
+
+#  include <math.h>
+#  include "uc-core/configuration/synchronization/Deviation.h"
+
+#  define calculationFromInteger(integer) ((CalculationType) (integer))
+#  define calculationFromConstant(constant) ((CalculationType) (constant))
+#  define calculationToFloat(value) ((float) (value))
+#  define calculationToInteger(value) ((int32_t) (value))
+#  define calculationHalf(value) ((value) / (CalculationType) 2.0)
+#  define calculationAdd(a, b) ((a) + (b))
+#  define calculationSubtract(a, b) ((a) - (b))
+#  define calculationMultiply(a, b) ((a) * (b))
+#  define calculationDivideByInteger(value, divisor) ((value) / (CalculationType) (divisor))
+#  define calculationRatio(cumulation, numberValues) \
+    ((CalculationType) (cumulation) / (CalculationType) (numberValues))
+#  define calculationSignedRatio(numerator, denominator) \
+    ((CalculationType) (numerator) / (CalculationType) (denominator))
+#  define calculationDivideByPduNumberClocks(value) \
+    ((value) / (CalculationType) SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL)
+#  define calculationRound(value) roundf(value)
+#  define calculationFraction(value) ((uint8_t) (((value) - floorf(value)) * 256.0f))
+#  define calculationSquare(value) ((value) * (value))
+#  define calculationSquareMean(cumulation, numberValues) ((cumulation) / (CalculationType) (numberValues))
+#  define calculationFromSquare(square) (square)
+#  define calculationVarianceOfSums(cumulation, squareCumulation, numberValues) \
+    ((SquareCumulationType) ((numberValues) * (squareCumulation) - (uint64_t) (cumulation) * (cumulation)) / \
+     ((SquareCumulationType) (numberValues) * (numberValues)))
+
+#  ifdef DEVIATION_BINARY_SEARCH_SQRT
+
+/**
+ * Binary search for sqrt as proposed in:
+ * http://www.avrfreaks.net/forum/where-sqrt-routine
+ */
+CalculationType calculationSqrtOfSquare(const SquareCumulationType number) {
+#    define __binary_sqr_search_digits_accuracy 0.1
+//#    define __binary_sqr_search_digits_accuracy 0.01
+    if (number >= 0) {
+        CalculationType left = 0;
+        CalculationType right = number + 1;
+        CalculationType result;
+        while ((right - left) > __binary_sqr_search_digits_accuracy) {
+            result = (left + right) / 2;
+            if (result * result < number)
+                left = result;
+            else
+                right = result;
+        };
+        return (left + right) / 2;
+    }
+    return __builtin_nan("");
+}
+
+#  else
+#    if defined(DEVIATION_MATH_SQRT)
+#      define calculationSqrtOfSquare(square) sqrtf(square)
+#    else
+#      error sqrt() implementation not specified
+#    endif
+#  endif
+
+#endif
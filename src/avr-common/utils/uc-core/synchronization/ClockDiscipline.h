@@ -0,0 +1,84 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Clock discipline related implementation. The local clock is disciplined by a two-state filter:
+ * The skew state follows the observed PDU durations by an alpha-beta filter, i.e. the steady state
+ * Kalman filter of a constant drift model, thus a drifting clock is tracked without the lag of a
+ * windowed mean. The phase state is a PI controller of the phase offsets observed on time packages:
+ * the proportional part shifts the local time tracking ISR, the integral part trims its delay.
+ * Fractions of clocks are accumulated rather than rounded away, see LocalTimeTracking.
+ */
+
+#pragma once
+
+#include "uc-core/configuration/synchronization/Synchronization.h"
+#include "uc-core/configuration/Time.h"
+#include "SynchronizationTypes.h"
+#include "Calculation.h"
+
+/**
+ * Updates the skew state by an observed PDU duration: The predicted duration and the drift are
+ * corrected by weighted parts of the prediction's residual.
+ * @param sample the observed PDU duration sample
+ * @param clockDiscipline the filter to update
+ */
+void clockDisciplineUpdateSkew(const SampleValueType *const sample, ClockDiscipline *const clockDiscipline) {
+    const CalculationType predictedDuration = calculationAdd(clockDiscipline->duration,
+                                                             clockDiscipline->durationDrift);
+    const CalculationType residual = calculationSubtract(calculationFromInteger(*sample), predictedDuration);
+    clockDiscipline->duration = calculationAdd(
+            predictedDuration,
+            calculationMultiply(calculationFromConstant(SYNCHRONIZATION_CLOCK_DISCIPLINE_DURATION_GAIN), residual));
+    clockDiscipline->durationDrift = calculationAdd(
+            clockDiscipline->durationDrift,
+            calculationMultiply(calculationFromConstant(SYNCHRONIZATION_CLOCK_DISCIPLINE_DRIFT_GAIN), residual));
+}
+
+/**
+ * Updates the phase state by an observed phase offset of the local time tracking ISR.
+ * @param phaseOffset the observed offset in clocks: positive if the local ISR is to be triggered earlier
+ * @param clockDiscipline the filter to update
+ * @return the shift of the local time tracking ISR in clocks, capped to LOCAL_TIME_IN_PHASE_SHIFTING_MAXIMUM_STEP
+ */
+int16_t clockDisciplineUpdatePhase(const int32_t phaseOffset, ClockDiscipline *const clockDiscipline) {
+    const CalculationType correction = calculationFromInteger(-phaseOffset);
+
+    // integral part: trim the ISR delay
+    CalculationType periodTrim = calculationAdd(
+            clockDiscipline->periodTrim,
+            calculationMultiply(calculationFromConstant(SYNCHRONIZATION_CLOCK_DISCIPLINE_PHASE_INTEGRAL_GAIN),
+                                correction));
+    if (periodTrim > calculationFromInteger(SYNCHRONIZATION_CLOCK_DISCIPLINE_MAX_PERIOD_TRIM)) {
+        periodTrim = calculationFromInteger(SYNCHRONIZATION_CLOCK_DISCIPLINE_MAX_PERIOD_TRIM);
+    } else if (periodTrim < calculationFromInteger(-SYNCHRONIZATION_CLOCK_DISCIPLINE_MAX_PERIOD_TRIM)) {
+        periodTrim = calculationFromInteger(-SYNCHRONIZATION_CLOCK_DISCIPLINE_MAX_PERIOD_TRIM);
+    }
+    clockDiscipline->periodTrim = periodTrim;
+
+    // proportional part: shift the ISR, the fraction not applied is kept for the next shift
+    const CalculationType shift = calculationAdd(
+            clockDiscipline->shiftResidue,
+            calculationMultiply(calculationFromConstant(SYNCHRONIZATION_CLOCK_DISCIPLINE_PHASE_GAIN), correction));
+    int32_t integralShift = calculationRound(shift);
+    clockDiscipline->shiftResidue = calculationSubtract(shift, calculationFromInteger(integralShift));
+
+    if (integralShift > LOCAL_TIME_IN_PHASE_SHIFTING_MAXIMUM_STEP) {
+        integralShift = LOCAL_TIME_IN_PHASE_SHIFTING_MAXIMUM_STEP;
+    } else if (integralShift < -((int32_t) LOCAL_TIME_IN_PHASE_SHIFTING_MAXIMUM_STEP)) {
+        integralShift = -((int32_t) LOCAL_TIME_IN_PHASE_SHIFTING_MAXIMUM_STEP);
+    }
+    return (int16_t) integralShift;
+}
+
+/**
+ * Evaluates the local time tracking ISR delay including the trim of the phase state.
+ * @param clockDelay the manchester clock delay
+ * @param clockDiscipline the filter
+ * @return the delay in clocks including the fraction
+ */
+CalculationType clockDisciplineTimePeriodInterruptDelay(const CalculationType clockDelay,
+                                                        const ClockDiscipline *const clockDiscipline) {
+    return calculationAdd(
+            calculationMultiply(clockDelay, calculationFromInteger(LOCAL_TIME_TRACKING_INT_DELAY_MANCHESTER_CLOCK_MULTIPLIER)),
+            clockDiscipline->periodTrim);
+}
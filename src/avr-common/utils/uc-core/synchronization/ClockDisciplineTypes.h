@@ -0,0 +1,33 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Clock discipline related types.
+ */
+
+#pragma once
+
+#include "BasicCalculationTypes.h"
+
+/**
+ * Two-state filter of the local clock versus the remote clock: The skew state tracks the observed PDU
+ * duration and its drift per sample, the phase state the trim of the local time tracking ISR delay and
+ * the fraction of the ISR shift not applied yet.
+ */
+typedef struct ClockDiscipline {
+    /**
+     * filtered PDU duration (sample domain)
+     */
+    CalculationType duration;
+    /**
+     * filtered change of the PDU duration per sample
+     */
+    CalculationType durationDrift;
+    /**
+     * local time tracking ISR delay trim integrated from the observed phase offsets
+     */
+    CalculationType periodTrim;
+    /**
+     * fraction of the phase shift not yet applied to the local time tracking ISR
+     */
+    CalculationType shiftResidue;
+} ClockDiscipline;
@@ -0,0 +1,22 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Clock discipline related constructor implementation.
+ */
+
+#pragma once
+
+#include "ClockDisciplineTypes.h"
+#include "Calculation.h"
+#include "SampleFifoTypesCtors.h"
+
+/**
+ * constructor function: starts at the default clock delay without drift
+ * @param o reference to the object to construct
+ */
+void constructClockDiscipline(ClockDiscipline *const o) {
+    o->duration = calculationFromInteger(SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE);
+    o->durationDrift = 0;
+    o->periodTrim = 0;
+    o->shiftResidue = 0;
+}
@@ -2,77 +2,64 @@
  * @author Raoul Rubien 23.09.2016
  *
  * Linear Least Squares Regression related implementation.
+ * The fitting function is evaluated in constant time from running sums which are updated whenever
+ * a sample enters and the oldest sample leaves the FiFo window, thus the FiFo size does not affect
+ * the per-sample cost. The sample positions x are centered to the window and doubled to integers:
+ * the oldest sample is at x=-(N-1), the newest at x=N-1, thus Σx=0 and Σx²=N(N²-1)/3 is constant.
  */
 
 #pragma once
 
+#include "uc-core/configuration/synchronization/SampleFifoTypes.h"
 #include "SynchronizationTypes.h"
-#include "Deviation.h"
+#include "Calculation.h"
+
+#if SAMPLE_FIFO_NUM_BUFFER_ELEMENTS < 2
+#  error least square regression requires SAMPLE_FIFO_NUM_BUFFER_ELEMENTS >= 2
+#endif
+#if SAMPLE_FIFO_NUM_BUFFER_ELEMENTS * (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS - 1) > 32767
+#  error SAMPLE_FIFO_NUM_BUFFER_ELEMENTS too large: least square regression sums would overflow
+#endif
 
 /**
- * Calculating Linear Least Squares fitting function for measured values:
- * https://en.wikipedia.org/wiki/Linear_least_squares_(mathematics)#Orthogonal_decomposition_methods
- * The output (fitting function and several statistical values) are stored to the SamplesFifoBuffer.
- * The arithmetic mean is calculated in the same pass followed by a second std deviance pass.
+ * Σx² of the doubled centered positions: N(N²-1)/3
  */
-void calculateLinearFittingFunctionVarianceAndStdDeviance(void) {
-    TimeSynchronization *const timeSynchronization = &ParticleAttributes.timeSynchronization;
-    CumulationType a_ = 0, b_ = 0, c_ = 0, e_ = 0;
-    SampleValueType y = 0;
-    IndexType x = 1;
-
-//    // TODO: evaluation code
-//    CLI;
-//    samplesFifoBufferIteratorStart(&timeSynchronization->timeIntervalSamples);
-//    do {
-//        printf("%u,\n",
-//               timeSynchronization->timeIntervalSamples.samples[timeSynchronization->timeIntervalSamples.iterator].value);
-//        samplesFifoBufferFiFoBufferIteratorNext(&timeSynchronization->timeIntervalSamples);
-//    } while (timeSynchronization->timeIntervalSamples.iterator <
-//             TIME_SYNCHRONIZATION_SAMPLES_FIFO_BUFFER_ITERATOR_END);
-
-
-    samplesFifoBufferIteratorStart(&timeSynchronization->timeIntervalSamples);
-    do {
-        y = timeSynchronization->timeIntervalSamples.samples[timeSynchronization->timeIntervalSamples.iterator].value;
-        // printf("d%u\n", y);
-        // a_ += 2 * x * x;
-        a_ += (CumulationType) x * x;
-
-        // b_ += 2 * x * y;
-        b_ += (CumulationType) x * y;
-        // c_ += 2 * x;
-        c_ += x;
-        // d_ += 2; --> same as numSamples * 2
-        e_ += y;
-        // f += 2 * x; --> f == c
-
-        // 2-factor pulled our of loop means each factor *= 2
-        // TODO: evaluation code
-        // printf("[%u] --> a %lu b %lu c %lu e %lu\n", x, a_, b_, c_, e_);
-        x++;
+#define LEAST_SQUARE_REGRESSION_SUM_XX \
+    ((uint32_t) SAMPLE_FIFO_NUM_BUFFER_ELEMENTS * \
+     ((uint32_t) SAMPLE_FIFO_NUM_BUFFER_ELEMENTS * SAMPLE_FIFO_NUM_BUFFER_ELEMENTS - 1) / 3)
 
-        samplesFifoBufferFiFoBufferIteratorNext(&timeSynchronization->timeIntervalSamples);
-    } while (timeSynchronization->timeIntervalSamples.iterator <
-             TIME_SYNCHRONIZATION_SAMPLES_FIFO_BUFFER_ITERATOR_END);
+/**
+ * Updates the running sums when a sample enters the window and the oldest one leaves it.
+ * The remaining samples move one position towards the window's start, i.e. x -= 2 each.
+ * @param sums the running sums to update
+ * @param sampleIn the sample entering the window at x=N-1
+ * @param sampleOut the sample leaving the window from x=-(N-1)
+ */
+void leastSquareRegressionUpdateSums(LeastSquareRegressionSums *const sums, const SampleValueType sampleIn,
+                                     const SampleValueType sampleOut) {
+    sums->sumXY += (int32_t) (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS - 1) * sampleOut;
+    sums->sumY -= sampleOut;
+    sums->sumXY -= 2 * (int32_t) sums->sumY;
+    sums->sumXY += (int32_t) (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS - 1) * sampleIn;
+    sums->sumY += sampleIn;
+}
 
-    a_ *= 2;
-    b_ *= 2;
-    c_ *= 2;
-    uint8_t d_ = timeSynchronization->timeIntervalSamples.numSamples * 2;
-    e_ *= 2;
-    CumulationType *f_ = &c_;
-    // TODO: evaluation code
-    // printf("a%lu b%lu c%lu d%u e%lu f%lu\n", a_, b_, c_, d_, e_, *f_);
+/**
+ * Calculates the Linear Least Squares fitting function f(x)=k*x+d of the FiFo window:
+ * https://en.wikipedia.org/wiki/Simple_linear_regression
+ * k is the duration's change per sample, d is the fitted duration at the most recent sample.
+ * The result is stored to the TimeSynchronization's fitting function.
+ */
+void calculateLinearFittingFunction(void) {
+    TimeSynchronization *const timeSynchronization = &ParticleAttributes.timeSynchronization;
+    const LeastSquareRegressionSums *const sums = &timeSynchronization->fittingSums;
 
-    // we obtain two linear equations from the transformed partial derivatives to d and k
-    // with k explicitly
+    // k = Σxy / Σx² with x = x'/2 of the doubled positions x'
     timeSynchronization->fittingFunction.k =
-            ((CalculationType) d_ * b_ - (CalculationType) c_ * e_) / (a_ * d_ - (*f_) * c_);
-    // and d explicitly
-    timeSynchronization->fittingFunction.d = (timeSynchronization->fittingFunction.k * a_ + b_) / c_;
-
-    // TODO: evaluation code
-    // printf("k%li d%li\n", (int32_t) timeSynchronization->fittingFunction.k,
-    //   (int32_t) timeSynchronization->fittingFunction.d);
-}
\ No newline at end of file
+            calculationSignedRatio(2 * (int64_t) sums->sumXY, LEAST_SQUARE_REGRESSION_SUM_XX);
+    // d = Σy/N + k*(N-1)/2 = (Σy*(N+1) + 3*Σx'y) / (N*(N+1))
+    timeSynchronization->fittingFunction.d =
+            calculationSignedRatio((int64_t) sums->sumY * (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS + 1) +
+                                   3 * (int64_t) sums->sumXY,
+                                   (uint32_t) SAMPLE_FIFO_NUM_BUFFER_ELEMENTS * (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS + 1));
+}
@@ -11,11 +11,26 @@
 
 typedef struct LeastSquareRegressionResult {
     /**
-    * k as known of f(x)=k*x+d
+    * k as known of f(x)=k*x+d: the duration's change per sample
     */
     CalculationType k;
     /**
-    * d as known of f(x)=k*x+d
+    * d as known of f(x)=k*x+d: the fitted duration of the most recent sample at x=0
     */
     CalculationType d;
-} LeastSquareRegressionResult;
\ No newline at end of file
+} LeastSquareRegressionResult;
+
+/**
+ * Running sums of the samples in the FiFo window. The sample positions x are re-centered to the
+ * window's center and doubled to be integral, thus Σx = 0 and Σx² is constant.
+ */
+typedef struct LeastSquareRegressionSums {
+    /**
+     * Σy
+     */
+    CumulationType sumY;
+    /**
+     * Σ2x*y, signed since the centered positions are
+     */
+    int32_t sumXY;
+} LeastSquareRegressionSums;
\ No newline at end of file
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include "uc-core/configuration/synchronization/SampleFifoTypes.h"
 #include "LeastSquareRegressionTypes.h"
+#include "SampleFifoTypesCtors.h"
 
 /**
  * constructor function
@@ -15,4 +17,14 @@
 void constructLeastSquareRegressionResult(LeastSquareRegressionResult *const o) {
     o->k = 0;
     o->d = 0;
-}
\ No newline at end of file
+}
+
+/**
+ * constructor function: the sums of the FiFo's synthetic pre-filled samples
+ * @param o reference to the object to construct
+ */
+void constructLeastSquareRegressionSums(LeastSquareRegressionSums *const o) {
+    o->sumY = (CumulationType) SAMPLE_FIFO_NUM_BUFFER_ELEMENTS * SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE;
+    // equal samples at positions symmetric to the center
+    o->sumXY = 0;
+}
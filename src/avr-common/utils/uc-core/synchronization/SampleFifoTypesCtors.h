@@ -6,16 +6,24 @@
 
 #pragma once
 
-#include "SynchronizationTypes.h"
-#include "LeastSquareRegressionTypesCtors.h"
+#include <math.h>
+#include "uc-core/configuration/synchronization/Synchronization.h"
+#include "uc-core/configuration/communication/Communication.h"
+#include "SampleFifoTypes.h"
+
+/**
+ * The synthetic sample the FiFo is pre-filled with: the sample of a PDU received at default clock delay.
+ */
+#define SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE \
+    ((uint16_t) (roundf(SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL * \
+                        COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY) \
+                 - TIME_SYNCHRONIZATION_SAMPLE_OFFSET))
 
 void constructFifoElement(FifoElement *const o) {
     // The lightweight FiFo works only if full:
     // One can wait until enough observations have been stored to the queue
     // or speed up by pre-filling with synthetic values.
-    o->value = (uint16_t) (roundf(SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL *
-                                  COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY))
-               - TIME_SYNCHRONIZATION_SAMPLE_OFFSET;
+    o->value = SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE;
     o->isRejected = false;
 }
 
@@ -8,7 +8,7 @@
 
 #include "uc-core/configuration/synchronization/SampleFifoTypes.h"
 #include "SynchronizationTypes.h"
-#include <math.h>
+#include "Calculation.h"
 #include "uc-core/stdout/stdio.h"
 
 bool isFiFoFull(const SamplesFifoBuffer *const samplesFifoBuffer) {
@@ -46,7 +46,8 @@ void samplesFifoBufferIteratorStart(SamplesFifoBuffer *const samplesBuffer) {
     samplesBuffer->iterator = samplesBuffer->__startIdx;
 }
 
-#if !defined(SYNCHRONIZATION_STRATEGY_PROGRESSIVE_MEAN) && !defined(SYNCHRONIZATION_STRATEGY_RAW_OBSERVATION)
+#if !defined(SYNCHRONIZATION_STRATEGY_PROGRESSIVE_MEAN) && !defined(SYNCHRONIZATION_STRATEGY_RAW_OBSERVATION) \
+ && !defined(SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE)
 
 /**
  * Increments the end index for the next value to be inserted (First-in).
@@ -74,13 +75,16 @@ static void __samplesFifoBufferIncrementInsertIndex(SamplesFifoBuffer *const sam
 
 #endif
 
-#if defined(SYNCHRONIZATION_STRATEGY_MEAN_ENABLE_ONLINE_CALCULATION) \
- && (defined(SYNCHRONIZATION_STRATEGY_MEAN) || defined(SYNCHRONIZATION_STRATEGY_MEAN_WITHOUT_OUTLIER))
+#ifdef __SYNCHRONIZATION_ENABLE_SAMPLE_STATISTICS
 
 /**
- * Updates the mean of all available samples using only observations of incoming and outgoing FiFo values.
- * One call to this function does not iterate the whole FiFo.
- * An updated is performed if the TIME_SYNCHRONIZATION_MINIMUM_SAMPLES limit is exceeded.
+ * Updates the mean of all samples and the mean without marked outlier using only observations of
+ * incoming and outgoing FiFo values. The FiFo is pre-filled, thus a sample leaves the FiFo window
+ * whenever one enters. One call to this function does not iterate the whole FiFo.
+ * Variance and std deviance are invalidated, they are evaluated on demand by
+ * calculateVarianceAndStdDeviance().
+ * @param fifoIn the sample entering the FiFo
+ * @param fifoOut the sample leaving the FiFo: the overwritten synthetic pre-filled one or else the drop out
  */
 static void __calculateMeanUsingFifoInOutObservations(TimeSynchronization *const timeSynchronization,
                                                       const FifoElement *const fifoIn,
@@ -89,70 +93,52 @@ static void __calculateMeanUsingFifoInOutObservations(TimeSynchronization *const
     // consider mean with rejected outlier
     if (fifoIn->isRejected == false) {
         timeSynchronization->__unnormalizedCumulativeMeanWithoutMarkedOutlier += (CumulationType) fifoIn->value;
-
-//        // TODO: evaluation code
-//        if (timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier >= UINT16_MAX) {
-//            blinkParityErrorForever(&ParticleAttributes.alerts, 1);
-//        }
         timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier++;
     }
 
     // consider mean with rejected outlier
     if (fifoOut->isRejected == false) {
         timeSynchronization->__unnormalizedCumulativeMeanWithoutMarkedOutlier -= (CumulationType) fifoOut->value;
-
-//        // TODO: evaluation code
-//        if (timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier == 0) {
-//            blinkParityErrorForever(&ParticleAttributes.alerts, 0);
-//        }
         timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier--;
     }
 
     // consider mean
     timeSynchronization->__unnormalizedCumulativeMean += (CumulationType) fifoIn->value;
     timeSynchronization->__unnormalizedCumulativeMean -= (CumulationType) fifoOut->value;
-//
-//    // TODO: evaluation code
-//    if (timeSynchronization->__unnormalizedCumulativeMean >= (UINT32_MAX / 2)) {
-//        blinkParityErrorForever(&ParticleAttributes.alerts, 0);
-//    }
+
+    // consider variance
+    timeSynchronization->__unnormalizedCumulativeSquares += (uint32_t) fifoIn->value * fifoIn->value;
+    timeSynchronization->__unnormalizedCumulativeSquares -= (uint32_t) fifoOut->value * fifoOut->value;
+    timeSynchronization->__isDeviationValid = false;
 
     // mean
     timeSynchronization->mean =
-            (CalculationType) timeSynchronization->__unnormalizedCumulativeMean /
-            (CalculationType) SAMPLE_FIFO_NUM_BUFFER_ELEMENTS;
+            calculationRatio(timeSynchronization->__unnormalizedCumulativeMean, SAMPLE_FIFO_NUM_BUFFER_ELEMENTS);
 
     // mean without outlier
     timeSynchronization->meanWithoutMarkedOutlier =
-            (CalculationType) timeSynchronization->__unnormalizedCumulativeMeanWithoutMarkedOutlier /
-            (CalculationType) timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier;
+            calculationRatio(timeSynchronization->__unnormalizedCumulativeMeanWithoutMarkedOutlier,
+                             timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier);
 }
 
 /**
- * Updates the mean of all available samples using only observations of incoming and outgoing FiFo values.
- * One call to this function does not iterate the whole FiFo.
- * An updated is performed if the TIME_SYNCHRONIZATION_MINIMUM_SAMPLES limit is exceeded.
+ * Adds a value to the FiFo buffer by overwriting the oldest sample and updates the FiFo's statistics.
+ * @param isToBeRejected marks the sample as outlier
  */
-static void __calculateMeanUsingFifoInObservations(TimeSynchronization *const timeSynchronization,
-                                                   const FifoElement *const fifoIn) {
-    // consider mean without outlier
-    if (fifoIn->isRejected == false) {
-        timeSynchronization->__unnormalizedCumulativeMeanWithoutMarkedOutlier += fifoIn->value;
-        timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier++;
+static void __samplesFifoBufferAddSampleAndUpdateStatistics(const SampleValueType *const sample,
+                                                            const bool isToBeRejected,
+                                                            TimeSynchronization *const timeSynchronization) {
+    if (timeSynchronization->timeIntervalSamples.numSamples <
+        SAMPLE_FIFO_NUM_BUFFER_ELEMENTS) {
+        timeSynchronization->timeIntervalSamples.numSamples++;
     }
-
-    // consider mean
-    timeSynchronization->__unnormalizedCumulativeMean += (CumulationType) fifoIn->value;
-
-    // mean
-    timeSynchronization->mean =
-            (CalculationType) timeSynchronization->__unnormalizedCumulativeMean /
-            (CalculationType) timeSynchronization->timeIntervalSamples.numSamples;
-
-    // mean without outlier
-    timeSynchronization->meanWithoutMarkedOutlier =
-            (CalculationType) timeSynchronization->__unnormalizedCumulativeMeanWithoutMarkedOutlier /
-            (CalculationType) timeSynchronization->__numberCumulatedValuesWithoutMarkedOutlier;
+    __samplesFifoBufferIncrementInsertIndex(&timeSynchronization->timeIntervalSamples);
+    FifoElement *const fifoIn =
+            &timeSynchronization->timeIntervalSamples.samples[timeSynchronization->timeIntervalSamples.__insertIndex];
+    const FifoElement fifoOut = *fifoIn;
+    fifoIn->value = *sample;
+    fifoIn->isRejected = isToBeRejected;
+    __calculateMeanUsingFifoInOutObservations(timeSynchronization, fifoIn, &fifoOut);
 }
 
 #endif
@@ -165,10 +151,11 @@ static void __calculateMeanUsingFifoInObservations(TimeSynchronization *const ti
  */
 static void __calculateProgressiveMean(const SampleValueType *const sample,
                                        TimeSynchronization *const timeSynchronization) {
-    const CalculationType newProgressiveMean =
-            (CalculationType) *sample * SYNCHRONIZATION_STRATEGY_MEAN_NEW_VALUE_WEIGHT +
-            (CalculationType) timeSynchronization->progressiveMean *
-            SYNCHRONIZATION_STRATEGY_MEAN_OLD_VALUE_WEIGHT;
+    const CalculationType newProgressiveMean = calculationAdd(
+            calculationMultiply(calculationFromInteger(*sample),
+                                calculationFromConstant(SYNCHRONIZATION_STRATEGY_MEAN_NEW_VALUE_WEIGHT)),
+            calculationMultiply(timeSynchronization->progressiveMean,
+                                calculationFromConstant(SYNCHRONIZATION_STRATEGY_MEAN_OLD_VALUE_WEIGHT)));
 //    printf("fifo old %u new %u\n", (uint16_t) timeSynchronization->progressiveMean, *sample);
     timeSynchronization->progressiveMean = newProgressiveMean;
 //    printf("fifo -> %u \n", (uint16_t) timeSynchronization->progressiveMean);
@@ -186,12 +173,12 @@ static void __calculateProgressiveMean(const SampleValueType *const sample,
 void updateOutlierRejectionLimitDependingOnSigma(void) {
     TimeSynchronization *const timeSynchronization = &ParticleAttributes.timeSynchronization;
     CalculationType rejectionLimit =
-            SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR *
-            timeSynchronization->stdDeviance;
+            calculationMultiply(calculationFromConstant(SYNCHRONIZATION_OUTLIER_REJECTION_SIGMA_FACTOR),
+                                timeSynchronization->stdDeviance);
     timeSynchronization->adaptiveSampleRejection.outlierLowerBound =
-            roundf(timeSynchronization->mean - rejectionLimit);
+            calculationRound(calculationSubtract(timeSynchronization->mean, rejectionLimit));
     timeSynchronization->adaptiveSampleRejection.outlierUpperBound =
-            roundf(timeSynchronization->mean + rejectionLimit);
+            calculationRound(calculationAdd(timeSynchronization->mean, rejectionLimit));
     timeSynchronization->adaptiveSampleRejection.isOutlierRejectionBoundValid = true;
 }
 
@@ -200,9 +187,10 @@ void updateOutlierRejectionLimitDependingOnSigma(void) {
 
 #ifdef SYNCHRONIZATION_ENABLE_ADAPTIVE_MARKED_OUTLIER_REJECTION
 
-static void __reduceRejectionCounters(void) {
-   AdaptiveSampleRejection *const adaptiveSampleRejection =
-   &ParticleAttributes.timeSynchronization.adaptiveSampleRejection;
+/**
+ * Halves both counters if one exceeds SAMPLE_FIFO_ADAPTIVE_REJECTION_REDUCE_COUNTERS_LIMIT, keeps them non zero.
+ */
+static void __reduceRejectionCounters(AdaptiveSampleRejection *const adaptiveSampleRejection) {
 
     if ((adaptiveSampleRejection->rejected >= SAMPLE_FIFO_ADAPTIVE_REJECTION_REDUCE_COUNTERS_LIMIT) ||
         (adaptiveSampleRejection->accepted >= SAMPLE_FIFO_ADAPTIVE_REJECTION_REDUCE_COUNTERS_LIMIT)) {
@@ -216,9 +204,12 @@ static void __reduceRejectionCounters(void) {
     }
 }
 
-static void __updateCurrentRejectionBoundariesDependingOnCounters(void) {
-    AdaptiveSampleRejection *const adaptiveSampleRejection =
-    &ParticleAttributes.timeSynchronization->adaptiveSampleRejection;
+/**
+ * Widens or narrows the acceptance interval depending on the ratio of accepted versus rejected
+ * samples and updates the rejection boundaries around the current mean.
+ */
+static void __updateCurrentRejectionBoundariesDependingOnCounters(TimeSynchronization *const timeSynchronization) {
+    AdaptiveSampleRejection *const adaptiveSampleRejection = &timeSynchronization->adaptiveSampleRejection;
     // update rejection interval
     if (adaptiveSampleRejection->accepted >
         (SAMPLE_FIFO_ADAPTIVE_REJECTION_ACCEPTANCE_RATIO * adaptiveSampleRejection->rejected +
@@ -254,11 +245,13 @@ static void __updateCurrentRejectionBoundariesDependingOnCounters(void) {
 
     // update new rejection boundaries
     adaptiveSampleRejection->outlierLowerBound =
-            (SampleValueType) roundf(timeSynchronization->mean - (CalculationType)
-                    adaptiveSampleRejection->currentAcceptedDeviation);
+            (SampleValueType) calculationRound(calculationSubtract(
+                    timeSynchronization->mean,
+                    calculationFromInteger(adaptiveSampleRejection->currentAcceptedDeviation)));
     adaptiveSampleRejection->outlierUpperBound =
-            (SampleValueType) roundf(timeSynchronization->mean +
-                                     (CalculationType) adaptiveSampleRejection->currentAcceptedDeviation);
+            (SampleValueType) calculationRound(calculationAdd(
+                    timeSynchronization->mean,
+                    calculationFromInteger(adaptiveSampleRejection->currentAcceptedDeviation)));
     adaptiveSampleRejection->isOutlierRejectionBoundValid = true;
 }
 
@@ -267,8 +260,8 @@ static void __updateCurrentRejectionBoundariesDependingOnCounters(void) {
 /**
  * Adds a value to the FiFo buffer.
  */
-void samplesFifoBufferAddSample(const SampleValueType *const sample) {
-    TimeSynchronization *const timeSynchronization = &ParticleAttributes.timeSynchronization;
+void samplesFifoBufferAddSample(const SampleValueType *const sample,
+                                TimeSynchronization *const timeSynchronization) {
     bool isToBeRejected = false;
     // on overfull start rejecting on overfull FiFo
     if (timeSynchronization->timeIntervalSamples.isDropOutValid) {
@@ -287,43 +280,13 @@ void samplesFifoBufferAddSample(const SampleValueType *const sample) {
         }
     }
 
-    // add sample to FiFo
-    if (timeSynchronization->timeIntervalSamples.numSamples <
-        SAMPLE_FIFO_NUM_BUFFER_ELEMENTS) {
-        timeSynchronization->timeIntervalSamples.numSamples++;
-    }
-    __samplesFifoBufferIncrementInsertIndex(&timeSynchronization->timeIntervalSamples);
-    timeSynchronization->timeIntervalSamples.
-            samples[timeSynchronization->timeIntervalSamples.__insertIndex].value = *sample;
-    timeSynchronization->timeIntervalSamples.
-            samples[timeSynchronization->timeIntervalSamples.__insertIndex].isRejected = isToBeRejected;
-
-
-#ifdef SYNCHRONIZATION_STRATEGY_MEAN_ENABLE_ONLINE_CALCULATION
-    // calculate mean stepwise / on-line
-    if (timeSynchronization->timeIntervalSamples.isDropOutValid) {
-        // on fifo has dropped out a first-in value
-        __calculateMeanUsingFifoInOutObservations(timeSynchronization,
-                                                  &timeSynchronization->timeIntervalSamples.
-                                                          samples[timeSynchronization->timeIntervalSamples.__insertIndex],
-                                                  &timeSynchronization->timeIntervalSamples.dropOut);
-    } else {
-        // on fifo not entirely saturated
-        __calculateMeanUsingFifoInObservations(timeSynchronization,
-                                               &timeSynchronization->timeIntervalSamples.
-                                                       samples[timeSynchronization->timeIntervalSamples.__insertIndex]);
-    }
-#else
-    // off-line mean calculation
-    if (isFiFoFull(&timeSynchronization->timeIntervalSamples)) {
-        calculateMean();
-    }
+    // add sample to FiFo and calculate mean stepwise / on-line
+    __samplesFifoBufferAddSampleAndUpdateStatistics(sample, isToBeRejected, timeSynchronization);
 
     // on full FiFo update the rejection boundaries
     if (isFiFoFull(&timeSynchronization->timeIntervalSamples)) {
-        __updateCurrentRejectionBoundariesDependingOnCounters();
+        __updateCurrentRejectionBoundariesDependingOnCounters(timeSynchronization);
     }
-#endif
 }
 
 #endif
@@ -350,20 +313,8 @@ void samplesFifoBufferAddSample(const SampleValueType *const sample,
         }
     }
 
-    // add sample to FiFo
-    if (timeSynchronization->timeIntervalSamples.numSamples <
-        SAMPLE_FIFO_NUM_BUFFER_ELEMENTS) {
-        timeSynchronization->timeIntervalSamples.numSamples++;
-    }
-    __samplesFifoBufferIncrementInsertIndex(&timeSynchronization->timeIntervalSamples);
-    timeSynchronization->timeIntervalSamples.
-            samples[timeSynchronization->timeIntervalSamples.__insertIndex].value = *sample;
-    timeSynchronization->timeIntervalSamples.
-            samples[timeSynchronization->timeIntervalSamples.__insertIndex].isRejected = isToBeRejected;
-
-
-    // update mean exclusive marked outlier
-    calculateMeanWithoutMarkedOutlier();
+    // add sample to FiFo and update mean exclusive marked outlier stepwise / on-line
+    __samplesFifoBufferAddSampleAndUpdateStatistics(sample, isToBeRejected, timeSynchronization);
 }
 
 #endif
@@ -379,37 +330,8 @@ void samplesFifoBufferAddSample(const SampleValueType *const sample,
  */
 void samplesFifoBufferAddSample(const SampleValueType *const sample,
                                 TimeSynchronization *const timeSynchronization) {
-    // add any sample to FiFo regardless of outlier
-    if (timeSynchronization->timeIntervalSamples.numSamples <
-        SAMPLE_FIFO_NUM_BUFFER_ELEMENTS) {
-        timeSynchronization->timeIntervalSamples.numSamples++;
-    }
-    __samplesFifoBufferIncrementInsertIndex(&timeSynchronization->timeIntervalSamples);
-    timeSynchronization->timeIntervalSamples.
-            samples[timeSynchronization->timeIntervalSamples.__insertIndex].value = *sample;
-//    timeSynchronization->timeIntervalSamples.
-//            samples[timeSynchronization->timeIntervalSamples.__insertIndex].isRejected = false;
-
-#ifdef SYNCHRONIZATION_STRATEGY_MEAN_ENABLE_ONLINE_CALCULATION
-    // calculate mean stepwise / on-line
-    if (timeSynchronization->timeIntervalSamples.isDropOutValid) {
-        // on fifo has dropped out a first-in value
-        __calculateMeanUsingFifoInOutObservations(timeSynchronization,
-                                                  &timeSynchronization->timeIntervalSamples.
-                                                          samples[timeSynchronization->timeIntervalSamples.__insertIndex],
-                                                  &timeSynchronization->timeIntervalSamples.dropOut);
-    } else {
-        // on fifo not entirely saturated
-        __calculateMeanUsingFifoInObservations(timeSynchronization,
-                                               &timeSynchronization->timeIntervalSamples.
-                                                       samples[timeSynchronization->timeIntervalSamples.__insertIndex]);
-    }
-#else
-    // off-line mean calculation
-    if (isFiFoFull(&timeSynchronization->timeIntervalSamples)) {
-        calculateMean();
-    }
-#endif
+    // add any sample to FiFo regardless of outlier and calculate mean stepwise / on-line
+    __samplesFifoBufferAddSampleAndUpdateStatistics(sample, false, timeSynchronization);
 }
 
 #endif
@@ -430,8 +352,10 @@ void samplesFifoBufferAddSample(const SampleValueType *const sample,
 
 #ifdef SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING
 
+#  include "LeastSquareRegression.h"
+
 /**
- * Adds a value to the FiFo buffer.
+ * Adds a value to the FiFo buffer and updates the regression's running sums.
  */
 void samplesFifoBufferAddSample(const SampleValueType *const sample,
                                 TimeSynchronization *const timeSynchronization) {
@@ -441,6 +365,10 @@ void samplesFifoBufferAddSample(const SampleValueType *const sample,
         timeSynchronization->timeIntervalSamples.numSamples++;
     }
     __samplesFifoBufferIncrementInsertIndex(&timeSynchronization->timeIntervalSamples);
+    // the overwritten sample leaves the window: the synthetic pre-filled one or else the drop out
+    leastSquareRegressionUpdateSums(&timeSynchronization->fittingSums, *sample,
+                                    timeSynchronization->timeIntervalSamples.
+                                            samples[timeSynchronization->timeIntervalSamples.__insertIndex].value);
     timeSynchronization->timeIntervalSamples.
             samples[timeSynchronization->timeIntervalSamples.__insertIndex].value = *sample;
 //    timeSynchronization->timeIntervalSamples.
@@ -450,6 +378,37 @@ void samplesFifoBufferAddSample(const SampleValueType *const sample,
 
 #endif
 
+#ifdef __SYNCHRONIZATION_ENABLE_SORTED_SAMPLES
+
+#  include "SortedSamples.h"
+
+/**
+ * Adds a value to the FiFo buffer and replaces the leaving sample in the sorted window.
+ */
+void samplesFifoBufferAddSample(const SampleValueType *const sample,
+                                TimeSynchronization *const timeSynchronization) {
+    // add sample to FiFo
+    if (timeSynchronization->timeIntervalSamples.numSamples <
+        SAMPLE_FIFO_NUM_BUFFER_ELEMENTS) {
+        timeSynchronization->timeIntervalSamples.numSamples++;
+    }
+    __samplesFifoBufferIncrementInsertIndex(&timeSynchronization->timeIntervalSamples);
+    FifoElement *const fifoIn =
+            &timeSynchronization->timeIntervalSamples.samples[timeSynchronization->timeIntervalSamples.__insertIndex];
+    // the overwritten sample leaves the window: the synthetic pre-filled one or else the drop out
+    sortedSamplesReplace(&timeSynchronization->sortedSamples, fifoIn->value, *sample);
+    fifoIn->value = *sample;
+
+#  ifdef SYNCHRONIZATION_STRATEGY_MEDIAN
+    timeSynchronization->median = sortedSamplesMedian(&timeSynchronization->sortedSamples);
+#  endif
+#  ifdef SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN
+    timeSynchronization->trimmedMean = sortedSamplesTrimmedMean(&timeSynchronization->sortedSamples);
+#  endif
+}
+
+#endif
+
 #ifdef SYNCHRONIZATION_STRATEGY_RAW_OBSERVATION
 
 /**
@@ -458,9 +417,25 @@ void samplesFifoBufferAddSample(const SampleValueType *const sample,
 void samplesFifoBufferAddSample(const SampleValueType *const sample,
                                 TimeSynchronization *const timeSynchronization) {
     // very naive implementation: use current observation as mean
-    timeSynchronization->mean = *sample;
+    timeSynchronization->mean = calculationFromInteger(*sample);
     // workaround
     timeSynchronization->timeIntervalSamples.numSamples = SAMPLE_FIFO_NUM_BUFFER_ELEMENTS;
 }
 
-#endif
\ No newline at end of file
+#endif
+
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+
+#  include "ClockDiscipline.h"
+
+/**
+ * Does not add any value to the FiFo buffer but updates the clock discipline's skew state.
+ */
+void samplesFifoBufferAddSample(const SampleValueType *const sample,
+                                TimeSynchronization *const timeSynchronization) {
+    clockDisciplineUpdateSkew(sample, &timeSynchronization->clockDiscipline);
+    // workaround
+    timeSynchronization->timeIntervalSamples.numSamples = SAMPLE_FIFO_NUM_BUFFER_ELEMENTS;
+}
+
+#endif
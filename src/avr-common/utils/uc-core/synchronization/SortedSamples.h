@@ -0,0 +1,123 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Sorted samples related implementation: The FiFo window's samples are kept in ascending order.
+ * Whenever a sample enters the FiFo and the oldest sample leaves it, both positions are found by
+ * binary search in O(log N) and the samples in between are moved by one. The sum of the untrimmed
+ * samples is updated in constant time from the values at the trimming boundaries, thus median and
+ * trimmed mean are available without iterating the window.
+ */
+
+#pragma once
+
+#include "uc-core/configuration/synchronization/Synchronization.h"
+#include "uc-core/configuration/synchronization/SampleFifoTypes.h"
+#include "SortedSamplesTypes.h"
+#include "Calculation.h"
+
+/**
+ * index of the smallest untrimmed sample
+ */
+#define __SORTED_SAMPLES_UNTRIMMED_FIRST_INDEX (SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES)
+/**
+ * index of the largest untrimmed sample
+ */
+#define __SORTED_SAMPLES_UNTRIMMED_LAST_INDEX \
+    (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS - 1 - SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES)
+
+/**
+ * Binary search in [first, last).
+ * @return the first index having a value >= value or last if none
+ */
+static IndexType __sortedSamplesLowerBound(const SortedSamples *const sortedSamples, IndexType first,
+                                           IndexType last, const SampleValueType value) {
+    while (first < last) {
+        const IndexType middle = first + (last - first) / 2;
+        if (sortedSamples->values[middle] < value) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+/**
+ * Binary search in [first, last).
+ * @return the first index having a value > value or last if none
+ */
+static IndexType __sortedSamplesUpperBound(const SortedSamples *const sortedSamples, IndexType first,
+                                           IndexType last, const SampleValueType value) {
+    while (first < last) {
+        const IndexType middle = first + (last - first) / 2;
+        if (sortedSamples->values[middle] <= value) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+/**
+ * Replaces the sample leaving the FiFo window by the one entering it and keeps the order.
+ * The untrimmed sum changes by the values moving over the trimming boundaries only:
+ * Moving the samples in between right (left) by one, the sum over the untrimmed intersection
+ * [a, b] of the moved range changes by the value entering at a (b) minus the one leaving at b (a).
+ * @param sortedSamples the sorted window
+ * @param sampleOut the sample leaving the window, must be contained
+ * @param sampleIn the sample entering the window
+ */
+void sortedSamplesReplace(SortedSamples *const sortedSamples, const SampleValueType sampleOut,
+                          const SampleValueType sampleIn) {
+    const IndexType outIdx = __sortedSamplesLowerBound(sortedSamples, 0, SAMPLE_FIFO_NUM_BUFFER_ELEMENTS, sampleOut);
+
+    if (sampleIn < sampleOut) {
+        // move [inIdx, outIdx) right by one
+        const IndexType inIdx = __sortedSamplesUpperBound(sortedSamples, 0, outIdx, sampleIn);
+        const IndexType a = (inIdx > __SORTED_SAMPLES_UNTRIMMED_FIRST_INDEX) ? inIdx
+                                                                              : __SORTED_SAMPLES_UNTRIMMED_FIRST_INDEX;
+        const IndexType b = (outIdx < __SORTED_SAMPLES_UNTRIMMED_LAST_INDEX) ? outIdx
+                                                                              : __SORTED_SAMPLES_UNTRIMMED_LAST_INDEX;
+        if (a <= b) {
+            sortedSamples->__untrimmedCumulation += (a == inIdx) ? sampleIn : sortedSamples->values[a - 1];
+            sortedSamples->__untrimmedCumulation -= sortedSamples->values[b];
+        }
+        for (IndexType idx = outIdx; idx > inIdx; idx--) {
+            sortedSamples->values[idx] = sortedSamples->values[idx - 1];
+        }
+        sortedSamples->values[inIdx] = sampleIn;
+    } else if (sampleIn > sampleOut) {
+        // move (outIdx, inIdx] left by one
+        const IndexType inIdx = __sortedSamplesLowerBound(sortedSamples, outIdx + 1, SAMPLE_FIFO_NUM_BUFFER_ELEMENTS,
+                                                          sampleIn) - 1;
+        const IndexType a = (outIdx > __SORTED_SAMPLES_UNTRIMMED_FIRST_INDEX) ? outIdx
+                                                                               : __SORTED_SAMPLES_UNTRIMMED_FIRST_INDEX;
+        const IndexType b = (inIdx < __SORTED_SAMPLES_UNTRIMMED_LAST_INDEX) ? inIdx
+                                                                             : __SORTED_SAMPLES_UNTRIMMED_LAST_INDEX;
+        if (a <= b) {
+            sortedSamples->__untrimmedCumulation += (b == inIdx) ? sampleIn : sortedSamples->values[b + 1];
+            sortedSamples->__untrimmedCumulation -= sortedSamples->values[a];
+        }
+        for (IndexType idx = outIdx; idx < inIdx; idx++) {
+            sortedSamples->values[idx] = sortedSamples->values[idx + 1];
+        }
+        sortedSamples->values[inIdx] = sampleIn;
+    }
+}
+
+/**
+ * @return the median of the window, the mean of both middle samples on even window size
+ */
+CalculationType sortedSamplesMedian(const SortedSamples *const sortedSamples) {
+    return calculationRatio((CumulationType) sortedSamples->values[(SAMPLE_FIFO_NUM_BUFFER_ELEMENTS - 1) / 2] +
+                            sortedSamples->values[SAMPLE_FIFO_NUM_BUFFER_ELEMENTS / 2], 2);
+}
+
+/**
+ * @return the mean of the window without the SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES
+ * smallest and largest samples
+ */
+CalculationType sortedSamplesTrimmedMean(const SortedSamples *const sortedSamples) {
+    return calculationRatio(sortedSamples->__untrimmedCumulation, SORTED_SAMPLES_NUMBER_UNTRIMMED);
+}
@@ -0,0 +1,38 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Sorted samples related types.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "BasicCalculationTypes.h"
+#include "uc-core/configuration/synchronization/Synchronization.h"
+#include "uc-core/configuration/synchronization/SampleFifoTypes.h"
+
+/**
+ * number of samples the trimmed mean considers
+ */
+#define SORTED_SAMPLES_NUMBER_UNTRIMMED \
+    (SAMPLE_FIFO_NUM_BUFFER_ELEMENTS - 2 * SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES)
+
+#if SORTED_SAMPLES_NUMBER_UNTRIMMED <= 0
+#  error SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES trims all FiFo samples
+#endif
+
+/**
+ * The FiFo window's samples in ascending order: An order statistics structure providing median
+ * and trimmed mean. Samples are inserted and removed by binary search.
+ */
+typedef struct SortedSamples {
+    /**
+     * the window's samples in ascending order
+     */
+    SampleValueType values[SAMPLE_FIFO_NUM_BUFFER_ELEMENTS];
+    /**
+     * sum of the values not trimmed, i.e. at indices
+     * [SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES, N - 1 - SYNCHRONIZATION_TRIMMED_MEAN_NUMBER_TRIMMED_SAMPLES]
+     */
+    CumulationType __untrimmedCumulation;
+} SortedSamples;
@@ -0,0 +1,21 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Sorted samples related constructor implementation.
+ */
+
+#pragma once
+
+#include "SortedSamplesTypes.h"
+#include "SampleFifoTypesCtors.h"
+
+/**
+ * constructor function: the FiFo's synthetic pre-filled samples in order
+ * @param o reference to the object to construct
+ */
+void constructSortedSamples(SortedSamples *const o) {
+    for (uint8_t i = 0; i < SAMPLE_FIFO_NUM_BUFFER_ELEMENTS; i++) {
+        o->values[i] = SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE;
+    }
+    o->__untrimmedCumulation = (CumulationType) SORTED_SAMPLES_NUMBER_UNTRIMMED * SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE;
+}
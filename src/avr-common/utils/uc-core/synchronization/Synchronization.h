@@ -12,6 +12,7 @@
 #include "uc-core/particle/Globals.h"
 #include "SynchronizationTypes.h"
 #include "SamplesFifo.h"
+#include "Calculation.h"
 #include "uc-core/stdout/Stdout.h"
 #include "uc-core/stdout/stdio.h"
 
@@ -33,7 +34,10 @@
  || defined(SYNCHRONIZATION_STRATEGY_PROGRESSIVE_MEAN) \
  || defined(SYNCHRONIZATION_STRATEGY_MEAN_WITHOUT_OUTLIER) \
  || defined(SYNCHRONIZATION_ENABLE_ADAPTIVE_MARKED_OUTLIER_REJECTION) \
- || defined(SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING)
+ || defined(SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING) \
+ || defined(SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE) \
+ || defined(SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN) \
+ || defined(SYNCHRONIZATION_STRATEGY_MEDIAN)
 
 /**
  * Clock skew approximation entry point: Independent on which approximation strategy is chosen,
@@ -70,38 +74,58 @@ void tryApproximateTimings(void) {
 #endif
 #ifdef SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING
 #  define __synchronization_meanValue ParticleAttributes.timeSynchronization.fittingFunction.d
-            calculateLinearFittingFunctionVarianceAndStdDeviance();
+            calculateLinearFittingFunction();
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+#  define __synchronization_meanValue ParticleAttributes.timeSynchronization.clockDiscipline.duration
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN
+#  define __synchronization_meanValue ParticleAttributes.timeSynchronization.trimmedMean
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_MEDIAN
+#  define __synchronization_meanValue ParticleAttributes.timeSynchronization.median
 #endif
 
             // shift mean value back by +UINT16_T/2
             CalculationType observedPduDuration =
-                    __synchronization_meanValue +
-                    (CalculationType) TIME_SYNCHRONIZATION_SAMPLE_OFFSET;
+                    calculationAdd(__synchronization_meanValue,
+                                   calculationFromInteger(TIME_SYNCHRONIZATION_SAMPLE_OFFSET));
 
             // calculate one manchester clock duration
             ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay =
-                    observedPduDuration /
-                    (CalculationType) SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL;
+                    calculationDivideByPduNumberClocks(observedPduDuration);
 
             // calculate manchester clock/2 duration
             ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelayHalf =
-                    ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay /
-                    (CalculationType) 2.0;
+                    calculationHalf(ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay);
 
             // calculate the upper limit of measured short interval duration (manchester decoding decision limit)
             ParticleAttributes.communication.timerAdjustment.maxShortIntervalDuration =
-                    roundf((CalculationType) COMMUNICATION_DEFAULT_MAX_SHORT_RECEPTION_OVERTIME_PERCENTAGE_RATIO *
-                           (CalculationType) ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay);
+                    calculationRound(calculationMultiply(
+                            calculationFromConstant(COMMUNICATION_DEFAULT_MAX_SHORT_RECEPTION_OVERTIME_PERCENTAGE_RATIO),
+                            ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay));
 
             // calculate the upper limit of measured long interval duration (manchester decoding decision limit)
             ParticleAttributes.communication.timerAdjustment.maxLongIntervalDuration =
-                    roundf((CalculationType) COMMUNICATION_DEFAULT_MAX_LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO *
-                           (CalculationType) ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay);
+                    calculationRound(calculationMultiply(
+                            calculationFromConstant(COMMUNICATION_DEFAULT_MAX_LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO),
+                            ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay));
 
             // calculate the new local time tracking interrupt delay
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+            // including the phase state's trim, the fraction is accumulated by the ISR
+            const CalculationType timePeriodInterruptDelay = clockDisciplineTimePeriodInterruptDelay(
+                    ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay,
+                    &ParticleAttributes.timeSynchronization.clockDiscipline);
+            ParticleAttributes.localTime.newTimePeriodInterruptDelay = calculationToInteger(timePeriodInterruptDelay);
+            ParticleAttributes.localTime.newTimePeriodInterruptDelayFraction =
+                    calculationFraction(timePeriodInterruptDelay);
+#else
             ParticleAttributes.localTime.newTimePeriodInterruptDelay =
-                    roundf(ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay *
-                           (CalculationType) LOCAL_TIME_TRACKING_INT_DELAY_MANCHESTER_CLOCK_MULTIPLIER);
+                    calculationRound(calculationMultiply(
+                            ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay,
+                            calculationFromInteger(LOCAL_TIME_TRACKING_INT_DELAY_MANCHESTER_CLOCK_MULTIPLIER)));
+#endif
 
 //            printf("sync old %u new %u\n",
 //                   ParticleAttributes.localTime.timePeriodInterruptDelay,
@@ -11,6 +11,8 @@
 #include "uc-core/configuration/synchronization/Synchronization.h"
 #include "LeastSquareRegressionTypes.h"
 #include "SampleFifoTypes.h"
+#include "ClockDisciplineTypes.h"
+#include "SortedSamplesTypes.h"
 
 //#if defined(SYNCHRONIZATION_ENABLE_ADAPTIVE_OUTLIER_REJECTION) || defined(SYNCHRONIZATION_ENABLE_SIGMA_DEPENDENT_OUTLIER_REJECTION)
 typedef struct AdaptiveSampleRejection {
@@ -43,6 +45,7 @@ typedef struct TimeSynchronization {
     SamplesFifoBuffer timeIntervalSamples;
 #ifdef SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING
     LeastSquareRegressionResult fittingFunction;
+    LeastSquareRegressionSums fittingSums;
 #endif
     /**
      * mean of all values in FiFo
@@ -57,13 +60,14 @@ typedef struct TimeSynchronization {
      */
     CalculationType meanWithoutMarkedOutlier;
 
-#ifdef SYNCHRONIZATION_STRATEGY_MEAN_ENABLE_ONLINE_CALCULATION
+#ifdef __SYNCHRONIZATION_ENABLE_SAMPLE_STATISTICS
     /**
-     * The cumulative unnormalized mean field is used to calculate a step-wise mean
+     * The cumulative unnormalized fields are used to calculate step-wise mean and variance
      * by just observing the incoming and outgoing FiFo values without
-     * the need for a complete FiFo iteration.
+     * the need for a complete FiFo iteration. Integer sums are exact, thus they do not drift.
      */
     CumulationType __unnormalizedCumulativeMean;
+    uint64_t __unnormalizedCumulativeSquares;
     CumulationType __unnormalizedCumulativeMeanWithoutMarkedOutlier;
     IndexType __numberCumulatedValuesWithoutMarkedOutlier;
 #endif
@@ -72,6 +76,24 @@ typedef struct TimeSynchronization {
      * Very simple syn. implementation: The progressive mean has kind of knowledge of previous values.
      */
     CalculationType progressiveMean;
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+    ClockDiscipline clockDiscipline;
+#endif
+#ifdef __SYNCHRONIZATION_ENABLE_SORTED_SAMPLES
+    SortedSamples sortedSamples;
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_MEDIAN
+    /**
+     * median of all values in FiFo
+     */
+    CalculationType median;
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN
+    /**
+     * mean of all values in FiFo without the smallest and largest ones
+     */
+    CalculationType trimmedMean;
 #endif
     /**
     * samples' variance
@@ -103,5 +125,9 @@ typedef struct TimeSynchronization {
      */
     uint8_t isNextSyncPackageTransmissionEnabled : 1;
     uint8_t isNextSyncPackageTimeUpdateRequest : 1;
-    uint8_t __pad : 6;
+    /**
+     * indicates whether variance and std deviance consider the latest FiFo sample
+     */
+    uint8_t __isDeviationValid : 1;
+    uint8_t __pad : 5;
 } TimeSynchronization;
\ No newline at end of file
@@ -10,8 +10,11 @@
 #include "uc-core/configuration/synchronization/Synchronization.h"
 #include "uc-core/configuration/communication/Communication.h"
 #include "SynchronizationTypes.h"
+#include "Calculation.h"
 #include "LeastSquareRegressionTypesCtors.h"
 #include "SampleFifoTypesCtors.h"
+#include "ClockDisciplineTypesCtors.h"
+#include "SortedSamplesTypesCtors.h"
 
 //#if defined(SYNCHRONIZATION_ENABLE_ADAPTIVE_OUTLIER_REJECTION) || defined(SYNCHRONIZATION_ENABLE_SIGMA_DEPENDENT_OUTLIER_REJECTION)
 
@@ -33,28 +36,40 @@ void constructAdaptiveSampleRejection(AdaptiveSampleRejection *const o) {
 void constructTimeSynchronization(TimeSynchronization *const o) {
 
 //    constructSyncPackageTiming(&o->syncPackageTiming);
-#if defined(SYNCHRONIZATION_ENABLE_ADAPTIVE_OUTLIER_REJECTION) || defined(SYNCHRONIZATION_ENABLE_SIGMA_DEPENDENT_OUTLIER_REJECTION)
     constructAdaptiveSampleRejection(&o->adaptiveSampleRejection);
-#endif
     constructSamplesFifoBuffer(&o->timeIntervalSamples);
 #ifdef SYNCHRONIZATION_STRATEGY_LEAST_SQUARE_LINEAR_FITTING
     constructLeastSquareRegressionResult(&o->fittingFunction);
+    constructLeastSquareRegressionSums(&o->fittingSums);
 #endif
     o->mean = 0;
     o->meanWithoutOutlier = 0;
     o->meanWithoutMarkedOutlier = 0;
 
-#ifdef SYNCHRONIZATION_STRATEGY_MEAN_ENABLE_ONLINE_CALCULATION
-    o->__unnormalizedCumulativeMean = 0;
-    o->__unnormalizedCumulativeMeanWithoutMarkedOutlier = 0;
-    o->__numberCumulatedValuesWithoutMarkedOutlier = 0;
+#ifdef __SYNCHRONIZATION_ENABLE_SAMPLE_STATISTICS
+    // the sums of the FiFo's synthetic pre-filled samples
+    o->__unnormalizedCumulativeMean = (CumulationType) SAMPLE_FIFO_NUM_BUFFER_ELEMENTS * SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE;
+    o->__unnormalizedCumulativeSquares = (uint64_t) SAMPLE_FIFO_NUM_BUFFER_ELEMENTS * SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE *
+                                         SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE;
+    o->__unnormalizedCumulativeMeanWithoutMarkedOutlier = o->__unnormalizedCumulativeMean;
+    o->__numberCumulatedValuesWithoutMarkedOutlier = SAMPLE_FIFO_NUM_BUFFER_ELEMENTS;
 #endif
 
 #ifdef SYNCHRONIZATION_STRATEGY_PROGRESSIVE_MEAN
     // fake a default sample as start value
-    o->progressiveMean = (uint16_t) (roundf(SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL *
-                                     COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY))
-                         - TIME_SYNCHRONIZATION_SAMPLE_OFFSET;
+    o->progressiveMean = calculationFromInteger(SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE);
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+    constructClockDiscipline(&o->clockDiscipline);
+#endif
+#ifdef __SYNCHRONIZATION_ENABLE_SORTED_SAMPLES
+    constructSortedSamples(&o->sortedSamples);
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_MEDIAN
+    o->median = calculationFromInteger(SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE);
+#endif
+#ifdef SYNCHRONIZATION_STRATEGY_TRIMMED_MEAN
+    o->trimmedMean = calculationFromInteger(SAMPLE_FIFO_DEFAULT_SAMPLE_VALUE);
 #endif
     o->variance = 0;
     o->stdDeviance = 0;
@@ -63,4 +78,5 @@ void constructTimeSynchronization(TimeSynchronization *const o) {
     o->totalFastSyncPackagesToTransmit = SYNCHRONIZATION_TYPES_CTORS_TOTAL_FAST_SYNC_PACKAGES;
     o->isNextSyncPackageTransmissionEnabled = false;
     o->isNextSyncPackageTimeUpdateRequest = false;
+    o->__isDeviationValid = false;
 }
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include "uc-core/configuration/Time.h"
+#include "uc-core/configuration/synchronization/Synchronization.h"
 
 /**
  * Structure to Keep track of number of intervals passed since time tracking was activated.
@@ -29,6 +30,20 @@ typedef struct LocalTimeTracking {
      * The new value for local time tracking period interrupt delay.
      */
     volatile uint16_t newTimePeriodInterruptDelay;
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+    /**
+     * The current delay's fraction in 1/256 clocks. The value is updated by the corresponding ISR only.
+     */
+    uint8_t timePeriodInterruptDelayFraction;
+    /**
+     * The new delay's fraction in 1/256 clocks.
+     */
+    volatile uint8_t newTimePeriodInterruptDelayFraction;
+    /**
+     * The accumulated fractions of passed delays. On overflow the delay is extended by one clock.
+     */
+    uint8_t __timePeriodInterruptDelayFractionAccumulator;
+#endif
     /** The local time tracking timer/counter compare value shift. It is considered once after
      *flag isNewTimerCounterShiftUpdateable is set. The flag is cleared by the ISR.
      */
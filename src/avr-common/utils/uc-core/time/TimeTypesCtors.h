@@ -18,6 +18,11 @@ void constructLocalTimeTracking(LocalTimeTracking *const o) {
     o->newNumTimePeriodsPassed = 0;
     o->timePeriodInterruptDelay = LOCAL_TIME_TRACKING_INT_DELAY_MANCHESTER_CLOCK_INITIAL_VALUE;
     o->newTimePeriodInterruptDelay = LOCAL_TIME_TRACKING_INT_DELAY_MANCHESTER_CLOCK_INITIAL_VALUE;
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+    o->timePeriodInterruptDelayFraction = 0;
+    o->newTimePeriodInterruptDelayFraction = 0;
+    o->__timePeriodInterruptDelayFractionAccumulator = 0;
+#endif
     o->isTimePeriodInterruptDelayUpdateable = false;
     o->isNumTimePeriodsPassedUpdateable = false;
     o->newTimerCounterShift = 0;
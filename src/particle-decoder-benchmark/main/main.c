@@ -0,0 +1,389 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host benchmark of the manchester decoder under distorted reception. Frames of random payload are
+ * encoded by the firmware's manchester coding and the resulting edges are distorted by
+ * - transmitter clock skew,
+ * - gaussian jitter,
+ * - burst jitter: consecutive edges uniformly displaced and
+ * - missing edges
+ * before being captured by the north reception ISR into the snapshot buffer and decoded.
+ * Reports decoded bits/s, frame error rate and the max. snapshot buffer occupancy per scenario.
+ * Afterwards the frame error rate of one scenario is mapped over the short/long interval
+ * decision limits, see COMMUNICATION_DEFAULT_MAX_SHORT/LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO.
+ * usage: ParticleDecoderBenchmark [number of frames per scenario]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include <uc-core/particle/ParticleLoop.h>
+#include <mcu/VirtualMcu.h>
+#include <mcu/VirtualMcuTypesCtors.h>
+
+// uc-core disables printf on MCUs without UART, the benchmark reports to the host's stdout
+#undef printf
+
+#define BENCHMARK_DEFAULT_NUMBER_FRAMES ((uint32_t) 10000)
+#define BENCHMARK_MAX_EDGES ((uint16_t) 256)
+#define BENCHMARK_NORTH_EXTERNAL_INTERRUPT ((uint8_t) 2)
+/**
+ * payload bytes per frame
+ */
+#define BENCHMARK_FRAME_BYTES ((uint8_t) 8)
+/**
+ * separation of consecutive frames in manchester clocks, must exceed the decoder's timeout
+ */
+#define BENCHMARK_INTER_FRAME_CLOCKS ((uint16_t) 4)
+/**
+ * the scenario the decision limits are mapped for
+ */
+#define BENCHMARK_LIMITS_SCENARIO ((uint8_t) 6)
+
+/**
+ * An edge stream distortion and the decoder's calling pattern.
+ */
+typedef struct BenchmarkScenario {
+    const char *name;
+    /**
+     * transmitter clock deviation in parts per million
+     */
+    int32_t skewPpm;
+    /**
+     * gaussian jitter standard deviation in percent of half a manchester clock
+     */
+    float gaussianJitterPercent;
+    /**
+     * probability of an edge starting a burst
+     */
+    float burstProbability;
+    /**
+     * number of displaced edges per burst
+     */
+    uint8_t burstLength;
+    /**
+     * max. displacement of burst edges in percent of half a manchester clock
+     */
+    float burstJitterPercent;
+    /**
+     * probability of an edge not being captured
+     */
+    float missingEdgeProbability;
+    /**
+     * number of edges captured in between two decoder calls
+     */
+    uint8_t edgesPerDecoderCall;
+} BenchmarkScenario;
+
+static const BenchmarkScenario benchmarkScenarios[] = {
+        {"ideal", 0, 0, 0, 0, 0, 0, 1},
+        {"ideal, lazy decoder", 0, 0, 0, 0, 0, 0, 16},
+        {"skew +2%", 20000, 0, 0, 0, 0, 0, 1},
+        {"skew -2%", -20000, 0, 0, 0, 0, 0, 1},
+        {"skew +5%", 50000, 0, 0, 0, 0, 0, 1},
+        {"gaussian 5%", 0, 5, 0, 0, 0, 0, 1},
+        {"gaussian 10%", 0, 10, 0, 0, 0, 0, 1},
+        {"gaussian 15%", 0, 15, 0, 0, 0, 0, 1},
+        {"burst 1% x4 25%", 0, 0, 0.01f, 4, 25, 0, 1},
+        {"burst 1% x4 40%", 0, 0, 0.01f, 4, 40, 0, 1},
+        {"missing 0.1%", 0, 0, 0, 0, 0, 0.001f, 1},
+        {"skew +2%, gaussian 10%, burst", 20000, 10, 0.005f, 4, 25, 0, 1},
+};
+
+#define BENCHMARK_NUMBER_SCENARIOS ((uint8_t) (sizeof(benchmarkScenarios) / sizeof(BenchmarkScenario)))
+
+/**
+ * An edge at the receiver side.
+ */
+typedef struct BenchmarkEdge {
+    /**
+     * nominal delay since the previous edge in half manchester clocks
+     */
+    uint8_t halfClocks;
+    uint8_t isRisingEdge : 1;
+    uint8_t __pad : 7;
+} BenchmarkEdge;
+
+typedef struct BenchmarkFrame {
+    BenchmarkEdge edges[BENCHMARK_MAX_EDGES];
+    uint16_t numEdges;
+    uint8_t bytes[COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES];
+    BufferBitPointer dataEndPos;
+} BenchmarkFrame;
+
+typedef struct BenchmarkResult {
+    uint32_t numFrames;
+    uint32_t numDeliveredFrames;
+    uint32_t numValidFrames;
+    uint64_t numEdges;
+    uint64_t numDecodedBits;
+    /**
+     * max. number of snapshots buffered
+     */
+    uint8_t maxOccupancy;
+    uint8_t isSnapshotBufferOverflowed : 1;
+    uint8_t __pad : 7;
+    double seconds;
+} BenchmarkResult;
+
+static BenchmarkFrame benchmarkFrame;
+static BenchmarkResult benchmarkResult;
+static uint8_t benchmarkTxLevel = false;
+static uint8_t benchmarkIsFrameValid = false;
+
+static void __benchmarkTxHighImpl(void) {
+    benchmarkTxLevel = true;
+}
+
+static void __benchmarkTxLowImpl(void) {
+    benchmarkTxLevel = false;
+}
+
+static double __benchmarkSecondsSince(const struct timespec *const start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/**
+ * @return a uniformly distributed value in [0, 1)
+ */
+static double __benchmarkUniform(void) {
+    return rand() / ((double) RAND_MAX + 1.0);
+}
+
+/**
+ * @return a standard normal distributed value (Box-Muller transform)
+ */
+static double __benchmarkGaussian(void) {
+    const double u = 1.0 - __benchmarkUniform();
+    const double v = __benchmarkUniform();
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/**
+ * Sets up the particle as receiving node in idle state: timer 1 running, north reception interrupt enabled.
+ * @param shortRatio the short interval decision limit in manchester clocks
+ * @param longRatio the long interval decision limit in manchester clocks
+ */
+static void __benchmarkSetupParticle(const float shortRatio, const float longRatio) {
+    constructVirtualMcu(&DefaultVirtualMcu);
+    virtualMcuSelect(&DefaultVirtualMcu);
+    IO_PORTS_SETUP;
+    virtualMcuSyncOutputPins();
+    constructParticle(&ParticleAttributes);
+    ParticleAttributes.node.state = STATE_TYPE_IDLE;
+    TransmissionTimerAdjustment *const timerAdjustment = &ParticleAttributes.communication.timerAdjustment;
+    timerAdjustment->maxShortIntervalDuration = roundf(shortRatio * timerAdjustment->transmissionClockDelay);
+    timerAdjustment->maxLongIntervalDuration = roundf(longRatio * timerAdjustment->transmissionClockDelay);
+    // reception idle level is high
+    virtualMcuSetExternalInterruptPin(BENCHMARK_NORTH_EXTERNAL_INTERRUPT, true);
+    RX_INTERRUPTS_SETUP;
+    RX_NORTH_INTERRUPT_ENABLE;
+    TIMER_TX_RX_COUNTER_ENABLE;
+    SEI;
+}
+
+/**
+ * Encodes a random payload using the firmware's manchester coding and records the resulting
+ * edges as seen by the receiver (inverted signal).
+ * @param o the frame to record to
+ */
+static void __benchmarkRecordFrame(BenchmarkFrame *const o) {
+    DirectionOrientedPort port = ParticleAttributes.directionOrientedPorts.north;
+    port.txHighPimpl = __benchmarkTxHighImpl;
+    port.txLowPimpl = __benchmarkTxLowImpl;
+
+    TxPort *const txPort = port.txPort;
+    for (uint8_t idx = 0; idx < COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES; idx++) {
+        txPort->buffer.bytes[idx] = (idx < BENCHMARK_FRAME_BYTES) ? (uint8_t) rand() : 0;
+    }
+    // as every package header the payload starts with a start bit, the unassigned header id
+    // leaves the frame end to the timeout as for any package of unknown length
+    ((HeaderPackage *) txPort->buffer.bytes)->startBit = 1;
+    ((HeaderPackage *) txPort->buffer.bytes)->id = __UNUSED14;
+    txPort->dataEndPos.byteNumber = BENCHMARK_FRAME_BYTES;
+    txPort->dataEndPos.bitMask = 1;
+    o->dataEndPos = txPort->dataEndPos;
+    // the receiver strips the frame check again
+    setFrameCheck(txPort);
+    for (uint8_t idx = 0; idx < COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES; idx++) {
+        o->bytes[idx] = txPort->buffer.bytes[idx];
+    }
+    bufferBitPointerStart(&txPort->buffer.pointer);
+    txPort->isTxClockPhase = true;
+    txPort->isTransmitting = true;
+    txPort->isDataBuffered = true;
+
+    uint8_t halfClocksPassed = 0;
+    uint8_t lastTxLevel = benchmarkTxLevel = false;
+    o->numEdges = 0;
+    while (txPort->isTransmitting && o->numEdges < BENCHMARK_MAX_EDGES) {
+        transmit(&port);
+        if (benchmarkTxLevel != lastTxLevel) {
+            o->edges[o->numEdges].halfClocks = halfClocksPassed;
+            o->edges[o->numEdges].isRisingEdge = !benchmarkTxLevel;
+            o->numEdges++;
+            lastTxLevel = benchmarkTxLevel;
+            halfClocksPassed = 0;
+        }
+        halfClocksPassed++;
+    }
+    txPort->isTransmitting = false;
+    txPort->isDataBuffered = false;
+}
+
+/**
+ * Verifies the received frame against the transmitted one and releases the reception buffer.
+ * @param port the port the frame was received at
+ */
+static void __benchmarkVerifyRxBuffer(DirectionOrientedPort *const port) {
+    benchmarkResult.numDeliveredFrames++;
+    const PortBuffer *const buffer = &port->rxPort->buffer;
+    bool isValid = buffer->pointer.byteNumber == benchmarkFrame.dataEndPos.byteNumber &&
+                   buffer->pointer.bitMask == benchmarkFrame.dataEndPos.bitMask;
+    for (uint8_t idx = 0; isValid && idx < buffer->pointer.byteNumber; idx++) {
+        isValid = buffer->bytes[idx] == benchmarkFrame.bytes[idx];
+    }
+    if (isValid) {
+        benchmarkIsFrameValid = true;
+        benchmarkResult.numDecodedBits += (uint64_t) buffer->pointer.byteNumber * 8;
+    }
+    port->rxPort->isDataBuffered = false;
+}
+
+/**
+ * @return the number of snapshots buffered at the port
+ */
+static uint8_t __benchmarkSnapshotBufferOccupancy(const RxPort *const rxPort) {
+    return __rxSnapshotBufferSize(&rxPort->snapshotsBuffer);
+}
+
+/**
+ * Transmits the frames distorted as the scenario specifies and decodes them.
+ * @param scenario the distortion
+ * @param numberFrames the number of frames to transmit
+ * @param shortRatio the short interval decision limit in manchester clocks
+ * @param longRatio the long interval decision limit in manchester clocks
+ */
+static void __benchmarkScenario(const BenchmarkScenario *const scenario, const uint32_t numberFrames,
+                                const float shortRatio, const float longRatio) {
+    __benchmarkSetupParticle(shortRatio, longRatio);
+    DirectionOrientedPort *const north = &ParticleAttributes.directionOrientedPorts.north;
+    const double halfClock = ParticleAttributes.communication.timerAdjustment.transmissionClockDelayHalf;
+    const double skewedHalfClock = halfClock * 1e6 / (1e6 + scenario->skewPpm);
+    const double gaussianJitter = halfClock * scenario->gaussianJitterPercent / 100.0;
+    const double burstJitter = halfClock * scenario->burstJitterPercent / 100.0;
+    const uint16_t interFrameCycles = BENCHMARK_INTER_FRAME_CLOCKS *
+                                      ParticleAttributes.communication.timerAdjustment.transmissionClockDelay;
+
+    srand(0);
+    benchmarkResult = (BenchmarkResult) {0};
+    double seconds = 0;
+    for (uint32_t frame = 0; frame < numberFrames; frame++) {
+        __benchmarkRecordFrame(&benchmarkFrame);
+
+        // edge times relative to the frame start in timer ticks
+        double nominalTime = 0, lastTime = 0;
+        uint8_t burstEdgesLeft = 0;
+        uint8_t edgesCaptured = 0;
+        benchmarkIsFrameValid = false;
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint16_t idx = 0; idx < benchmarkFrame.numEdges; idx++) {
+            const BenchmarkEdge *const edge = &benchmarkFrame.edges[idx];
+            nominalTime += edge->halfClocks * skewedHalfClock;
+            double time = nominalTime + gaussianJitter * __benchmarkGaussian();
+            if (burstEdgesLeft == 0 && __benchmarkUniform() < scenario->burstProbability) {
+                burstEdgesLeft = scenario->burstLength;
+            }
+            if (burstEdgesLeft > 0) {
+                burstEdgesLeft--;
+                time += burstJitter * (2.0 * __benchmarkUniform() - 1.0);
+            }
+            if (__benchmarkUniform() < scenario->missingEdgeProbability) {
+                continue;
+            }
+            if (time < lastTime + 1) {
+                time = lastTime + 1;
+            }
+            virtualMcuAdvanceCycles((uint32_t) (lround(time) - lround(lastTime)));
+            lastTime = time;
+            virtualMcuSetExternalInterruptPin(BENCHMARK_NORTH_EXTERNAL_INTERRUPT, edge->isRisingEdge);
+            benchmarkResult.numEdges++;
+
+            const uint8_t occupancy = __benchmarkSnapshotBufferOccupancy(north->rxPort);
+            if (occupancy > benchmarkResult.maxOccupancy) {
+                benchmarkResult.maxOccupancy = occupancy;
+            }
+            if (++edgesCaptured >= scenario->edgesPerDecoderCall) {
+                edgesCaptured = 0;
+                manchesterDecodeBuffer(north, __benchmarkVerifyRxBuffer);
+            }
+        }
+        // let the decoder drain the buffer and time out
+        manchesterDecodeBuffer(north, __benchmarkVerifyRxBuffer);
+        virtualMcuAdvanceCycles(interFrameCycles);
+        manchesterDecodeBuffer(north, __benchmarkVerifyRxBuffer);
+        seconds += __benchmarkSecondsSince(&start);
+
+        if (benchmarkIsFrameValid) {
+            benchmarkResult.numValidFrames++;
+        }
+        if (north->rxPort->snapshotsBuffer.isOverflowed) {
+            benchmarkResult.isSnapshotBufferOverflowed = true;
+            north->rxPort->snapshotsBuffer.isOverflowed = false;
+        }
+    }
+    benchmarkResult.numFrames = numberFrames;
+    benchmarkResult.seconds = seconds;
+}
+
+/**
+ * @return the frame error rate of the last scenario
+ */
+static double __benchmarkFrameErrorRate(void) {
+    return 1.0 - (double) benchmarkResult.numValidFrames / benchmarkResult.numFrames;
+}
+
+int main(int argc, char **argv) {
+    uint32_t numberFrames = BENCHMARK_DEFAULT_NUMBER_FRAMES;
+    if (argc > 1) {
+        numberFrames = (uint32_t) strtoul(argv[1], NULL, 10);
+    }
+
+    printf("%u frames of %u bytes per scenario, decision limits short %.2f long %.2f clocks\n", numberFrames,
+           BENCHMARK_FRAME_BYTES, COMMUNICATION_DEFAULT_MAX_SHORT_RECEPTION_OVERTIME_PERCENTAGE_RATIO,
+           COMMUNICATION_DEFAULT_MAX_LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO);
+    printf("%-32s %12s %12s %10s %10s %10s\n", "scenario", "bits/s", "edges/s", "delivered", "FER",
+           "occupancy");
+    for (uint8_t idx = 0; idx < BENCHMARK_NUMBER_SCENARIOS; idx++) {
+        const BenchmarkScenario *const scenario = &benchmarkScenarios[idx];
+        __benchmarkScenario(scenario, numberFrames, COMMUNICATION_DEFAULT_MAX_SHORT_RECEPTION_OVERTIME_PERCENTAGE_RATIO,
+                            COMMUNICATION_DEFAULT_MAX_LONG_RECEPTION_OVERTIME_PERCENTAGE_RATIO);
+        printf("%-32s %12.0f %12.0f %10u %10.4f %6u/%u%s\n", scenario->name,
+               benchmarkResult.numDecodedBits / benchmarkResult.seconds,
+               benchmarkResult.numEdges / benchmarkResult.seconds, benchmarkResult.numDeliveredFrames,
+               __benchmarkFrameErrorRate(), benchmarkResult.maxOccupancy, MANCHESTER_DECODING_RX_NUMBER_SNAPSHOTS,
+               benchmarkResult.isSnapshotBufferOverflowed ? " overflowed" : "");
+    }
+
+    const BenchmarkScenario *const scenario = &benchmarkScenarios[BENCHMARK_LIMITS_SCENARIO];
+    printf("\nframe error rate of \"%s\" by decision limits in manchester clocks (rows short, columns long)\n",
+           scenario->name);
+    printf("%6s", "");
+    for (uint8_t longPercent = 105; longPercent < 150; longPercent += 5) {
+        printf(" %7.2f", longPercent / 100.0);
+    }
+    printf("\n");
+    for (uint8_t shortPercent = 55; shortPercent < 100; shortPercent += 5) {
+        printf("%6.2f", shortPercent / 100.0);
+        for (uint8_t longPercent = 105; longPercent < 150; longPercent += 5) {
+            __benchmarkScenario(scenario, numberFrames / 10, shortPercent / 100.0f, longPercent / 100.0f);
+            printf(" %7.4f", __benchmarkFrameErrorRate());
+        }
+        printf("\n");
+    }
+    return EXIT_SUCCESS;
+}
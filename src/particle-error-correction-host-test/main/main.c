@@ -0,0 +1,255 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host test of the forward error correction (see COMMUNICATION_ENABLE_ERROR_CORRECTION).
+ * Pseudo random packages of each type and of each length up to the buffer size are framed as for
+ * transmission, i.e. followed by the CRC-8 and, if the type is selected, the error correction
+ * trailer. Each single and each pair of bit errors within the frame is injected into the reception
+ * buffer which is evaluated as the decoder does at the end of a reception. The test fails if any
+ * error passes the frame check undetected, if a single bit error of a coded package is not
+ * corrected or if a single bit error of an uncoded package is not detected. Errors of the header's
+ * error correction flag and header id may turn coded packages to uncoded ones and vice versa: single
+ * errors are to be detected only, pairs of them are left to the CRC-8 and are reported only.
+ * usage: ParticleErrorCorrectionHostTest
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <uc-core/particle/ParticleLoop.h>
+#include <mcu/VirtualMcu.h>
+#include <mcu/VirtualMcuTypesCtors.h>
+
+// uc-core disables printf on MCUs without UART, the test reports to the host's stdout
+#undef printf
+
+/**
+ * the number of data bits of the shortest package, i.e. the header
+ */
+#define ERROR_CORRECTION_TEST_MIN_DATA_BITS ((uint8_t) 8)
+/**
+ * the number of data bits of the longest package: the buffer without both trailers
+ */
+#define ERROR_CORRECTION_TEST_MAX_DATA_BITS \
+    ((uint8_t) ((COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES - sizeof(FrameCheckType) - sizeof(ErrorCorrectionType)) * 8))
+
+/**
+ * the header bits marking packages as coded: the error correction flag and the header id
+ */
+#define ERROR_CORRECTION_TEST_HEADER_MARKER_BITS ((uint8_t) (ERROR_CORRECTION_HEADER_FLAG_BIT | 0x1e))
+
+typedef struct ErrorCorrectionTestResult {
+    uint32_t numberFrames;
+    /**
+     * frames passing the frame check intact without correction
+     */
+    uint32_t numberIntact;
+    /**
+     * frames passing the frame check intact after correction
+     */
+    uint32_t numberCorrected;
+    /**
+     * frames failing the frame check
+     */
+    uint32_t numberDetected;
+    /**
+     * frames passing the frame check corrupted
+     */
+    uint32_t numberUndetected;
+} ErrorCorrectionTestResult;
+
+/**
+ * The results of coded or uncoded packages.
+ */
+typedef struct ErrorCorrectionTestResults {
+    ErrorCorrectionTestResult intact;
+    /**
+     * single bit errors apart from the header marker bits
+     */
+    ErrorCorrectionTestResult single;
+    /**
+     * single bit errors of the header marker bits
+     */
+    ErrorCorrectionTestResult marker;
+    /**
+     * pairs of bit errors apart from pairs of header marker bits
+     */
+    ErrorCorrectionTestResult pairs;
+    /**
+     * pairs of bit errors of the header marker bits
+     */
+    ErrorCorrectionTestResult markerPairs;
+} ErrorCorrectionTestResults;
+
+static uint32_t errorCorrectionTestRandomState;
+
+/**
+ * Deterministic pseudo random numbers, independent of the host's libc.
+ * @return a number in [0, 2^15)
+ */
+static uint16_t __errorCorrectionTestRandom(void) {
+    errorCorrectionTestRandomState = errorCorrectionTestRandomState * 1103515245 + 12345;
+    return (uint16_t) ((errorCorrectionTestRandomState >> 16) & 0x7fff);
+}
+
+/**
+ * Sets up the particle as the host benchmark does.
+ */
+static void __errorCorrectionTestSetupParticle(void) {
+    constructVirtualMcu(&DefaultVirtualMcu);
+    virtualMcuSelect(&DefaultVirtualMcu);
+    constructParticle(&ParticleAttributes);
+    ParticleAttributes.node.state = STATE_TYPE_IDLE;
+}
+
+/**
+ * Frames a pseudo random package of the given type and length at the transmission port.
+ * @param txPort the port to buffer the frame at
+ * @param headerId the package's header id
+ * @param numberDataBits the package's number of bits without trailers
+ */
+static void __errorCorrectionTestFrame(TxPort *const txPort, const uint8_t headerId, const uint8_t numberDataBits) {
+    memset((void *) txPort->buffer.bytes, 0, sizeof(txPort->buffer.bytes));
+    for (uint8_t idx = 0; idx < numberDataBits; idx++) {
+        if (__errorCorrectionTestRandom() & 1) {
+            txPort->buffer.bytes[idx >> 3] |= 1 << (idx & 0x07);
+        }
+    }
+    HeaderPackage *const header = &((Package *) txPort->buffer.bytes)->asHeader;
+    header->startBit = 1;
+    header->id = headerId;
+    txPort->dataEndPos.byteNumber = numberDataBits >> 3;
+    txPort->dataEndPos.bitMask = 1 << (numberDataBits & 0x07);
+    setFrameCheck(txPort);
+}
+
+/**
+ * Injects the bit errors into the frame as received and evaluates it the way the decoder does at
+ * the end of a reception: The CRC-8 is accumulated over all received bits, the trailers are
+ * stripped and single bit errors are corrected.
+ * @param result the result to account the evaluation to
+ * @param txPort the port the intact frame is buffered at
+ * @param numberDataBits the package's number of bits without trailers
+ * @param errorMask the bits to flip, one bit per frame byte bit
+ */
+static void __errorCorrectionTestReceive(ErrorCorrectionTestResult *const result, const TxPort *const txPort,
+                                         const uint8_t numberDataBits, const uint8_t *const errorMask) {
+    RxPort *const rxPort = &ParticleAttributes.communication.ports.rx.north;
+    PortBuffer *const buffer = rxDecodingBuffer(rxPort);
+    const uint16_t correctedErrors = rxPort->numberCorrectedErrors;
+
+    for (uint8_t byte = 0; byte < sizeof(buffer->bytes); byte++) {
+        buffer->bytes[byte] = txPort->buffer.bytes[byte] ^ errorMask[byte];
+    }
+    buffer->pointer.byteNumber = txPort->dataEndPos.byteNumber;
+    buffer->pointer.bitMask = txPort->dataEndPos.bitMask;
+    rxDecodingFrameCheck(rxPort) = computeFrameCheck(buffer->bytes, &buffer->pointer);
+    buffer->pointer.byteNumber -= sizeof(FrameCheckType);
+    __correctDataBits(rxPort);
+
+    bool isIntact = true;
+    for (uint8_t idx = 0; idx < numberDataBits; idx++) {
+        if (((buffer->bytes[idx >> 3] ^ txPort->buffer.bytes[idx >> 3]) >> (idx & 0x07)) & 1) {
+            isIntact = false;
+            break;
+        }
+    }
+
+    result->numberFrames++;
+    if (rxDecodingFrameCheck(rxPort) != 0) {
+        result->numberDetected++;
+    } else if (isIntact) {
+        if (rxPort->numberCorrectedErrors != correctedErrors) {
+            result->numberCorrected++;
+        } else {
+            result->numberIntact++;
+        }
+    } else {
+        result->numberUndetected++;
+    }
+}
+
+/**
+ * @return true if the bit is one of the header marker bits, false otherwise
+ */
+static bool __errorCorrectionTestIsMarkerBit(const uint8_t bit) {
+    return bit < 8 && ((1 << bit) & ERROR_CORRECTION_TEST_HEADER_MARKER_BITS);
+}
+
+/**
+ * Injects no, each single and each pair of bit errors into the frame buffered at the transmission port.
+ * @param results the results to account the evaluations to
+ * @param txPort the port the intact frame is buffered at
+ * @param numberDataBits the package's number of bits without trailers
+ */
+static void __errorCorrectionTestInjectErrors(ErrorCorrectionTestResults *const results, const TxPort *const txPort,
+                                              const uint8_t numberDataBits) {
+    const uint8_t numberFrameBits = bufferBitPointerToNumberBits(&txPort->dataEndPos);
+    uint8_t errorMask[COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES];
+
+    memset(errorMask, 0, sizeof(errorMask));
+    __errorCorrectionTestReceive(&results->intact, txPort, numberDataBits, errorMask);
+    for (uint8_t first = 0; first < numberFrameBits; first++) {
+        errorMask[first >> 3] ^= 1 << (first & 0x07);
+        const bool isMarkerBit = __errorCorrectionTestIsMarkerBit(first);
+        __errorCorrectionTestReceive(isMarkerBit ? &results->marker : &results->single, txPort, numberDataBits,
+                                     errorMask);
+        for (uint8_t second = first + 1; second < numberFrameBits; second++) {
+            errorMask[second >> 3] ^= 1 << (second & 0x07);
+            const bool isMarkerPair = isMarkerBit && __errorCorrectionTestIsMarkerBit(second);
+            __errorCorrectionTestReceive(isMarkerPair ? &results->markerPairs : &results->pairs, txPort,
+                                         numberDataBits, errorMask);
+            errorMask[second >> 3] ^= 1 << (second & 0x07);
+        }
+        errorMask[first >> 3] ^= 1 << (first & 0x07);
+    }
+}
+
+static void __errorCorrectionTestPrint(const char *const name, const ErrorCorrectionTestResult *const result) {
+    printf("%-17s%u frames, %u intact, %u corrected, %u detected, %u undetected\n", name, result->numberFrames,
+           result->numberIntact, result->numberCorrected, result->numberDetected, result->numberUndetected);
+}
+
+/**
+ * Injects errors into frames of all types and lengths.
+ * @return true if the test passed, false otherwise
+ */
+static bool __errorCorrectionTest(void) {
+    TxPort *const txPort = &ParticleAttributes.communication.ports.tx.north;
+    ErrorCorrectionTestResults coded, uncoded;
+    memset(&coded, 0, sizeof(coded));
+    memset(&uncoded, 0, sizeof(uncoded));
+
+    for (uint8_t headerId = 0; headerId < 16; headerId++) {
+        for (uint8_t numberDataBits = ERROR_CORRECTION_TEST_MIN_DATA_BITS;
+             numberDataBits <= ERROR_CORRECTION_TEST_MAX_DATA_BITS; numberDataBits++) {
+            __errorCorrectionTestSetupParticle();
+            __errorCorrectionTestFrame(txPort, headerId, numberDataBits);
+            __errorCorrectionTestInjectErrors(isErrorCorrectionSelected(headerId) ? &coded : &uncoded, txPort,
+                                              numberDataBits);
+        }
+    }
+
+    __errorCorrectionTestPrint("coded:", &coded.intact);
+    __errorCorrectionTestPrint("  single errors:", &coded.single);
+    __errorCorrectionTestPrint("  marker errors:", &coded.marker);
+    __errorCorrectionTestPrint("  double errors:", &coded.pairs);
+    __errorCorrectionTestPrint("  marker pairs:", &coded.markerPairs);
+    __errorCorrectionTestPrint("uncoded:", &uncoded.intact);
+    __errorCorrectionTestPrint("  single errors:", &uncoded.single);
+    __errorCorrectionTestPrint("  marker errors:", &uncoded.marker);
+    __errorCorrectionTestPrint("  double errors:", &uncoded.pairs);
+    __errorCorrectionTestPrint("  marker pairs:", &uncoded.markerPairs);
+
+    return coded.intact.numberIntact == coded.intact.numberFrames &&
+           uncoded.intact.numberIntact == uncoded.intact.numberFrames &&
+           coded.single.numberCorrected == coded.single.numberFrames &&
+           uncoded.single.numberDetected == uncoded.single.numberFrames &&
+           coded.marker.numberUndetected == 0 && uncoded.marker.numberDetected == uncoded.marker.numberFrames &&
+           coded.pairs.numberUndetected == 0 && uncoded.pairs.numberUndetected == 0;
+}
+
+int main(void) {
+    errorCorrectionTestRandomState = 1;
+    return __errorCorrectionTest() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,319 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host benchmark of uc-core. Measures at native speed:
+ * - the reception path: pin change ISR, manchester decoding, interpretation and clock skew approximation
+ *   of time packages encoded by the firmware's own manchester coding,
+ * - the scheduler and
+ * - the selected synchronization strategy.
+ * Optionally replays edge traces recorded by the lattice simulation (see trace/EdgeTraceTypes.h).
+ * usage: ParticleHostBenchmark [number of packages] [edge trace file ...]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <uc-core/particle/ParticleLoop.h>
+#include <mcu/VirtualMcu.h>
+#include <mcu/VirtualMcuTypesCtors.h>
+#include <trace/EdgeTrace.h>
+#include <trace/EdgeTraceTypesCtors.h>
+
+// uc-core disables printf on MCUs without UART, the benchmark reports to the host's stdout
+#undef printf
+
+#define BENCHMARK_DEFAULT_NUMBER_PACKAGES ((uint32_t) 100000)
+#define BENCHMARK_MAX_EDGES ((uint16_t) 256)
+#define BENCHMARK_NORTH_EXTERNAL_INTERRUPT ((uint8_t) 2)
+/**
+ * separation of consecutive packages in manchester clocks, must exceed the decoder's timeout
+ */
+#define BENCHMARK_INTER_PACKAGE_CLOCKS ((uint16_t) 4)
+/**
+ * synthetic sample jitter in timer ticks: samples are within [nominal - jitter, nominal + jitter]
+ */
+#define BENCHMARK_SAMPLE_JITTER ((uint16_t) 16)
+
+/**
+ * An edge at the receiver side.
+ */
+typedef struct BenchmarkEdge {
+    /**
+     * delay since the previous edge in timer ticks
+     */
+    uint16_t delay;
+    uint8_t isRisingEdge : 1;
+    uint8_t __pad : 7;
+} BenchmarkEdge;
+
+typedef struct BenchmarkPackage {
+    BenchmarkEdge edges[BENCHMARK_MAX_EDGES];
+    uint16_t numEdges;
+    uint8_t bytes[COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES];
+    BufferBitPointer dataEndPos;
+} BenchmarkPackage;
+
+static BenchmarkPackage benchmarkPackage;
+static uint8_t benchmarkTxLevel = false;
+static uint32_t benchmarkNumInterpretedPackages = 0;
+static uint32_t benchmarkNumValidPackages = 0;
+static uint32_t benchmarkNumReplayedFrames = 0;
+static uint64_t benchmarkNumReplayedBits = 0;
+
+static void __benchmarkTxHighImpl(void) {
+    benchmarkTxLevel = true;
+}
+
+static void __benchmarkTxLowImpl(void) {
+    benchmarkTxLevel = false;
+}
+
+static double __benchmarkSecondsSince(const struct timespec *const start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/**
+ * Emulates the ISRs' consumption of the values the synchronization strategy provides.
+ */
+static void __benchmarkConsumeApproximatedTimings(void) {
+    ParticleAttributes.localTime.isTimePeriodInterruptDelayUpdateable = false;
+    ParticleAttributes.localTime.isNumTimePeriodsPassedUpdateable = false;
+    ParticleAttributes.localTime.isNewTimerCounterShiftUpdateable = false;
+    ParticleAttributes.communication.timerAdjustment.isTransmissionClockDelayUpdateable = false;
+}
+
+/**
+ * Sets up the particle as receiving node in idle state: timer 1 running, north reception interrupt enabled.
+ */
+static void __benchmarkSetupParticle(void) {
+    constructVirtualMcu(&DefaultVirtualMcu);
+    virtualMcuSelect(&DefaultVirtualMcu);
+    IO_PORTS_SETUP;
+    virtualMcuSyncOutputPins();
+    constructParticle(&ParticleAttributes);
+    ParticleAttributes.node.state = STATE_TYPE_IDLE;
+    // reception idle level is high
+    virtualMcuSetExternalInterruptPin(BENCHMARK_NORTH_EXTERNAL_INTERRUPT, true);
+    RX_INTERRUPTS_SETUP;
+    RX_NORTH_INTERRUPT_ENABLE;
+    TIMER_TX_RX_COUNTER_ENABLE;
+    SEI;
+}
+
+/**
+ * Encodes the package buffered at the north transmission port using the firmware's manchester coding
+ * and records the resulting edges as seen by the receiver (inverted signal).
+ * @param o the package to record to
+ */
+static void __benchmarkRecordTransmission(BenchmarkPackage *const o) {
+    DirectionOrientedPort port = ParticleAttributes.directionOrientedPorts.north;
+    port.txHighPimpl = __benchmarkTxHighImpl;
+    port.txLowPimpl = __benchmarkTxLowImpl;
+
+    TxPort *const txPort = port.txPort;
+    for (uint8_t idx = 0; idx < COMMUNICATION_TX_RX_NUMBER_BUFFER_BYTES; idx++) {
+        o->bytes[idx] = txPort->buffer.bytes[idx];
+    }
+    o->dataEndPos = txPort->dataEndPos;
+#ifdef COMMUNICATION_ENABLE_CRC8_FRAME_CHECK
+    // the receiver strips the frame check trailer
+    o->dataEndPos.byteNumber -= sizeof(FrameCheckType);
+#endif
+    bufferBitPointerStart(&txPort->buffer.pointer);
+    txPort->isTxClockPhase = true;
+    txPort->isTransmitting = true;
+    txPort->isDataBuffered = true;
+
+    const uint16_t halfClock = ParticleAttributes.communication.timerAdjustment.transmissionClockDelayHalf;
+    uint16_t halfClocksPassed = BENCHMARK_INTER_PACKAGE_CLOCKS * 2;
+    uint8_t lastTxLevel = benchmarkTxLevel = false;
+    o->numEdges = 0;
+    while (txPort->isTransmitting && o->numEdges < BENCHMARK_MAX_EDGES) {
+        transmit(&port);
+        if (benchmarkTxLevel != lastTxLevel) {
+            o->edges[o->numEdges].delay = halfClocksPassed * halfClock;
+            o->edges[o->numEdges].isRisingEdge = !benchmarkTxLevel;
+            o->numEdges++;
+            lastTxLevel = benchmarkTxLevel;
+            halfClocksPassed = 0;
+        }
+        halfClocksPassed++;
+    }
+    txPort->isTransmitting = false;
+    txPort->isDataBuffered = false;
+}
+
+/**
+ * Verifies the received package against the transmitted one before passing it to the interpreter.
+ * @param port the port the package was received at
+ */
+static void __benchmarkInterpretRxBuffer(DirectionOrientedPort *const port) {
+    benchmarkNumInterpretedPackages++;
+    const PortBuffer *const buffer = &port->rxPort->buffer;
+    bool isValid = buffer->pointer.byteNumber == benchmarkPackage.dataEndPos.byteNumber &&
+                   buffer->pointer.bitMask == benchmarkPackage.dataEndPos.bitMask;
+    for (uint8_t idx = 0; isValid && idx < buffer->pointer.byteNumber; idx++) {
+        isValid = buffer->bytes[idx] == benchmarkPackage.bytes[idx];
+    }
+    if (isValid) {
+        benchmarkNumValidPackages++;
+    }
+    interpretRxBuffer(port);
+    // the interpreter switches to re-synchronize the neighbours afterwards: stay receiving
+    ParticleAttributes.node.state = STATE_TYPE_IDLE;
+    __benchmarkConsumeApproximatedTimings();
+}
+
+/**
+ * Feeds the recorded package edges through the north reception ISR, calling the decoder after each edge
+ * as the main loop does.
+ * @param numberPackages the number of packages to receive
+ */
+static void __benchmarkReception(const uint32_t numberPackages) {
+    __benchmarkSetupParticle();
+    constructSyncTimePackage(&ParticleAttributes.communication.ports.tx.north, false);
+    __benchmarkRecordTransmission(&benchmarkPackage);
+
+    DirectionOrientedPort *const north = &ParticleAttributes.directionOrientedPorts.north;
+    uint64_t numEdges = 0;
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t package = 0; package < numberPackages; package++) {
+        for (uint16_t idx = 0; idx < benchmarkPackage.numEdges; idx++) {
+            const BenchmarkEdge *const edge = &benchmarkPackage.edges[idx];
+            virtualMcuAdvanceCycles(edge->delay);
+            virtualMcuSetExternalInterruptPin(BENCHMARK_NORTH_EXTERNAL_INTERRUPT, edge->isRisingEdge);
+            manchesterDecodeBuffer(north, __benchmarkInterpretRxBuffer);
+        }
+        numEdges += benchmarkPackage.numEdges;
+    }
+    // let the decoder time out on the last package
+    virtualMcuAdvanceCycles(BENCHMARK_INTER_PACKAGE_CLOCKS *
+                            ParticleAttributes.communication.timerAdjustment.transmissionClockDelay);
+    manchesterDecodeBuffer(north, __benchmarkInterpretRxBuffer);
+    const double seconds = __benchmarkSecondsSince(&start);
+
+    printf("reception:       %u packages, %u interpreted, %u valid, %.0f packages/s, %.0f edges/s, "
+                   "%.1f ns/edge\n",
+           numberPackages, benchmarkNumInterpretedPackages, benchmarkNumValidPackages,
+           numberPackages / seconds, numEdges / seconds, seconds * 1e9 / numEdges);
+    printf("                 clock delay %.2f, max short %u, max long %u, time period delay %u\n",
+           calculationToFloat(ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay),
+           ParticleAttributes.communication.timerAdjustment.maxShortIntervalDuration,
+           ParticleAttributes.communication.timerAdjustment.maxLongIntervalDuration,
+           ParticleAttributes.localTime.newTimePeriodInterruptDelay);
+}
+
+/**
+ * Counts the replayed frame before passing it to the interpreter.
+ * @param port the port the frame was received at
+ */
+static void __benchmarkInterpretReplayedRxBuffer(DirectionOrientedPort *const port) {
+    const BufferBitPointer *const pointer = &port->rxPort->buffer.pointer;
+    benchmarkNumReplayedFrames++;
+    benchmarkNumReplayedBits += pointer->byteNumber * 8;
+    for (uint8_t bitMask = pointer->bitMask; bitMask > 1; bitMask >>= 1) {
+        benchmarkNumReplayedBits++;
+    }
+    interpretRxBuffer(port);
+    ParticleAttributes.node.state = STATE_TYPE_IDLE;
+    port->rxPort->isDataBuffered = false;
+    __benchmarkConsumeApproximatedTimings();
+}
+
+/**
+ * Replays the edge trace through the decoder and interpreter.
+ * @param path the trace file
+ */
+static void __benchmarkReplay(const char *const path) {
+    EdgeTraceReader trace;
+    constructEdgeTraceReader(&trace, path);
+    __benchmarkSetupParticle();
+    DirectionOrientedPort *port = &ParticleAttributes.directionOrientedPorts.north;
+    if (trace.header->port == EDGE_TRACE_PORT_TYPE_EAST) {
+        port = &ParticleAttributes.directionOrientedPorts.east;
+    } else if (trace.header->port == EDGE_TRACE_PORT_TYPE_SOUTH) {
+        port = &ParticleAttributes.directionOrientedPorts.south;
+    }
+    benchmarkNumReplayedFrames = 0;
+    benchmarkNumReplayedBits = 0;
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    edgeTraceReplay(&trace, port, __benchmarkInterpretReplayedRxBuffer);
+    const double seconds = __benchmarkSecondsSince(&start);
+
+    printf("replay:          %s: %llu edges, %u frames, %llu bits, %.0f edges/s, %.1f ns/edge\n", path,
+           (unsigned long long) trace.numRecords, benchmarkNumReplayedFrames,
+           (unsigned long long) benchmarkNumReplayedBits, trace.numRecords / seconds,
+           seconds * 1e9 / trace.numRecords);
+    destructEdgeTraceReader(&trace);
+}
+
+static void __benchmarkNoOperationTask(SchedulerTask *const task) {
+    (void) task;
+}
+
+/**
+ * Measures processScheduler() with all tasks being cyclic and executed every 2nd local time period.
+ * @param numberCalls the number of scheduler calls
+ */
+static void __benchmarkScheduler(const uint32_t numberCalls) {
+    __benchmarkSetupParticle();
+    for (uint8_t taskId = 0; taskId < SCHEDULER_MAX_TASKS; taskId++) {
+        addCyclicTask(taskId, __benchmarkNoOperationTask, taskId, 2);
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t call = 0; call < numberCalls; call++) {
+        ParticleAttributes.localTime.numTimePeriodsPassed++;
+        processScheduler();
+    }
+    const double seconds = __benchmarkSecondsSince(&start);
+    printf("scheduler:       %u calls, %.0f calls/s, %.1f ns/call\n", numberCalls, numberCalls / seconds,
+           seconds * 1e9 / numberCalls);
+}
+
+/**
+ * Measures the synchronization strategy: sample insertion and timing approximation.
+ * @param numberSamples the number of samples to process
+ */
+static void __benchmarkSynchronization(const uint32_t numberSamples) {
+    __benchmarkSetupParticle();
+    const SampleValueType nominalSample =
+            (SampleValueType) (roundf(SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL *
+                                      COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY) - TIME_SYNCHRONIZATION_SAMPLE_OFFSET);
+    srand(0);
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t count = 0; count < numberSamples; count++) {
+        const SampleValueType sample = nominalSample - BENCHMARK_SAMPLE_JITTER +
+                                       (SampleValueType) (rand() % (2 * BENCHMARK_SAMPLE_JITTER + 1));
+        samplesFifoBufferAddSample(&sample, &ParticleAttributes.timeSynchronization);
+        tryApproximateTimings();
+        __benchmarkConsumeApproximatedTimings();
+    }
+    const double seconds = __benchmarkSecondsSince(&start);
+    printf("synchronization: %u samples, %.0f samples/s, %.1f ns/sample, clock delay %.2f\n", numberSamples,
+           numberSamples / seconds, seconds * 1e9 / numberSamples,
+           calculationToFloat(ParticleAttributes.communication.timerAdjustment.newTransmissionClockDelay));
+}
+
+int main(int argc, char **argv) {
+    uint32_t numberPackages = BENCHMARK_DEFAULT_NUMBER_PACKAGES;
+    if (argc > 1) {
+        numberPackages = (uint32_t) strtoul(argv[1], NULL, 10);
+    }
+
+    __benchmarkReception(numberPackages);
+    __benchmarkScheduler(numberPackages * 100);
+    __benchmarkSynchronization(numberPackages * 10);
+    for (int arg = 2; arg < argc; arg++) {
+        __benchmarkReplay(argv[arg]);
+    }
+    return (benchmarkNumValidPackages == numberPackages) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
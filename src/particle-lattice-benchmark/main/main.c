@@ -0,0 +1,141 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Scaling benchmark of the lattice simulation: simulates the same rows x columns network
+ * partitioned into 1, 2, 4, ... bands, one thread per band, and reports events per second
+ * in total and per thread.
+ * usage: ParticleLatticeBenchmark [rows] [columns] [simulated milliseconds] [max. threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <lattice/Lattice.h>
+#include <lattice/LatticeTypesCtors.h>
+
+// uc-core disables printf on MCUs without UART, the benchmark reports to the host's stdout
+#undef printf
+
+#define BENCHMARK_DEFAULT_ROWS ((uint16_t) 64)
+#define BENCHMARK_DEFAULT_COLUMNS ((uint16_t) 64)
+#define BENCHMARK_DEFAULT_MILLISECONDS ((uint32_t) 100)
+/**
+ * particles power on within [0, jitter] cycles
+ */
+#define BENCHMARK_POWER_ON_JITTER_CYCLES ((uint32_t) 1000)
+
+typedef struct BenchmarkResult {
+    double seconds;
+    uint64_t numEvents;
+    /**
+     * number of locally enumerated particles
+     */
+    uint32_t numEnumerated;
+} BenchmarkResult;
+
+/**
+ * @return the number of threads to benchmark after the given one: the next power of two or maxThreads
+ */
+static long __benchmarkNextThreads(const long threads, const long maxThreads) {
+    if (threads == maxThreads) {
+        return maxThreads + 1;
+    }
+    return (threads * 2 > maxThreads) ? maxThreads : threads * 2;
+}
+
+static double __benchmarkSecondsSince(const struct timespec *const start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+/**
+ * Simulates the network from power on to the given time.
+ * @param result the result to write to
+ */
+static void __benchmarkLattice(const uint16_t rows, const uint16_t columns, const uint32_t milliseconds,
+                               const uint16_t threads, BenchmarkResult *const result) {
+    Lattice lattice;
+    constructLattice(&lattice, rows, columns);
+    latticePartition(&lattice, threads);
+    const uint32_t numParticles = (uint32_t) rows * columns;
+    srand(0);
+    for (uint32_t idx = 0; idx < numParticles; idx++) {
+        latticePowerOn(&lattice, idx, (uint64_t) (rand() % (BENCHMARK_POWER_ON_JITTER_CYCLES + 1)));
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    latticeRun(&lattice, (uint64_t) milliseconds * (F_CPU / 1000));
+    result->seconds = __benchmarkSecondsSince(&start);
+    result->numEvents = lattice.numEvents;
+    result->numEnumerated = 0;
+    for (uint32_t idx = 0; idx < numParticles; idx++) {
+        const StateType state = lattice.particles[idx].particle.node.state;
+        if (state >= STATE_TYPE_LOCALLY_ENUMERATED && state != STATE_TYPE_ERRONEOUS) {
+            result->numEnumerated++;
+        }
+    }
+    destructLattice(&lattice);
+}
+
+/**
+ * Prints the result.
+ * @param serial the result of the single threaded simulation
+ */
+static void __benchmarkReport(const long threads, const BenchmarkResult *const result,
+                              const BenchmarkResult *const serial) {
+    const double eventsPerSecond = result->numEvents / result->seconds;
+    printf("threads: %3ld, %6.2f s, %llu events, %.0f events/s, %.0f events/s/thread, speedup %.2f, "
+                   "%u enumerated\n",
+           threads, result->seconds, (unsigned long long) result->numEvents, eventsPerSecond,
+           eventsPerSecond / threads, serial->seconds / result->seconds, result->numEnumerated);
+}
+
+int main(int argc, char **argv) {
+    uint16_t rows = BENCHMARK_DEFAULT_ROWS;
+    uint16_t columns = BENCHMARK_DEFAULT_COLUMNS;
+    uint32_t milliseconds = BENCHMARK_DEFAULT_MILLISECONDS;
+    long maxThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (argc > 1) {
+        rows = (uint16_t) strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        columns = (uint16_t) strtoul(argv[2], NULL, 10);
+    }
+    if (argc > 3) {
+        milliseconds = (uint32_t) strtoul(argv[3], NULL, 10);
+    }
+    if (argc > 4) {
+        maxThreads = (long) strtoul(argv[4], NULL, 10);
+    }
+    if (rows == 0 || columns == 0 || rows > UINT8_MAX || columns > UINT8_MAX) {
+        fprintf(stderr, "rows and columns must be in [1, %u]\n", UINT8_MAX);
+        return EXIT_FAILURE;
+    }
+    // at most one band per row
+    if (maxThreads > rows) {
+        maxThreads = rows;
+    }
+    if (maxThreads < 1) {
+        maxThreads = 1;
+    }
+
+    printf("lattice: %ux%u particles, %u ms simulated, %ld cores online\n", rows, columns, milliseconds,
+           sysconf(_SC_NPROCESSORS_ONLN));
+    BenchmarkResult serial;
+    __benchmarkLattice(rows, columns, milliseconds, 1, &serial);
+    __benchmarkReport(1, &serial, &serial);
+    bool isConsistent = true;
+    for (long threads = __benchmarkNextThreads(1, maxThreads); threads <= maxThreads;
+         threads = __benchmarkNextThreads(threads, maxThreads)) {
+        BenchmarkResult result;
+        __benchmarkLattice(rows, columns, milliseconds, (uint16_t) threads, &result);
+        __benchmarkReport(threads, &result, &serial);
+        if (result.numEnumerated != serial.numEnumerated) {
+            isConsistent = false;
+        }
+    }
+    return isConsistent ? EXIT_SUCCESS : EXIT_FAILURE;
+}
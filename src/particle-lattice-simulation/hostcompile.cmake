@@ -0,0 +1,6 @@
+# @author Raoul Rubien 2016
+
+include(${PROJECTS_SOURCE_ROOT}/avr-common/targets/cpu_clock_8000000.cmake)
+SET(DEFINED_MACROS "-DSIMULATION=true ${DEFINED_MACROS}")
+SET(COPT "-O2 -fwhole-program")
+include(${PROJECTS_SOURCE_ROOT}/avr-common/targets/compile_settings_host.cmake)
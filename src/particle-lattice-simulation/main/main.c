@@ -0,0 +1,287 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Discrete event simulation of a rows x columns particle network running the uc-core firmware.
+ * Simulates discovery, enumeration, network geometry announcement and the firmware's evaluation
+ * or test scenario (i.e. time synchronization, heat wires) as configured at compile time.
+ * usage: ParticleLatticeSimulation [rows] [columns] [simulated milliseconds] [threads] [trace row] [trace column]
+ * If a particle is given, the edges it receives are traced per connected port to
+ * edges-<row>-<column>-<port>.trace (see trace/EdgeTraceTypes.h), counted from 0.
+ * The simulation fails if not all particles are enumerated or if a package has been negatively
+ * acknowledged, which the noise-free simulation never requires.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <lattice/Lattice.h>
+#include <lattice/LatticeTypesCtors.h>
+#include <trace/EdgeTraceTypesCtors.h>
+
+// uc-core disables printf on MCUs without UART, the simulation reports to the host's stdout
+#undef printf
+
+#define SIMULATION_DEFAULT_ROWS ((uint16_t) 32)
+#define SIMULATION_DEFAULT_COLUMNS ((uint16_t) 32)
+#define SIMULATION_DEFAULT_MILLISECONDS ((uint32_t) 1000)
+#define SIMULATION_DEFAULT_THREADS ((uint16_t) 1)
+/**
+ * simulated time between two network inspections
+ */
+#define SIMULATION_INSPECTION_INTERVAL_CYCLES ((uint64_t) F_CPU / 1000)
+/**
+ * particles power on within [0, jitter] cycles
+ */
+#define SIMULATION_POWER_ON_JITTER_CYCLES ((uint32_t) 1000)
+
+static const char *const simulationPortNames[LATTICE_PORT_TYPE_NUMBER_PORTS] = {"north", "east", "south"};
+
+/**
+ * @return the node type the firmware's discovery is expected to classify the particle as
+ */
+static NodeType __simulationExpectedNodeType(const LatticeParticle *const particle) {
+    const bool isNorthConnected = particle->neighbours[LATTICE_PORT_TYPE_NORTH] != LATTICE_NO_NEIGHBOUR;
+    const bool isEastConnected = particle->neighbours[LATTICE_PORT_TYPE_EAST] != LATTICE_NO_NEIGHBOUR;
+    const bool isSouthConnected = particle->neighbours[LATTICE_PORT_TYPE_SOUTH] != LATTICE_NO_NEIGHBOUR;
+    if (!isNorthConnected) {
+        return (isEastConnected || isSouthConnected) ? NODE_TYPE_ORIGIN : NODE_TYPE_ORPHAN;
+    }
+    if (isEastConnected) {
+        return NODE_TYPE_INTER_HEAD;
+    }
+    return isSouthConnected ? NODE_TYPE_INTER_NODE : NODE_TYPE_TAIL;
+}
+
+/**
+ * @return the number of particles classified and addressed as expected
+ */
+static uint32_t __simulationCountEnumerated(Lattice *const lattice) {
+    uint32_t numEnumerated = 0;
+    for (uint16_t row = 0; row < lattice->rows; row++) {
+        for (uint16_t column = 0; column < lattice->columns; column++) {
+            const LatticeParticle *const particle =
+                    &lattice->particles[latticeParticleIndex(lattice, row, column)];
+            const Node *const node = &particle->particle.node;
+            if (node->type == __simulationExpectedNodeType(particle) &&
+                node->address.row == row + 1 && node->address.column == column + 1 &&
+                node->state >= STATE_TYPE_ANNOUNCE_NETWORK_GEOMETRY &&
+                node->state != STATE_TYPE_ERRONEOUS) {
+                numEnumerated++;
+            }
+        }
+    }
+    return numEnumerated;
+}
+
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+
+/**
+ * Prints the fragmented transfers received. The test transfer's payload byte at index i equals i.
+ */
+static void __simulationReportFragmentedTransfers(const Lattice *const lattice) {
+    const uint32_t numParticles = (uint32_t) lattice->rows * lattice->columns;
+    uint32_t numReceived = 0, numBytes = 0, numCorrupted = 0, numAborted = 0;
+
+    for (uint32_t idx = 0; idx < numParticles; idx++) {
+        const FragmentReassembly *const reassembly = &lattice->particles[idx].particle.protocol.fragmentReassembly;
+        numAborted += reassembly->numberAbortedTransfers;
+        if (!reassembly->isComplete) {
+            continue;
+        }
+        numReceived++;
+        numBytes += reassembly->numberBytes;
+        for (uint8_t byte = 0; byte < reassembly->numberBytes; byte++) {
+            if (reassembly->bytes[byte] != byte) {
+                numCorrupted++;
+                break;
+            }
+        }
+    }
+    printf("transfer:    %u particles received %u bytes, %u corrupted, %u aborted\n", numReceived, numBytes,
+           numCorrupted, numAborted);
+}
+
+#endif
+
+/**
+ * Prints the network state summary.
+ * @return false if a particle negatively acknowledged a package, true otherwise: the simulation
+ * injects no bit errors, thus each hop retransmission request is a protocol fault
+ */
+static bool __simulationReport(Lattice *const lattice) {
+    const uint32_t numParticles = (uint32_t) lattice->rows * lattice->columns;
+    uint32_t numIdle = 0, numErroneous = 0, numActuationsScheduled = 0, numParticlesActuated = 0, numActuations = 0;
+    uint32_t numFrameCheckErrors = 0;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    uint32_t numRetransmissions = 0, numNacks = 0;
+#endif
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    uint32_t numCorrectedErrors = 0;
+#endif
+    uint16_t minTimePeriods = UINT16_MAX, maxTimePeriods = 0;
+
+    for (uint32_t idx = 0; idx < numParticles; idx++) {
+        const Particle *const particle = &lattice->particles[idx].particle;
+        if (particle->node.state == STATE_TYPE_IDLE) {
+            numIdle++;
+        } else if (particle->node.state == STATE_TYPE_ERRONEOUS) {
+            numErroneous++;
+        }
+        if (particle->actuationCommand.isScheduled) {
+            numActuationsScheduled++;
+        }
+        if (lattice->particles[idx].numActuations > 0) {
+            numParticlesActuated++;
+            numActuations += lattice->particles[idx].numActuations;
+        }
+        numFrameCheckErrors += particle->communication.ports.rx.north.numberFrameCheckErrors +
+                               particle->communication.ports.rx.east.numberFrameCheckErrors +
+                               particle->communication.ports.rx.south.numberFrameCheckErrors;
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+        numRetransmissions += particle->protocol.ports.north.hopRetransmission.numberRetransmissions +
+                              particle->protocol.ports.east.hopRetransmission.numberRetransmissions +
+                              particle->protocol.ports.south.hopRetransmission.numberRetransmissions;
+        numNacks += particle->protocol.ports.north.hopRetransmission.numberNacks +
+                    particle->protocol.ports.east.hopRetransmission.numberNacks +
+                    particle->protocol.ports.south.hopRetransmission.numberNacks;
+#endif
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+        numCorrectedErrors += particle->communication.ports.rx.north.numberCorrectedErrors +
+                              particle->communication.ports.rx.east.numberCorrectedErrors +
+                              particle->communication.ports.rx.south.numberCorrectedErrors;
+#endif
+        if (particle->localTime.numTimePeriodsPassed < minTimePeriods) {
+            minTimePeriods = particle->localTime.numTimePeriodsPassed;
+        }
+        if (particle->localTime.numTimePeriodsPassed > maxTimePeriods) {
+            maxTimePeriods = particle->localTime.numTimePeriodsPassed;
+        }
+    }
+
+    const Particle *const origin = &lattice->particles[0].particle;
+    printf("network:     %u idle, %u erroneous, geometry announced to origin %ux%u\n", numIdle, numErroneous,
+           origin->protocol.networkGeometry.rows, origin->protocol.networkGeometry.columns);
+    printf("frame check: %u packages discarded\n", numFrameCheckErrors);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    printf("hop retx:    %u packages retransmitted, %u NACKs sent\n", numRetransmissions, numNacks);
+#endif
+#ifdef COMMUNICATION_ENABLE_ERROR_CORRECTION
+    printf("correction:  %u packages corrected\n", numCorrectedErrors);
+#endif
+    printf("local time:  %u..%u time periods passed\n", minTimePeriods, maxTimePeriods);
+    printf("actuation:   %u particles executed %u commands, %u commands scheduled\n", numParticlesActuated,
+           numActuations, numActuationsScheduled);
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_FRAGMENTATION
+    __simulationReportFragmentedTransfers(lattice);
+#endif
+#ifdef COMMUNICATION_PROTOCOL_ENABLE_HOP_RETRANSMISSION
+    return numNacks == 0;
+#else
+    return true;
+#endif
+}
+
+/**
+ * Starts tracing the connected reception ports of the particle.
+ * @param traces the traces to construct, one per port
+ */
+static void __simulationTraceEdges(Lattice *const lattice, const uint16_t row, const uint16_t column,
+                                   EdgeTraceWriter traces[LATTICE_PORT_TYPE_NUMBER_PORTS]) {
+    const uint32_t particleIndex = latticeParticleIndex(lattice, row, column);
+    char path[64];
+    for (uint8_t port = 0; port < LATTICE_PORT_TYPE_NUMBER_PORTS; port++) {
+        if (lattice->particles[particleIndex].neighbours[port] == LATTICE_NO_NEIGHBOUR) {
+            continue;
+        }
+        snprintf(path, sizeof(path), "edges-%u-%u-%s.trace", row, column, simulationPortNames[port]);
+        constructEdgeTraceWriter(&traces[port], path, port, COMMUNICATION_DEFAULT_TX_RX_CLOCK_DELAY);
+        latticeTraceEdges(lattice, particleIndex, port, &traces[port]);
+        printf("trace:       edges received at %s port to %s\n", simulationPortNames[port], path);
+    }
+}
+
+static double __simulationSecondsSince(const struct timespec *const start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+int main(int argc, char **argv) {
+    uint16_t rows = SIMULATION_DEFAULT_ROWS;
+    uint16_t columns = SIMULATION_DEFAULT_COLUMNS;
+    uint32_t milliseconds = SIMULATION_DEFAULT_MILLISECONDS;
+    uint16_t threads = SIMULATION_DEFAULT_THREADS;
+    if (argc > 1) {
+        rows = (uint16_t) strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        columns = (uint16_t) strtoul(argv[2], NULL, 10);
+    }
+    if (argc > 3) {
+        milliseconds = (uint32_t) strtoul(argv[3], NULL, 10);
+    }
+    if (argc > 4) {
+        threads = (uint16_t) strtoul(argv[4], NULL, 10);
+    }
+    const bool isTracing = argc > 6;
+    uint16_t traceRow = 0, traceColumn = 0;
+    if (isTracing) {
+        traceRow = (uint16_t) strtoul(argv[5], NULL, 10);
+        traceColumn = (uint16_t) strtoul(argv[6], NULL, 10);
+    }
+    if (rows == 0 || columns == 0 || rows > UINT8_MAX || columns > UINT8_MAX) {
+        fprintf(stderr, "rows and columns must be in [1, %u]\n", UINT8_MAX);
+        return EXIT_FAILURE;
+    }
+    if (isTracing && (traceRow >= rows || traceColumn >= columns)) {
+        fprintf(stderr, "trace particle must be in the lattice\n");
+        return EXIT_FAILURE;
+    }
+
+    Lattice lattice;
+    constructLattice(&lattice, rows, columns);
+    latticePartition(&lattice, threads);
+    EdgeTraceWriter traces[LATTICE_PORT_TYPE_NUMBER_PORTS] = {{NULL, 0}, {NULL, 0}, {NULL, 0}};
+    if (isTracing) {
+        __simulationTraceEdges(&lattice, traceRow, traceColumn, traces);
+    }
+    const uint32_t numParticles = (uint32_t) rows * columns;
+    srand(0);
+    for (uint32_t idx = 0; idx < numParticles; idx++) {
+        latticePowerOn(&lattice, idx, (uint64_t) (rand() % (SIMULATION_POWER_ON_JITTER_CYCLES + 1)));
+    }
+
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    const uint64_t endTime = (uint64_t) milliseconds * (F_CPU / 1000);
+    uint64_t enumeratedTime = 0;
+    while (lattice.time < endTime) {
+        latticeRun(&lattice, lattice.time + SIMULATION_INSPECTION_INTERVAL_CYCLES);
+        if (enumeratedTime == 0 && __simulationCountEnumerated(&lattice) == numParticles) {
+            enumeratedTime = lattice.time;
+        }
+    }
+    const double seconds = __simulationSecondsSince(&start);
+
+    const uint32_t numEnumerated = __simulationCountEnumerated(&lattice);
+    printf("lattice:     %ux%u particles, %u threads, %.1f ms simulated in %.2f s, %llu events, %.0f events/s\n",
+           rows, columns, lattice.numBands, lattice.time * 1000.0 / F_CPU, seconds,
+           (unsigned long long) lattice.numEvents, lattice.numEvents / seconds);
+    if (enumeratedTime != 0) {
+        printf("enumeration: %u of %u particles enumerated after %.1f ms\n", numEnumerated, numParticles,
+               enumeratedTime * 1000.0 / F_CPU);
+    } else {
+        printf("enumeration: %u of %u particles enumerated\n", numEnumerated, numParticles);
+    }
+    const bool isReportClean = __simulationReport(&lattice);
+
+    for (uint8_t port = 0; port < LATTICE_PORT_TYPE_NUMBER_PORTS; port++) {
+        if (traces[port].file != NULL) {
+            printf("trace:       %llu edges received at %s port\n", (unsigned long long) traces[port].numRecords,
+                   simulationPortNames[port]);
+        }
+        destructEdgeTraceWriter(&traces[port]);
+    }
+    destructLattice(&lattice);
+    return (enumeratedTime != 0 && isReportClean) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
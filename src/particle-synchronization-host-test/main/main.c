@@ -0,0 +1,213 @@
+/**
+ * @author Raoul Rubien 2016
+ *
+ * Host test of the synchronization arithmetic. Deterministic sample sequences of several clock
+ * delays, jitter amplitudes and outlier rates are fed to the selected synchronization strategy.
+ * The approximated timings after each sample are written to the timings file. If a reference
+ * timings file is given, i.e. of the floating point build, the timings are compared to it and the
+ * test fails if any timing deviates by more than SYNCHRONIZATION_TEST_MAX_DEVIATION timer ticks.
+ * With SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE the local time tracking phase is disciplined in a
+ * closed loop too: the phase offset drifts by the scenario's phase drift per sample and is shifted
+ * back by the approximated shift.
+ * usage: ParticleSynchronizationHostTest_<STRATEGY>[_FLOAT] <timings file> [reference timings file]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <uc-core/particle/ParticleLoop.h>
+#include <mcu/VirtualMcu.h>
+#include <mcu/VirtualMcuTypesCtors.h>
+
+// uc-core disables printf on MCUs without UART, the test reports to the host's stdout
+#undef printf
+
+#define SYNCHRONIZATION_TEST_NUMBER_SAMPLES ((uint16_t) 500)
+#define SYNCHRONIZATION_TEST_NUMBER_TIMINGS ((uint8_t) 6)
+#define SYNCHRONIZATION_TEST_MAX_DEVIATION ((int32_t) 1)
+/**
+ * outliers are displaced by this number of timer ticks
+ */
+#define SYNCHRONIZATION_TEST_OUTLIER_DISPLACEMENT ((int32_t) 700)
+
+typedef struct SynchronizationTestScenario {
+    /**
+     * the transmitter's manchester clock delay in timer ticks
+     */
+    uint16_t clockDelay;
+    /**
+     * samples are within [nominal - jitter, nominal + jitter]
+     */
+    uint16_t jitter;
+    /**
+     * every n-th sample is an outlier, 0 disables outlier
+     */
+    uint16_t outlierSeparation;
+    /**
+     * the local time tracking phase offset drifts by this number of timer ticks per sample
+     */
+    int16_t phaseDrift;
+} SynchronizationTestScenario;
+
+static const SynchronizationTestScenario synchronizationTestScenarios[] = {
+        {1024, 0,   0,  0},
+        {1024, 16,  0,  3},
+        {1024, 64,  0,  -7},
+        {1000, 16,  0,  40},
+        {1050, 16,  0,  -40},
+        {980,  128, 0,  11},
+        {1024, 16,  7,  0},
+        {1010, 48,  13, -5},
+};
+
+/**
+ * the initial local time tracking phase offset in timer ticks
+ */
+#define SYNCHRONIZATION_TEST_INITIAL_PHASE_OFFSET ((int32_t) 3000)
+
+static uint32_t synchronizationTestRandomState;
+
+/**
+ * Deterministic pseudo random numbers, independent of the host's libc.
+ * @return a number in [0, 2^15)
+ */
+static uint16_t __synchronizationTestRandom(void) {
+    synchronizationTestRandomState = synchronizationTestRandomState * 1103515245 + 12345;
+    return (uint16_t) ((synchronizationTestRandomState >> 16) & 0x7fff);
+}
+
+/**
+ * Sets up the particle as the host benchmark does.
+ */
+static void __synchronizationTestSetupParticle(void) {
+    constructVirtualMcu(&DefaultVirtualMcu);
+    virtualMcuSelect(&DefaultVirtualMcu);
+    constructParticle(&ParticleAttributes);
+    ParticleAttributes.node.state = STATE_TYPE_IDLE;
+}
+
+/**
+ * Evaluates the sample the reception of a time package transmitted at the scenario's clock delay leads to.
+ * @param scenario the scenario
+ * @param sampleNumber the number of the sample in the sequence
+ */
+static SampleValueType __synchronizationTestSample(const SynchronizationTestScenario *const scenario,
+                                                   const uint16_t sampleNumber) {
+    int32_t duration = (int32_t) (SYNCHRONIZATION_PDU_NUMBER_CLOCKS_IN_MEASURED_INTERVAL * scenario->clockDelay + 0.5);
+    if (scenario->jitter > 0) {
+        duration += (int32_t) (__synchronizationTestRandom() % (2 * scenario->jitter + 1)) - scenario->jitter;
+    }
+    if (scenario->outlierSeparation > 0 && (sampleNumber % scenario->outlierSeparation) == 0) {
+        duration += (sampleNumber & 1) ? SYNCHRONIZATION_TEST_OUTLIER_DISPLACEMENT
+                                       : -SYNCHRONIZATION_TEST_OUTLIER_DISPLACEMENT;
+    }
+    return (SampleValueType) (duration - TIME_SYNCHRONIZATION_SAMPLE_OFFSET);
+}
+
+/**
+ * Feeds the scenario's samples to the synchronization and writes the approximated timings.
+ * @param scenario the scenario
+ * @param timings the timings file
+ */
+static void __synchronizationTestScenario(const SynchronizationTestScenario *const scenario, FILE *const timings) {
+    __synchronizationTestSetupParticle();
+    synchronizationTestRandomState = scenario->clockDelay;
+    TransmissionTimerAdjustment *const timerAdjustment = &ParticleAttributes.communication.timerAdjustment;
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+    int32_t phaseOffset = SYNCHRONIZATION_TEST_INITIAL_PHASE_OFFSET;
+#endif
+
+    for (uint16_t sampleNumber = 0; sampleNumber < SYNCHRONIZATION_TEST_NUMBER_SAMPLES; sampleNumber++) {
+        const SampleValueType sample = __synchronizationTestSample(scenario, sampleNumber);
+        samplesFifoBufferAddSample(&sample, &ParticleAttributes.timeSynchronization);
+        tryApproximateTimings();
+        // emulate the ISRs' consumption of the approximated values
+        ParticleAttributes.localTime.isTimePeriodInterruptDelayUpdateable = false;
+        timerAdjustment->isTransmissionClockDelayUpdateable = false;
+
+        int16_t shift = 0;
+#ifdef SYNCHRONIZATION_STRATEGY_CLOCK_DISCIPLINE
+        // the trim extends the local period, the shift moves the ISR
+        shift = clockDisciplineUpdatePhase(phaseOffset, &ParticleAttributes.timeSynchronization.clockDiscipline);
+        phaseOffset += scenario->phaseDrift + calculationRound(
+                ParticleAttributes.timeSynchronization.clockDiscipline.periodTrim) + shift;
+#endif
+
+        fprintf(timings, "%ld %ld %u %u %u %d\n",
+                (long) calculationRound(timerAdjustment->newTransmissionClockDelay),
+                (long) calculationRound(timerAdjustment->newTransmissionClockDelayHalf),
+                timerAdjustment->maxShortIntervalDuration,
+                timerAdjustment->maxLongIntervalDuration,
+                ParticleAttributes.localTime.newTimePeriodInterruptDelay,
+                shift);
+    }
+}
+
+/**
+ * Compares the timings to the reference timings.
+ * @return true if no timing deviates by more than SYNCHRONIZATION_TEST_MAX_DEVIATION, false otherwise
+ */
+static bool __synchronizationTestCompare(FILE *const timings, FILE *const reference) {
+    uint32_t numberTimings = 0;
+    uint32_t numberDeviations = 0;
+    long maxDeviation = 0;
+    long values[SYNCHRONIZATION_TEST_NUMBER_TIMINGS];
+    long referenceValues[SYNCHRONIZATION_TEST_NUMBER_TIMINGS];
+
+    while (fscanf(timings, "%ld %ld %ld %ld %ld %ld", &values[0], &values[1], &values[2], &values[3],
+                  &values[4], &values[5]) == SYNCHRONIZATION_TEST_NUMBER_TIMINGS) {
+        if (fscanf(reference, "%ld %ld %ld %ld %ld %ld", &referenceValues[0], &referenceValues[1],
+                   &referenceValues[2], &referenceValues[3], &referenceValues[4], &referenceValues[5]) !=
+            SYNCHRONIZATION_TEST_NUMBER_TIMINGS) {
+            printf("reference timings exhausted after %u lines\n", numberTimings);
+            return false;
+        }
+        for (uint8_t idx = 0; idx < SYNCHRONIZATION_TEST_NUMBER_TIMINGS; idx++) {
+            const long deviation = labs(values[idx] - referenceValues[idx]);
+            if (deviation > maxDeviation) {
+                maxDeviation = deviation;
+            }
+            if (deviation > SYNCHRONIZATION_TEST_MAX_DEVIATION) {
+                numberDeviations++;
+            }
+        }
+        numberTimings++;
+    }
+
+    printf("compared:        %u lines, max. deviation %ld ticks, %u timings exceed %ld ticks\n",
+           numberTimings, maxDeviation, numberDeviations, (long) SYNCHRONIZATION_TEST_MAX_DEVIATION);
+    return numberTimings > 0 && numberDeviations == 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        printf("usage: %s <timings file> [reference timings file]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE *timings = fopen(argv[1], "w+");
+    if (timings == NULL) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    const uint8_t numberScenarios = sizeof(synchronizationTestScenarios) / sizeof(SynchronizationTestScenario);
+    for (uint8_t scenario = 0; scenario < numberScenarios; scenario++) {
+        __synchronizationTestScenario(&synchronizationTestScenarios[scenario], timings);
+    }
+    printf("timings:         %u scenarios, %u samples each\n", numberScenarios,
+           SYNCHRONIZATION_TEST_NUMBER_SAMPLES);
+
+    bool isPassed = true;
+    if (argc > 2) {
+        FILE *reference = fopen(argv[2], "r");
+        if (reference == NULL) {
+            perror(argv[2]);
+            fclose(timings);
+            return EXIT_FAILURE;
+        }
+        rewind(timings);
+        isPassed = __synchronizationTestCompare(timings, reference);
+        fclose(reference);
+    }
+    fclose(timings);
+    return isPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+}